@@ -1,8 +1,18 @@
 #ifndef GAME_H_INCLUDED
 #define GAME_H_INCLUDED
 
+#include "canvas_history.h"
 #include "font_types.h"
 #include "framebuffer.h"
+#include "gui_arena.h"
+#include "inference_client.h"
+#include "input_queue.h"
+#include "overlay.h"
+#include "page_snapshot.h"
+#include "render_cache.h"
+#include "stroke_log.h"
+#include "timeline.h"
+#include "touch_ring.h"
 #include "widgets/widget.h"
 #include <stdbool.h>
 #include <stdint.h>
@@ -29,6 +39,22 @@ typedef struct
     void *callback_user_data;
     const bdf_font_t *label_font;
     const bdf_font_t *button_font;
+    bool preprocess_canvas;
+    int stroke_width;
+    uint8_t *stroke_log_buffer;
+    unsigned int stroke_log_capacity;
+    CanvasTileBlock *history_blocks;
+    unsigned int history_block_count;
+    TouchRing *touch_ring;
+    GuiArena *gui_arena;
+    RenderCache *render_cache;
+    // With both set, the page not on screen is suspended instead of hidden and comes back from its snapshot
+    PageSnapshot *menu_snapshot;
+    PageSnapshot *game_snapshot;
+    // With a backend, guesses are queued for the accelerator and game_update applies the answers; otherwise
+    // guess_callback is called right away
+    const InferenceBackend *inference_backend;
+    int inference_timeout_ms;
 } GameConfig;
 
 bool game_init(const GameConfig *config);
@@ -37,7 +63,7 @@ void game_cleanup(void);
 
 void game_start_new_round(void);
 
-void game_update(float delta_time);
+void game_update(int delta_ms);
 
 bool game_render(Framebuffer *framebuffer);
 
@@ -45,14 +71,30 @@ bool game_handle_mouse_down(unsigned int x, unsigned int y);
 bool game_handle_mouse_up(unsigned int x, unsigned int y);
 bool game_handle_mouse_move(unsigned int x, unsigned int y);
 
+bool game_queue_input(InputEventType type, unsigned int x, unsigned int y, uint32_t timestamp);
+void game_process_input(void);
+
 void game_get_canvas_28x28(uint8_t *output_buffer);
+bool game_canvas_changed(void);
+const StrokeLog *game_get_stroke_log(void);
+bool game_undo(void);
+bool game_redo(void);
 
 void game_send_guess(int guess_index);
+// True while a guess is queued or on the accelerator
+bool game_is_guess_pending(void);
 
 int game_get_state(void);
 
 bool game_is_initialized(void);
 
+// Tweens on game widgets, advanced by game_update
+Timeline *game_get_timeline(void);
+
+// Sprites drawn over the widgets by game_render
+OverlayLayer *game_get_overlays(void);
+const Overlay *game_get_brush_cursor(void);
+
 void game_set_random_seed(unsigned int seed);
 
 void game_on_guess(Widget *widget, void *user_data);
@@ -11,6 +11,9 @@ void game_page_reset_round(void);
 void game_page_start_new_round(void);
 int game_page_send_guess(int guess_index);
 void game_page_get_canvas_28x28(uint8_t *output_buffer);
+void game_page_get_canvas_preprocessed(uint8_t *output_buffer);
+unsigned int game_page_get_canvas_version(void);
 Widget *game_page_get_canvas(void);
+const StrokeLog *game_page_get_stroke_log(void);
 
 #endif
@@ -0,0 +1,72 @@
+#ifndef INFERENCE_CLIENT_H_INCLUDED
+#define INFERENCE_CLIENT_H_INCLUDED
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define INFERENCE_QUEUE_CAPACITY 4
+#define INFERENCE_INPUT_SIZE (28 * 28)
+
+// The accelerator side of the link. None of the calls may block: submit hands a request to the device or refuses
+// it while the device is busy, and must copy the input it needs; poll reports at most one finished request per
+// call. A cancelled request may still be reported later.
+typedef struct
+{
+    bool (*submit)(void *context, uint32_t sequence, const uint8_t *input);
+    bool (*poll)(void *context, uint32_t *sequence, int *guess_index);
+    void (*cancel)(void *context, uint32_t sequence);
+    void *context;
+} InferenceBackend;
+
+typedef struct
+{
+    uint32_t sequence;
+    unsigned int canvas_version;
+    int age_ms;
+    bool in_flight;
+    uint8_t input[INFERENCE_INPUT_SIZE];
+} InferenceRequest;
+
+typedef struct
+{
+    uint32_t sequence;
+    unsigned int canvas_version;
+    // Set when the request was given up rather than answered; guess_index is then -1
+    bool timed_out;
+    int guess_index;
+} InferenceResult;
+
+// Requests waiting for or running on the accelerator, oldest first, each tagged with a sequence number that is
+// never 0 and does not repeat until it wraps. Only the oldest request is on the device at a time. A result is
+// handed out only when its sequence matches the request in flight; anything else answers a request that was
+// cancelled or timed out, and is dropped and counted in stale.
+typedef struct
+{
+    const InferenceBackend *backend;
+    InferenceRequest requests[INFERENCE_QUEUE_CAPACITY];
+    unsigned int count;
+    uint32_t next_sequence;
+    // Time from submission after which a request is given up; 0 waits forever
+    int timeout_ms;
+    unsigned int completed;
+    unsigned int cancelled;
+    unsigned int timed_out;
+    unsigned int stale;
+} InferenceClient;
+
+void inference_client_init(InferenceClient *client, const InferenceBackend *backend, int timeout_ms);
+
+// Queues a copy of the input and returns its sequence, or 0 when the queue is full
+uint32_t inference_client_submit(InferenceClient *client, const uint8_t *input, unsigned int canvas_version);
+// Drops every request made from a canvas other than the given version
+void inference_client_cancel_stale(InferenceClient *client, unsigned int canvas_version);
+void inference_client_cancel_all(InferenceClient *client);
+
+// Ages the requests by delta_ms, gives up on those past the timeout, starts the oldest one if the device is free
+// and collects what the device finished. Returns true and fills result when a request completed or timed out.
+// A timeout is reported on its own, for the newest request given up, and the next request starts on the
+// following update.
+bool inference_client_update(InferenceClient *client, int delta_ms, InferenceResult *result);
+bool inference_client_is_pending(const InferenceClient *client);
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef INFERENCE_SIM_H_INCLUDED
+#define INFERENCE_SIM_H_INCLUDED
+
+#include "inference_client.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef int (*inference_sim_classify_t)(const uint8_t *input, void *user_data);
+
+// Stands in for the accelerator: one request at a time, answered latency_ms after it was taken. The guess is
+// worked out on submit by the classify callback, or taken from the sequence number without one. The device runs
+// on its own clock, which the owner advances alongside the game.
+typedef struct
+{
+    int latency_ms;
+    inference_sim_classify_t classify;
+    void *user_data;
+    unsigned int num_classes;
+
+    bool busy;
+    uint32_t sequence;
+    int guess_index;
+    int elapsed_ms;
+    unsigned int submitted;
+    unsigned int cancelled;
+} InferenceSim;
+
+void inference_sim_init(InferenceSim *sim, int latency_ms, unsigned int num_classes, inference_sim_classify_t classify,
+                        void *user_data);
+void inference_sim_advance(InferenceSim *sim, int delta_ms);
+InferenceBackend inference_sim_backend(InferenceSim *sim);
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef INPUT_QUEUE_H_INCLUDED
+#define INPUT_QUEUE_H_INCLUDED
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define INPUT_QUEUE_CAPACITY 64
+
+typedef enum
+{
+    INPUT_EVENT_POINTER_DOWN,
+    INPUT_EVENT_POINTER_MOVE,
+    INPUT_EVENT_POINTER_UP,
+} InputEventType;
+
+typedef struct
+{
+    InputEventType type;
+    uint32_t timestamp;
+    int16_t x;
+    int16_t y;
+} InputEvent;
+
+// Ring buffer of pointer events filled by the platform layer and drained once per frame.
+// A run of moves is a polyline: a move that repeats the last point, or continues it in a straight line, replaces
+// it instead of taking a new slot, which loses no geometry. Two slots are kept free for press and release; once
+// moves would use them, the newest move replaces the last queued one and the corner there is lost. Those moves
+// are counted in replaced; draining the queue when input_queue_is_full says so avoids them.
+typedef struct
+{
+    InputEvent events[INPUT_QUEUE_CAPACITY];
+    unsigned int head;
+    unsigned int count;
+    unsigned int coalesced;
+    unsigned int replaced;
+    unsigned int dropped;
+} InputQueue;
+
+void input_queue_init(InputQueue *queue);
+bool input_queue_push(InputQueue *queue, InputEventType type, int x, int y, uint32_t timestamp);
+bool input_queue_pop(InputQueue *queue, InputEvent *event);
+// True once a move would no longer get a slot of its own
+bool input_queue_is_full(const InputQueue *queue);
+
+#endif
@@ -6,6 +6,6 @@
 
 Widget *menu_page_init(const GameConfig *config);
 void menu_page_cleanup(void);
-void menu_page_update(float delta_time);
+void menu_page_update(int delta_ms);
 
 #endif
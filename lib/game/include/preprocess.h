@@ -0,0 +1,32 @@
+#ifndef PREPROCESS_H_INCLUDED
+#define PREPROCESS_H_INCLUDED
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define PREPROCESS_OUTPUT_SIZE 28
+#define PREPROCESS_FIT_SIZE 20
+
+typedef struct
+{
+    int x;
+    int y;
+    int width;
+    int height;
+} PreprocessBounds;
+
+typedef struct
+{
+    // Target stroke width in output pixels; 0 leaves the strokes as drawn.
+    int stroke_width;
+} PreprocessOptions;
+
+bool preprocess_find_ink_bounds(const uint8_t *pixels, int width, int height, int stride, PreprocessBounds *bounds);
+
+// Crops the drawing to bounds, scales its long side to PREPROCESS_FIT_SIZE, centers it by center of mass in a
+// PREPROCESS_OUTPUT_SIZE square and optionally normalizes the stroke width. Integer arithmetic only.
+// Returns false and writes an empty image if there is no ink.
+bool preprocess_drawing(const uint8_t *pixels, int stride, const PreprocessBounds *bounds,
+                        const PreprocessOptions *options, uint8_t *output);
+
+#endif
@@ -0,0 +1,17 @@
+#ifndef RESAMPLE_H_INCLUDED
+#define RESAMPLE_H_INCLUDED
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define RESAMPLE_MAX_SOURCE_WIDTH 512
+#define RESAMPLE_MAX_OUTPUT_SIZE 128
+
+// Area-weighted resampling of an 8-bit image to any size. Each output pixel is the exact
+// coverage-weighted mean of the source pixels under it, computed in integer arithmetic.
+// The source may be a sub-rectangle of a larger buffer, given by src_stride.
+// Returns false if the arguments are invalid or src_width * src_height exceeds 2^24.
+bool resample_area(const uint8_t *src, int src_width, int src_height, int src_stride, uint8_t *dst, int dst_width,
+                   int dst_height);
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef TOUCH_RING_H_INCLUDED
+#define TOUCH_RING_H_INCLUDED
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifndef TOUCH_RING_SIZE
+#define TOUCH_RING_SIZE 64
+#endif
+
+_Static_assert((TOUCH_RING_SIZE & (TOUCH_RING_SIZE - 1)) == 0, "TOUCH_RING_SIZE must be a power of two");
+
+typedef struct
+{
+    uint32_t timestamp;
+    int16_t x;
+    int16_t y;
+    bool pressed;
+} TouchSample;
+
+// Single-producer/single-consumer ring for touch samples. The producer, typically the touch controller
+// interrupt, only writes head; the consumer, the main loop, only writes tail. Neither side blocks or takes
+// a lock, so pushing is safe from an ISR. The indices run freely and are masked on access.
+// A sample pushed while the ring is full is discarded and counted in overflow.
+typedef struct
+{
+    TouchSample samples[TOUCH_RING_SIZE];
+    atomic_uint head;
+    atomic_uint tail;
+    atomic_uint overflow;
+} TouchRing;
+
+void touch_ring_init(TouchRing *ring);
+
+bool touch_ring_push(TouchRing *ring, const TouchSample *sample);
+bool touch_ring_pop(TouchRing *ring, TouchSample *sample);
+
+unsigned int touch_ring_count(TouchRing *ring);
+unsigned int touch_ring_overflow_count(TouchRing *ring);
+
+#endif
@@ -3,6 +3,7 @@
 #include "framebuffer.h"
 #include "game_page.h"
 #include "menu_page.h"
+#include "primitives/rectangle.h"
 #include "widgets/canvas.h"
 #include "widgets/container.h"
 #include "widgets/widget.h"
@@ -11,6 +12,24 @@
 #include <string.h>
 
 #define BACKGROUND_COLOR COLOR_RGB(255, 209, 57)
+#define BRUSH_CURSOR_COLOR COLOR_GRAY_50
+#define BRUSH_CURSOR_MAX_SIZE 16
+#define THINKING_BADGE_COLOR COLOR_GRAY_50
+#define THINKING_BADGE_DOT 4
+#define THINKING_BADGE_WIDTH (THINKING_BADGE_DOT * 4)
+#define THINKING_BADGE_MARGIN 4
+#define INFERENCE_MAX_RESENDS 2
+
+static void init_brush_cursor(void);
+static void update_brush_cursor(unsigned int x, unsigned int y);
+static void draw_brush_cursor(const Overlay *overlay, Framebuffer *framebuffer);
+static void update_thinking_badge(void);
+static void draw_thinking_badge(const Overlay *overlay, Framebuffer *framebuffer);
+static void update_inference(int delta_ms);
+static bool push_input(InputEventType type, int x, int y, uint32_t timestamp);
+static void drain_input(void);
+static void show_page(Widget *page);
+static void switch_page(Framebuffer *framebuffer);
 
 static struct
 {
@@ -22,11 +41,32 @@ static struct
     GameState state;
     bool is_drawing;
     bool initialized;
+    bool preprocess_canvas;
+    unsigned int sent_canvas_version;
+    // A request for the current drawing timed out; resends counts how often it has been asked for again
+    bool needs_resend;
+    unsigned int resends;
+    InputQueue input_queue;
+    TouchRing *touch_ring;
+    bool touch_pressed;
 
     Widget *root_container;
     Widget *menu_container;
     Widget *game_container;
+    Widget *current_page;
+    Widget *next_page;
+    PageSnapshot *menu_snapshot;
+    PageSnapshot *game_snapshot;
     Widget *canvas;
+    GuiArena *gui_arena;
+    RenderCache *render_cache;
+    Timeline timeline;
+    OverlayLayer overlays;
+    Overlay brush_cursor;
+    Color brush_cursor_under[BRUSH_CURSOR_MAX_SIZE * BRUSH_CURSOR_MAX_SIZE];
+    Overlay thinking_badge;
+    Color thinking_badge_under[THINKING_BADGE_WIDTH * THINKING_BADGE_DOT];
+    InferenceClient inference;
 } g_game = {0};
 
 bool game_init(const GameConfig *config)
@@ -47,6 +87,35 @@ bool game_init(const GameConfig *config)
     g_game.callback_user_data = config->callback_user_data;
     g_game.state = GAME_STATE_MENU;
     g_game.is_drawing = false;
+    g_game.preprocess_canvas = config->preprocess_canvas;
+    g_game.sent_canvas_version = 0;
+    g_game.needs_resend = false;
+    g_game.resends = 0;
+    input_queue_init(&g_game.input_queue);
+    timeline_init(&g_game.timeline);
+    g_game.touch_ring = config->touch_ring;
+    g_game.touch_pressed = false;
+    inference_client_init(&g_game.inference, config->inference_backend, config->inference_timeout_ms);
+
+    // The whole widget tree comes from the arena, so cleanup can drop it in one reset
+    g_game.gui_arena = config->gui_arena;
+    if (g_game.gui_arena)
+    {
+        gui_arena_reset(g_game.gui_arena);
+        gui_set_arena(g_game.gui_arena);
+    }
+
+    g_game.render_cache = config->render_cache;
+    if (g_game.render_cache)
+    {
+        render_cache_reset(g_game.render_cache);
+        render_cache_set_active(g_game.render_cache);
+    }
+
+    g_game.menu_snapshot = config->game_snapshot ? config->menu_snapshot : NULL;
+    g_game.game_snapshot = config->menu_snapshot ? config->game_snapshot : NULL;
+    page_snapshot_invalidate(g_game.menu_snapshot);
+    page_snapshot_invalidate(g_game.game_snapshot);
 
     g_game.root_container = container_create(0, 0, config->window_width, config->window_height, LAYOUT_TYPE_NONE);
     if (!g_game.root_container)
@@ -61,6 +130,7 @@ bool game_init(const GameConfig *config)
         return false;
     }
     container_add_child(g_game.root_container, g_game.menu_container);
+    g_game.current_page = g_game.menu_container;
 
     g_game.game_container = game_page_init(config);
     if (!g_game.game_container)
@@ -68,9 +138,19 @@ bool game_init(const GameConfig *config)
         game_cleanup();
         return false;
     }
-    container_add_child(g_game.root_container, g_game.game_container);
+
+    // A suspended page is kept out of the tree rather than hidden in it
+    if (g_game.menu_snapshot)
+        widget_set_visible(g_game.game_container, true);
+    else
+        container_add_child(g_game.root_container, g_game.game_container);
 
     g_game.canvas = game_page_get_canvas();
+    overlay_layer_init(&g_game.overlays);
+    overlay_init(&g_game.thinking_badge, g_game.thinking_badge_under, THINKING_BADGE_WIDTH, THINKING_BADGE_DOT,
+                 draw_thinking_badge, NULL);
+    overlay_layer_add(&g_game.overlays, &g_game.thinking_badge);
+    init_brush_cursor();
 
     g_game.initialized = true;
 
@@ -82,11 +162,31 @@ void game_cleanup(void)
     menu_page_cleanup();
     game_page_cleanup();
 
-    if (g_game.root_container)
+    if (g_game.gui_arena)
     {
+        gui_arena_reset(g_game.gui_arena);
+        if (gui_get_arena() == g_game.gui_arena)
+            gui_set_arena(NULL);
+    }
+    else if (g_game.root_container)
+    {
+        // The suspended page goes back into the tree so it is destroyed along with the rest
+        Widget *pages[] = {g_game.menu_container, g_game.game_container};
+        for (int i = 0; i < 2; i++)
+        {
+            if (pages[i] && !pages[i]->parent)
+                container_add_child(g_game.root_container, pages[i]);
+        }
         widget_destroy(g_game.root_container);
-        free(g_game.root_container);
-        g_game.root_container = NULL;
+        gui_free(g_game.root_container);
+    }
+    g_game.root_container = NULL;
+
+    if (g_game.render_cache)
+    {
+        render_cache_reset(g_game.render_cache);
+        if (render_cache_get_active() == g_game.render_cache)
+            render_cache_set_active(NULL);
     }
 
     memset(&g_game, 0, sizeof(g_game));
@@ -98,17 +198,22 @@ void game_start_new_round(void)
         return;
 
     g_game.state = GAME_STATE_PLAYING;
+    inference_client_cancel_all(&g_game.inference);
     game_page_start_new_round();
 }
 
-void game_update(float delta_time)
+void game_update(int delta_ms)
 {
     if (!g_game.initialized)
         return;
 
+    game_process_input();
+    timeline_update(&g_game.timeline, delta_ms);
+    update_inference(delta_ms);
+
     if (g_game.state == GAME_STATE_MENU)
     {
-        menu_page_update(delta_time);
+        menu_page_update(delta_ms);
     }
 }
 
@@ -133,12 +238,30 @@ bool game_render(Framebuffer *framebuffer)
         framebuffer_clear(framebuffer, BACKGROUND_COLOR);
     first = false;
 
+    if (g_game.state != GAME_STATE_PLAYING)
+        overlay_set_visible(&g_game.brush_cursor, false);
+    update_thinking_badge();
+
+    // Overlays are lifted off only when a widget repaints or they change, so the frame beneath is always clean
+    bool switching = g_game.next_page && g_game.next_page != g_game.current_page;
+    bool overlays_changed =
+        switching || g_game.root_container->dirty || overlay_layer_needs_update(&g_game.overlays);
+    if (overlays_changed)
+        overlay_layer_restore(&g_game.overlays, framebuffer);
+
+    if (switching)
+        switch_page(framebuffer);
+    g_game.next_page = NULL;
+
     widget_handle_dirty(g_game.root_container, framebuffer);
 
     framebuffer_clear_dirty_rects(framebuffer, BACKGROUND_COLOR);
 
     widget_render(g_game.root_container, framebuffer);
 
+    if (overlays_changed)
+        overlay_layer_draw(&g_game.overlays, framebuffer);
+
     return true;
 }
 
@@ -153,10 +276,12 @@ bool game_handle_mouse_down(unsigned int x, unsigned int y)
         return true;
     }
 
+    update_brush_cursor(x, y);
+
     if (g_game.state == GAME_STATE_PLAYING && widget_contains_point(g_game.canvas, x, y))
     {
         g_game.is_drawing = true;
-        canvas_draw_at(g_game.canvas, x, y);
+        canvas_begin_stroke(g_game.canvas, x, y);
         return true;
     }
 
@@ -173,6 +298,7 @@ bool game_handle_mouse_up(unsigned int x, unsigned int y)
     if (g_game.is_drawing)
     {
         g_game.is_drawing = false;
+        canvas_end_stroke(g_game.canvas);
         return true;
     }
 
@@ -184,6 +310,8 @@ bool game_handle_mouse_move(unsigned int x, unsigned int y)
     if (!g_game.initialized)
         return false;
 
+    update_brush_cursor(x, y);
+
     if (g_game.is_drawing && g_game.state == GAME_STATE_PLAYING)
     {
         canvas_draw_at(g_game.canvas, x, y);
@@ -193,14 +321,82 @@ bool game_handle_mouse_move(unsigned int x, unsigned int y)
     return false;
 }
 
+bool game_queue_input(InputEventType type, unsigned int x, unsigned int y, uint32_t timestamp)
+{
+    if (!g_game.initialized)
+        return false;
+
+    return push_input(type, (int)x, (int)y, timestamp);
+}
+
+void game_process_input(void)
+{
+    if (!g_game.initialized)
+        return;
+
+    // Touch samples arrive from interrupt context; turn the press state changes into pointer events
+    TouchSample sample;
+    while (g_game.touch_ring && touch_ring_pop(g_game.touch_ring, &sample))
+    {
+        InputEventType type = INPUT_EVENT_POINTER_MOVE;
+        if (sample.pressed != g_game.touch_pressed)
+            type = sample.pressed ? INPUT_EVENT_POINTER_DOWN : INPUT_EVENT_POINTER_UP;
+        else if (!sample.pressed)
+            continue;
+
+        g_game.touch_pressed = sample.pressed;
+        push_input(type, sample.x, sample.y, sample.timestamp);
+    }
+
+    drain_input();
+}
+
 void game_get_canvas_28x28(uint8_t *output_buffer)
 {
     if (!g_game.initialized || !output_buffer)
         return;
 
+    if (g_game.preprocess_canvas)
+    {
+        game_page_get_canvas_preprocessed(output_buffer);
+        return;
+    }
+
     game_page_get_canvas_28x28(output_buffer);
 }
 
+const StrokeLog *game_get_stroke_log(void)
+{
+    if (!g_game.initialized)
+        return NULL;
+
+    return game_page_get_stroke_log();
+}
+
+bool game_undo(void)
+{
+    if (!g_game.initialized || g_game.state != GAME_STATE_PLAYING || g_game.is_drawing)
+        return false;
+
+    return canvas_undo(g_game.canvas);
+}
+
+bool game_redo(void)
+{
+    if (!g_game.initialized || g_game.state != GAME_STATE_PLAYING || g_game.is_drawing)
+        return false;
+
+    return canvas_redo(g_game.canvas);
+}
+
+bool game_canvas_changed(void)
+{
+    if (!g_game.initialized)
+        return false;
+
+    return g_game.needs_resend || game_page_get_canvas_version() != g_game.sent_canvas_version;
+}
+
 int game_get_state(void)
 {
     return (int)g_game.state;
@@ -211,6 +407,26 @@ bool game_is_initialized(void)
     return g_game.initialized;
 }
 
+Timeline *game_get_timeline(void)
+{
+    return &g_game.timeline;
+}
+
+OverlayLayer *game_get_overlays(void)
+{
+    return &g_game.overlays;
+}
+
+bool game_is_guess_pending(void)
+{
+    return g_game.initialized && inference_client_is_pending(&g_game.inference);
+}
+
+const Overlay *game_get_brush_cursor(void)
+{
+    return &g_game.brush_cursor;
+}
+
 void game_set_random_seed(unsigned int seed)
 {
     srand(seed);
@@ -221,10 +437,29 @@ void game_on_guess(Widget *widget, void *user_data)
     if (!g_game.initialized)
         return;
 
-    if (g_game.guess_callback)
+    if (g_game.inference.backend)
+    {
+        // Requests for an older drawing are superseded; one for this drawing is already on its way
+        unsigned int version = game_page_get_canvas_version();
+        inference_client_cancel_stale(&g_game.inference, version);
+        if (inference_client_is_pending(&g_game.inference))
+            return;
+
+        uint8_t canvas_28x28[28 * 28];
+        game_get_canvas_28x28(canvas_28x28);
+        if (inference_client_submit(&g_game.inference, canvas_28x28, version))
+        {
+            if (version != g_game.sent_canvas_version)
+                g_game.resends = 0;
+            g_game.sent_canvas_version = version;
+            g_game.needs_resend = false;
+        }
+    }
+    else if (g_game.guess_callback)
     {
         uint8_t canvas_28x28[28 * 28];
         game_get_canvas_28x28(canvas_28x28);
+        g_game.sent_canvas_version = game_page_get_canvas_version();
         g_game.guess_callback(canvas_28x28, g_game.callback_user_data);
     }
     else
@@ -240,8 +475,7 @@ void game_on_retry(Widget *widget, void *user_data)
 
 void game_on_play(Widget *widget, void *user_data)
 {
-    widget_set_visible(g_game.menu_container, false);
-    widget_set_visible(g_game.game_container, true);
+    show_page(g_game.game_container);
 
     game_page_reset_round();
     game_start_new_round();
@@ -249,9 +483,9 @@ void game_on_play(Widget *widget, void *user_data)
 
 void game_on_menu(Widget *widget, void *user_data)
 {
-    widget_set_visible(g_game.game_container, false);
-    widget_set_visible(g_game.menu_container, true);
+    show_page(g_game.menu_container);
 
+    inference_client_cancel_all(&g_game.inference);
     g_game.state = GAME_STATE_MENU;
 }
 
@@ -259,3 +493,126 @@ void game_on_skip(Widget *widget, void *user_data)
 {
     game_start_new_round();
 }
+
+// An outline one pixel outside the brush's footprint, so it shows what a stroke will cover
+static void init_brush_cursor(void)
+{
+    int size = canvas_get_brush_size(g_game.canvas) / 2 * 2 + 3;
+    if (size > BRUSH_CURSOR_MAX_SIZE)
+        size = BRUSH_CURSOR_MAX_SIZE;
+
+    overlay_init(&g_game.brush_cursor, g_game.brush_cursor_under, size, size, draw_brush_cursor, NULL);
+    overlay_layer_add(&g_game.overlays, &g_game.brush_cursor);
+}
+
+static void update_brush_cursor(unsigned int x, unsigned int y)
+{
+    bool over_canvas = g_game.state == GAME_STATE_PLAYING && widget_contains_point(g_game.canvas, x, y);
+    overlay_set_visible(&g_game.brush_cursor, over_canvas);
+    if (over_canvas)
+        overlay_move(&g_game.brush_cursor, (int)x - g_game.brush_cursor.width / 2,
+                     (int)y - g_game.brush_cursor.height / 2);
+}
+
+static void draw_brush_cursor(const Overlay *overlay, Framebuffer *framebuffer)
+{
+    renderRectangle(framebuffer->origin_x, framebuffer->origin_y, overlay->width, overlay->height, BRUSH_CURSOR_COLOR,
+                    1, framebuffer);
+}
+
+// Shown in the canvas's top-right corner while the accelerator works on a guess
+static void update_thinking_badge(void)
+{
+    int canvas_x, canvas_y;
+    widget_get_screen_position(g_game.canvas, &canvas_x, &canvas_y);
+    overlay_move(&g_game.thinking_badge, canvas_x + g_game.canvas->width - THINKING_BADGE_WIDTH - THINKING_BADGE_MARGIN,
+                 canvas_y + THINKING_BADGE_MARGIN);
+    overlay_set_visible(&g_game.thinking_badge,
+                        g_game.state == GAME_STATE_PLAYING && inference_client_is_pending(&g_game.inference));
+}
+
+static void draw_thinking_badge(const Overlay *overlay, Framebuffer *framebuffer)
+{
+    for (int x = 0; x < overlay->width; x += THINKING_BADGE_DOT * 3 / 2)
+        renderFilledRectangle(framebuffer->origin_x + x, framebuffer->origin_y, THINKING_BADGE_DOT, THINKING_BADGE_DOT,
+                              THINKING_BADGE_COLOR, framebuffer);
+}
+
+// A stroke made after a request went out makes its answer meaningless
+static void update_inference(int delta_ms)
+{
+    inference_client_cancel_stale(&g_game.inference, game_page_get_canvas_version());
+
+    InferenceResult result;
+    if (!inference_client_update(&g_game.inference, delta_ms, &result))
+        return;
+
+    if (!result.timed_out)
+    {
+        game_send_guess(result.guess_index);
+        return;
+    }
+
+    // The drawing is asked for again a few times, so a device slower than the timeout is not kept busy forever
+    if (result.canvas_version == game_page_get_canvas_version() && g_game.resends < INFERENCE_MAX_RESENDS)
+    {
+        g_game.needs_resend = true;
+        g_game.resends++;
+    }
+}
+
+static void show_page(Widget *page)
+{
+    if (!g_game.menu_snapshot)
+    {
+        widget_set_visible(page == g_game.menu_container ? g_game.game_container : g_game.menu_container, false);
+        widget_set_visible(page, true);
+        g_game.current_page = page;
+        return;
+    }
+
+    // Swapping suspended pages reads and writes pixels, so it waits for the next frame
+    g_game.next_page = page;
+}
+
+// Runs once the overlays are lifted off, so the snapshot holds nothing but the page leaving
+static void switch_page(Framebuffer *framebuffer)
+{
+    Widget *leaving = g_game.current_page;
+    Widget *entering = g_game.next_page;
+    bool to_menu = entering == g_game.menu_container;
+
+    page_suspend(leaving, to_menu ? g_game.game_snapshot : g_game.menu_snapshot, framebuffer);
+    page_resume(g_game.root_container, entering, to_menu ? g_game.menu_snapshot : g_game.game_snapshot,
+                framebuffer);
+    g_game.current_page = entering;
+}
+
+// A full queue merges moves and loses the corners between them, so what is queued is drawn first
+static bool push_input(InputEventType type, int x, int y, uint32_t timestamp)
+{
+    if (input_queue_is_full(&g_game.input_queue))
+        drain_input();
+
+    return input_queue_push(&g_game.input_queue, type, x, y, timestamp);
+}
+
+static void drain_input(void)
+{
+    InputEvent event;
+    while (input_queue_pop(&g_game.input_queue, &event))
+    {
+        switch (event.type)
+        {
+        case INPUT_EVENT_POINTER_DOWN:
+            game_handle_mouse_down(event.x, event.y);
+            break;
+        case INPUT_EVENT_POINTER_MOVE:
+            game_handle_mouse_move(event.x, event.y);
+            break;
+        case INPUT_EVENT_POINTER_UP:
+            game_handle_mouse_up(event.x, event.y);
+            break;
+        }
+    }
+}
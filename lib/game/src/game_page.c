@@ -2,6 +2,8 @@
 #include "color.h"
 #include "font_medium.h"
 #include "font_small.h"
+#include "preprocess.h"
+#include "resample.h"
 #include "widgets/button.h"
 #include "widgets/canvas.h"
 #include "widgets/container.h"
@@ -17,6 +19,8 @@
 #define SPACING_MD 4
 #define SPACING_LG 8
 #define SPACING_XL 16
+#define ROUND_TEXT_CAPACITY 24
+#define PROMPT_TEXT_CAPACITY 64
 
 #define LABEL_ROUND_COLOR COLOR_GRAY_50
 #define LABEL_TEXT_COLOR COLOR_BLACK
@@ -27,6 +31,11 @@
 #define BUTTON_RETRY_BG COLOR_RGB(46, 170, 80)
 #define BUTTON_RETRY_TEXT COLOR_WHITE
 #define BUTTON_RETRY_BORDER COLOR_RGB(35, 118, 54)
+#define RESULT_CORRECT_COLOR COLOR_RGB(35, 118, 54)
+#define RESULT_WRONG_COLOR COLOR_RED
+
+#define PROMPT_FADE_MS 300
+#define RESULT_FLASH_MS 600
 
 static void str_concat(char *dest, size_t dest_size, const char *src)
 {
@@ -60,6 +69,9 @@ static struct
     Widget *canvas;
 
     const bdf_font_t *label_font;
+    int stroke_width;
+    StrokeLog stroke_log;
+    CanvasHistory history;
 } g_game_page = {0};
 
 Widget *game_page_init(const GameConfig *config)
@@ -73,6 +85,7 @@ Widget *game_page_init(const GameConfig *config)
     g_game_page.num_prompts = config->num_prompts;
     g_game_page.current_prompt_index = 0;
     g_game_page.round = 0;
+    g_game_page.stroke_width = config->stroke_width;
 
     const bdf_font_t *label_font = config->label_font ? config->label_font : &font_medium_font;
     const bdf_font_t *button_font = config->button_font ? config->button_font : &font_medium_font;
@@ -87,26 +100,31 @@ Widget *game_page_init(const GameConfig *config)
         game_page_cleanup();
         return NULL;
     }
+    container_begin_update(g_game_page.game_container);
     container_set_padding(g_game_page.game_container, SPACING_LG);
     container_set_spacing(g_game_page.game_container, SPACING_XL);
     container_set_alignment(g_game_page.game_container, ALIGN_CENTER);
     widget_set_visible(g_game_page.game_container, false);
 
-    g_game_page.label_round = label_create_auto(0, 0, "Round 0", &font_small_font);
+    g_game_page.label_round = label_create_buffered(0, 0, "Round 0", ROUND_TEXT_CAPACITY);
     if (!g_game_page.label_round)
     {
         game_page_cleanup();
         return NULL;
     }
+    label_set_font(g_game_page.label_round, &font_small_font);
+    label_auto_size(g_game_page.label_round);
     label_set_color(g_game_page.label_round, LABEL_ROUND_COLOR);
     container_add_child(g_game_page.game_container, g_game_page.label_round);
 
-    g_game_page.label_prompt = label_create_auto(0, 0, "Draw: ", label_font);
+    g_game_page.label_prompt = label_create_buffered(0, 0, "Draw: ", PROMPT_TEXT_CAPACITY);
     if (!g_game_page.label_prompt)
     {
         game_page_cleanup();
         return NULL;
     }
+    label_set_font(g_game_page.label_prompt, label_font);
+    label_auto_size(g_game_page.label_prompt);
     label_set_color(g_game_page.label_prompt, LABEL_TEXT_COLOR);
     container_add_child(g_game_page.game_container, g_game_page.label_prompt);
 
@@ -122,12 +140,26 @@ Widget *game_page_init(const GameConfig *config)
     canvas_set_border(g_game_page.canvas, CANVAS_COLOR, 1);
     container_add_child(g_game_page.game_container, g_game_page.canvas);
 
+    if (config->stroke_log_buffer && config->stroke_log_capacity > 0)
+    {
+        stroke_log_init(&g_game_page.stroke_log, config->stroke_log_buffer, config->stroke_log_capacity, canvas_width,
+                        canvas_height);
+        canvas_set_stroke_log(g_game_page.canvas, &g_game_page.stroke_log);
+    }
+
+    if (config->history_blocks && config->history_block_count > 0)
+    {
+        canvas_history_init(&g_game_page.history, config->history_blocks, (int)config->history_block_count);
+        canvas_set_history(g_game_page.canvas, &g_game_page.history);
+    }
+
     g_game_page.button_container = hbox_create(0, 0, config->window_width, 40);
     if (!g_game_page.button_container)
     {
         game_page_cleanup();
         return NULL;
     }
+    container_begin_update(g_game_page.button_container);
     container_set_spacing(g_game_page.button_container, SPACING_MD);
     container_set_justify(g_game_page.button_container, ALIGN_CENTER);
 
@@ -146,6 +178,7 @@ Widget *game_page_init(const GameConfig *config)
         game_page_cleanup();
         return NULL;
     }
+    container_begin_update(g_game_page.action_button_container);
     container_set_spacing(g_game_page.action_button_container, SPACING_MD);
     container_set_justify(g_game_page.action_button_container, ALIGN_CENTER);
 
@@ -191,6 +224,10 @@ Widget *game_page_init(const GameConfig *config)
     container_add_child(g_game_page.game_container, g_game_page.action_button_container);
     container_add_child(g_game_page.game_container, g_game_page.button_container);
 
+    container_end_update(g_game_page.action_button_container);
+    container_end_update(g_game_page.button_container);
+    container_end_update(g_game_page.game_container);
+
     return g_game_page.game_container;
 }
 
@@ -225,7 +262,7 @@ static void uint_to_str(unsigned int num, char *str, size_t size)
 
 static void update_round_label(void)
 {
-    char round_text[32];
+    char round_text[ROUND_TEXT_CAPACITY];
     round_text[0] = '\0';
     str_concat(round_text, sizeof(round_text), "Round ");
 
@@ -233,9 +270,9 @@ static void update_round_label(void)
     uint_to_str(g_game_page.round, round_str, sizeof(round_str));
     str_concat(round_text, sizeof(round_text), round_str);
 
+    container_begin_update(g_game_page.game_container);
     label_set_text(g_game_page.label_round, round_text);
-    label_auto_size(g_game_page.label_round);
-    container_update_layout(g_game_page.game_container);
+    container_end_update(g_game_page.game_container);
 }
 
 void game_page_cleanup(void)
@@ -250,6 +287,8 @@ void game_page_cleanup(void)
     g_game_page.button_menu = NULL;
     g_game_page.button_skip = NULL;
     g_game_page.canvas = NULL;
+    stroke_log_init(&g_game_page.stroke_log, NULL, 0, 0, 0);
+    canvas_history_init(&g_game_page.history, NULL, 0);
 }
 
 void game_page_reset_round(void)
@@ -262,19 +301,23 @@ void game_page_start_new_round(void)
 {
     g_game_page.current_prompt_index = rand() % g_game_page.num_prompts;
 
-    char prompt_text[128];
+    char prompt_text[PROMPT_TEXT_CAPACITY];
     prompt_text[0] = '\0';
     str_concat(prompt_text, sizeof(prompt_text), "Draw a: ");
     str_concat(prompt_text, sizeof(prompt_text), g_game_page.drawing_prompts[g_game_page.current_prompt_index]);
+
+    container_begin_update(g_game_page.game_container);
     label_set_text(g_game_page.label_prompt, prompt_text);
-    label_auto_size(g_game_page.label_prompt);
-    container_update_layout(g_game_page.game_container);
 
     widget_set_visible(g_game_page.label_prompt, true);
     widget_set_visible(g_game_page.label_result, false);
     widget_set_visible(g_game_page.button_retry, false);
     widget_set_visible(g_game_page.button_menu, true);
     widget_set_visible(g_game_page.button_skip, true);
+    container_end_update(g_game_page.game_container);
+
+    timeline_add_color(game_get_timeline(), g_game_page.label_prompt, LABEL_ROUND_COLOR, LABEL_TEXT_COLOR,
+                       PROMPT_FADE_MS, EASING_OUT);
 
     canvas_clear(g_game_page.canvas);
 }
@@ -287,12 +330,9 @@ int game_page_send_guess(int guess_index)
     const char *guess = g_game_page.drawing_prompts[guess_index];
     bool correct = (guess_index == (int)g_game_page.current_prompt_index);
 
-    char result_text[256];
-    result_text[0] = '\0';
-    str_concat(result_text, sizeof(result_text), guess);
-
-    label_set_text(g_game_page.label_result, result_text);
-    label_auto_size(g_game_page.label_result);
+    // Prompts are owned by the caller for the lifetime of the game, so the label can point at them directly
+    container_begin_update(g_game_page.game_container);
+    label_set_static_text(g_game_page.label_result, guess);
 
     widget_set_visible(g_game_page.label_result, true);
     widget_set_visible(g_game_page.label_prompt, true);
@@ -304,14 +344,19 @@ int game_page_send_guess(int guess_index)
         update_round_label();
         widget_set_visible(g_game_page.button_retry, true);
         widget_set_visible(g_game_page.button_skip, false);
-        return true;
     }
     else
     {
         widget_set_visible(g_game_page.button_skip, true);
         widget_set_visible(g_game_page.button_retry, false);
     }
-    return false;
+    container_end_update(g_game_page.game_container);
+
+    timeline_add_color(game_get_timeline(), g_game_page.label_result,
+                       correct ? RESULT_CORRECT_COLOR : RESULT_WRONG_COLOR, LABEL_TEXT_COLOR, RESULT_FLASH_MS,
+                       EASING_IN_OUT);
+
+    return correct;
 }
 
 void game_page_get_canvas_28x28(uint8_t *output_buffer)
@@ -319,51 +364,56 @@ void game_page_get_canvas_28x28(uint8_t *output_buffer)
     if (!g_game_page.canvas || !output_buffer)
         return;
 
-    CanvasData *canvas_data = (CanvasData *)g_game_page.canvas->data;
-    if (!canvas_data || !canvas_data->pixels)
+    Widget *canvas = g_game_page.canvas;
+
+    if (canvas->width % CANVAS_DOWNSAMPLE_SIZE == 0 && canvas->height % CANVAS_DOWNSAMPLE_SIZE == 0)
+    {
+        canvas_get_downsample(canvas, output_buffer);
+        return;
+    }
+
+    // The cell counts are coarser when the canvas is not a multiple of the output, but they always fill it
+    CanvasData *canvas_data = (CanvasData *)widget_data(canvas);
+    if (!canvas_data || !canvas_data->pixels ||
+        !resample_area(canvas_data->pixels, canvas->width, canvas->height, canvas->width, output_buffer,
+                       CANVAS_DOWNSAMPLE_SIZE, CANVAS_DOWNSAMPLE_SIZE))
+        canvas_get_downsample(canvas, output_buffer);
+}
+
+void game_page_get_canvas_preprocessed(uint8_t *output_buffer)
+{
+    if (!g_game_page.canvas || !output_buffer)
         return;
 
-    int canvas_width = g_game_page.canvas->width;
-    int canvas_height = g_game_page.canvas->height;
+    CanvasData *canvas_data = (CanvasData *)widget_data(g_game_page.canvas);
+    if (!canvas_data || !canvas_data->pixels)
+        return;
 
-    float x_scale = (float)canvas_width / 28.0f;
-    float y_scale = (float)canvas_height / 28.0f;
+    PreprocessBounds bounds = {0};
+    PreprocessOptions options = {.stroke_width = g_game_page.stroke_width};
 
-    for (int out_y = 0; out_y < 28; out_y++)
+    if (!canvas_get_ink_bounds(g_game_page.canvas, &bounds.x, &bounds.y, &bounds.width, &bounds.height))
     {
-        for (int out_x = 0; out_x < 28; out_x++)
-        {
-            float center_x = (out_x + 0.5f) * x_scale;
-            float center_y = (out_y + 0.5f) * y_scale;
-
-            int start_x = (int)(center_x - x_scale * 0.5f);
-            int end_x = (int)(center_x + x_scale * 0.5f);
-            int start_y = (int)(center_y - y_scale * 0.5f);
-            int end_y = (int)(center_y + y_scale * 0.5f);
-
-            start_x = start_x < 0 ? 0 : start_x;
-            end_x = end_x >= canvas_width ? canvas_width - 1 : end_x;
-            start_y = start_y < 0 ? 0 : start_y;
-            end_y = end_y >= canvas_height ? canvas_height - 1 : end_y;
-
-            int sum = 0;
-            int count = 0;
-
-            for (int y = start_y; y <= end_y; y++)
-            {
-                for (int x = start_x; x <= end_x; x++)
-                {
-                    sum += canvas_data->pixels[y * canvas_width + x];
-                    count++;
-                }
-            }
-
-            output_buffer[out_y * 28 + out_x] = count > 0 ? (uint8_t)(sum / count) : 0;
-        }
+        memset(output_buffer, 0, PREPROCESS_OUTPUT_SIZE * PREPROCESS_OUTPUT_SIZE);
+        return;
     }
+
+    // A crop wider than the resampler takes is sent uncentered rather than blank
+    if (!preprocess_drawing(canvas_data->pixels, g_game_page.canvas->width, &bounds, &options, output_buffer))
+        game_page_get_canvas_28x28(output_buffer);
+}
+
+unsigned int game_page_get_canvas_version(void)
+{
+    return canvas_get_version(g_game_page.canvas);
 }
 
 Widget *game_page_get_canvas(void)
 {
     return g_game_page.canvas;
 }
+
+const StrokeLog *game_page_get_stroke_log(void)
+{
+    return g_game_page.stroke_log.buffer ? &g_game_page.stroke_log : NULL;
+}
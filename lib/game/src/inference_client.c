@@ -0,0 +1,125 @@
+#include "inference_client.h"
+#include <stddef.h>
+#include <string.h>
+
+static void remove_request(InferenceClient *client, unsigned int index);
+
+void inference_client_init(InferenceClient *client, const InferenceBackend *backend, int timeout_ms)
+{
+    if (!client)
+        return;
+
+    memset(client, 0, sizeof(InferenceClient));
+    client->backend = backend;
+    client->next_sequence = 1;
+    client->timeout_ms = timeout_ms > 0 ? timeout_ms : 0;
+}
+
+uint32_t inference_client_submit(InferenceClient *client, const uint8_t *input, unsigned int canvas_version)
+{
+    if (!client || !client->backend || !input || client->count >= INFERENCE_QUEUE_CAPACITY)
+        return 0;
+
+    InferenceRequest *request = &client->requests[client->count++];
+    request->sequence = client->next_sequence++;
+    request->canvas_version = canvas_version;
+    request->age_ms = 0;
+    request->in_flight = false;
+    memcpy(request->input, input, INFERENCE_INPUT_SIZE);
+
+    if (client->next_sequence == 0)
+        client->next_sequence = 1;
+
+    return request->sequence;
+}
+
+void inference_client_cancel_stale(InferenceClient *client, unsigned int canvas_version)
+{
+    if (!client)
+        return;
+
+    for (unsigned int i = client->count; i-- > 0;)
+    {
+        if (client->requests[i].canvas_version != canvas_version)
+        {
+            remove_request(client, i);
+            client->cancelled++;
+        }
+    }
+}
+
+void inference_client_cancel_all(InferenceClient *client)
+{
+    if (!client)
+        return;
+
+    while (client->count > 0)
+    {
+        remove_request(client, client->count - 1);
+        client->cancelled++;
+    }
+}
+
+bool inference_client_update(InferenceClient *client, int delta_ms, InferenceResult *result)
+{
+    if (!client || !client->backend)
+        return false;
+
+    bool timed_out = false;
+    for (unsigned int i = client->count; i-- > 0;)
+    {
+        InferenceRequest *request = &client->requests[i];
+        request->age_ms += delta_ms;
+        if (client->timeout_ms > 0 && request->age_ms >= client->timeout_ms)
+        {
+            if (result && !timed_out)
+                *result = (InferenceResult){request->sequence, request->canvas_version, true, -1};
+            timed_out = true;
+            remove_request(client, i);
+            client->timed_out++;
+        }
+    }
+
+    if (timed_out)
+        return true;
+
+    const InferenceBackend *backend = client->backend;
+    InferenceRequest *oldest = client->count > 0 ? &client->requests[0] : NULL;
+    if (oldest && !oldest->in_flight)
+        oldest->in_flight = backend->submit(backend->context, oldest->sequence, oldest->input);
+
+    uint32_t sequence;
+    int guess_index;
+    while (backend->poll(backend->context, &sequence, &guess_index))
+    {
+        if (!oldest || !oldest->in_flight || oldest->sequence != sequence)
+        {
+            client->stale++;
+            continue;
+        }
+
+        if (result)
+            *result = (InferenceResult){sequence, oldest->canvas_version, false, guess_index};
+        remove_request(client, 0);
+        client->completed++;
+        return true;
+    }
+
+    return false;
+}
+
+bool inference_client_is_pending(const InferenceClient *client)
+{
+    return client && client->count > 0;
+}
+
+// The device is told to drop a request it is working on, so it can take the next one sooner
+static void remove_request(InferenceClient *client, unsigned int index)
+{
+    InferenceRequest *request = &client->requests[index];
+    if (request->in_flight && client->backend->cancel)
+        client->backend->cancel(client->backend->context, request->sequence);
+
+    memmove(request, request + 1, sizeof(InferenceRequest) * (client->count - index - 1));
+    client->count--;
+}
@@ -0,0 +1,68 @@
+#include "inference_sim.h"
+#include <stddef.h>
+#include <string.h>
+
+static bool sim_submit(void *context, uint32_t sequence, const uint8_t *input);
+static bool sim_poll(void *context, uint32_t *sequence, int *guess_index);
+static void sim_cancel(void *context, uint32_t sequence);
+
+void inference_sim_init(InferenceSim *sim, int latency_ms, unsigned int num_classes, inference_sim_classify_t classify,
+                        void *user_data)
+{
+    if (!sim)
+        return;
+
+    memset(sim, 0, sizeof(InferenceSim));
+    sim->latency_ms = latency_ms > 0 ? latency_ms : 0;
+    sim->num_classes = num_classes > 0 ? num_classes : 1;
+    sim->classify = classify;
+    sim->user_data = user_data;
+}
+
+void inference_sim_advance(InferenceSim *sim, int delta_ms)
+{
+    if (sim && sim->busy)
+        sim->elapsed_ms += delta_ms;
+}
+
+InferenceBackend inference_sim_backend(InferenceSim *sim)
+{
+    return (InferenceBackend){sim_submit, sim_poll, sim_cancel, sim};
+}
+
+static bool sim_submit(void *context, uint32_t sequence, const uint8_t *input)
+{
+    InferenceSim *sim = (InferenceSim *)context;
+    if (sim->busy)
+        return false;
+
+    int guess = sim->classify ? sim->classify(input, sim->user_data) : (int)(sequence % sim->num_classes);
+    sim->busy = true;
+    sim->sequence = sequence;
+    sim->guess_index = guess;
+    sim->elapsed_ms = 0;
+    sim->submitted++;
+    return true;
+}
+
+static bool sim_poll(void *context, uint32_t *sequence, int *guess_index)
+{
+    InferenceSim *sim = (InferenceSim *)context;
+    if (!sim->busy || sim->elapsed_ms < sim->latency_ms)
+        return false;
+
+    sim->busy = false;
+    *sequence = sim->sequence;
+    *guess_index = sim->guess_index;
+    return true;
+}
+
+static void sim_cancel(void *context, uint32_t sequence)
+{
+    InferenceSim *sim = (InferenceSim *)context;
+    if (!sim->busy || sim->sequence != sequence)
+        return;
+
+    sim->busy = false;
+    sim->cancelled++;
+}
@@ -0,0 +1,90 @@
+#include "input_queue.h"
+#include <stddef.h>
+#include <string.h>
+
+static InputEvent *event_at(InputQueue *queue, unsigned int index);
+static bool extends_line(const InputEvent *anchor, const InputEvent *last, int x, int y);
+
+void input_queue_init(InputQueue *queue)
+{
+    if (!queue)
+        return;
+
+    memset(queue, 0, sizeof(InputQueue));
+}
+
+bool input_queue_push(InputQueue *queue, InputEventType type, int x, int y, uint32_t timestamp)
+{
+    if (!queue)
+        return false;
+
+    InputEvent *last = queue->count > 0 ? event_at(queue, queue->count - 1) : NULL;
+
+    if (type == INPUT_EVENT_POINTER_MOVE && last && last->type == INPUT_EVENT_POINTER_MOVE)
+    {
+        InputEvent *anchor = queue->count > 1 ? event_at(queue, queue->count - 2) : NULL;
+        bool same_point = last->x == x && last->y == y;
+        bool collinear = anchor && anchor->type != INPUT_EVENT_POINTER_UP && extends_line(anchor, last, x, y);
+
+        if (same_point || collinear || input_queue_is_full(queue))
+        {
+            last->x = (int16_t)x;
+            last->y = (int16_t)y;
+            last->timestamp = timestamp;
+            if (same_point || collinear)
+                queue->coalesced++;
+            else
+                queue->replaced++;
+            return true;
+        }
+    }
+
+    unsigned int limit = type == INPUT_EVENT_POINTER_MOVE ? INPUT_QUEUE_CAPACITY - 2 : INPUT_QUEUE_CAPACITY;
+    if (queue->count >= limit)
+    {
+        queue->dropped++;
+        return false;
+    }
+
+    InputEvent *event = event_at(queue, queue->count);
+    event->type = type;
+    event->timestamp = timestamp;
+    event->x = (int16_t)x;
+    event->y = (int16_t)y;
+    queue->count++;
+
+    return true;
+}
+
+bool input_queue_pop(InputQueue *queue, InputEvent *event)
+{
+    if (!queue || !event || queue->count == 0)
+        return false;
+
+    *event = queue->events[queue->head];
+    queue->head = (queue->head + 1) % INPUT_QUEUE_CAPACITY;
+    queue->count--;
+
+    return true;
+}
+
+bool input_queue_is_full(const InputQueue *queue)
+{
+    return queue && queue->count >= INPUT_QUEUE_CAPACITY - 2;
+}
+
+static InputEvent *event_at(InputQueue *queue, unsigned int index)
+{
+    return &queue->events[(queue->head + index) % INPUT_QUEUE_CAPACITY];
+}
+
+// True if (x, y) lies on the ray from anchor through last, beyond last
+static bool extends_line(const InputEvent *anchor, const InputEvent *last, int x, int y)
+{
+    int ax = last->x - anchor->x;
+    int ay = last->y - anchor->y;
+    int bx = x - last->x;
+    int by = y - last->y;
+
+    return ax * by - ay * bx == 0 && ax * bx + ay * by > 0;
+}
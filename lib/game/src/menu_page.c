@@ -17,6 +17,9 @@
 #include "l_char.h"
 #include "s_char.h"
 
+// Generated from assets/menu_layout.json; refers to the fonts and images above
+#include "menu_layout.h"
+
 #define SPACING_LG 8
 #define SPACING_XL 16
 
@@ -37,6 +40,17 @@ Widget *menu_page_init(const GameConfig *config)
         return NULL;
     }
 
+    // The generated tree is laid out at build time for one window size and the default font; it boots without
+    // allocating or laying anything out. Any other configuration builds the same page at runtime.
+    if (config->window_width == MENU_LAYOUT_WIDTH && config->window_height == MENU_LAYOUT_HEIGHT &&
+        !config->button_font)
+    {
+        g_menu.menu_container = menu_layout_load();
+        g_menu.label_title = &menu_layout.title.widget;
+        g_menu.button_play = &menu_layout.play.widget;
+        return g_menu.menu_container;
+    }
+
     const bdf_font_t *button_font = config->button_font ? config->button_font : &font_medium_font;
 
     g_menu.menu_container = vbox_create(0, 0, config->window_width, config->window_height);
@@ -45,6 +59,7 @@ Widget *menu_page_init(const GameConfig *config)
         menu_page_cleanup();
         return NULL;
     }
+    container_begin_update(g_menu.menu_container);
     container_set_padding(g_menu.menu_container, SPACING_LG);
     container_set_spacing(g_menu.menu_container, SPACING_XL);
     container_set_alignment(g_menu.menu_container, ALIGN_CENTER);
@@ -56,6 +71,7 @@ Widget *menu_page_init(const GameConfig *config)
         menu_page_cleanup();
         return NULL;
     }
+    container_begin_update(g_menu.label_title);
     container_set_spacing(g_menu.label_title, 2);
     container_set_justify(g_menu.label_title, ALIGN_CENTER);
 
@@ -72,6 +88,8 @@ Widget *menu_page_init(const GameConfig *config)
             menu_page_cleanup();
             return NULL;
         }
+        // The letters only ever move, so with a render cache the floating animation copies them
+        widget_set_cached(char_widget, true);
         container_add_child(g_menu.label_title, char_widget);
     }
 
@@ -89,6 +107,9 @@ Widget *menu_page_init(const GameConfig *config)
     button_set_on_click(g_menu.button_play, game_on_play, NULL);
     container_add_child(g_menu.menu_container, g_menu.button_play);
 
+    container_end_update(g_menu.label_title);
+    container_end_update(g_menu.menu_container);
+
     return g_menu.menu_container;
 }
 
@@ -99,10 +120,10 @@ void menu_page_cleanup(void)
     g_menu.button_play = NULL;
 }
 
-void menu_page_update(float delta_time)
+void menu_page_update(int delta_ms)
 {
     if (g_menu.label_title)
     {
-        container_update_animation(g_menu.label_title, delta_time);
+        container_update_animation(g_menu.label_title, delta_ms);
     }
 }
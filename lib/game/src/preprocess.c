@@ -0,0 +1,231 @@
+#include "preprocess.h"
+#include "resample.h"
+#include <string.h>
+
+#define MAX_STROKE_PASSES 2
+
+static void fit_size(int width, int height, int *fit_width, int *fit_height);
+static void normalize_stroke_width(uint8_t *box, int width, int height, int target);
+static void measure_strokes(const uint8_t *box, int width, int height, int *mass, int *perimeter);
+static void morph_3x3(uint8_t *box, int width, int height, bool dilate);
+static int center_offset(const uint8_t *box, int width, int height, bool horizontal);
+
+bool preprocess_find_ink_bounds(const uint8_t *pixels, int width, int height, int stride, PreprocessBounds *bounds)
+{
+    if (!pixels || !bounds || width <= 0 || height <= 0 || stride < width)
+        return false;
+
+    int min_x = width;
+    int min_y = height;
+    int max_x = -1;
+    int max_y = -1;
+
+    for (int y = 0; y < height; y++)
+    {
+        const uint8_t *row = pixels + y * stride;
+        for (int x = 0; x < width; x++)
+        {
+            if (!row[x])
+                continue;
+
+            if (x < min_x)
+                min_x = x;
+            if (x > max_x)
+                max_x = x;
+            if (min_y == height)
+                min_y = y;
+            max_y = y;
+        }
+    }
+
+    if (max_x < 0)
+        return false;
+
+    bounds->x = min_x;
+    bounds->y = min_y;
+    bounds->width = max_x - min_x + 1;
+    bounds->height = max_y - min_y + 1;
+
+    return true;
+}
+
+bool preprocess_drawing(const uint8_t *pixels, int stride, const PreprocessBounds *bounds,
+                        const PreprocessOptions *options, uint8_t *output)
+{
+    if (!output)
+        return false;
+
+    memset(output, 0, PREPROCESS_OUTPUT_SIZE * PREPROCESS_OUTPUT_SIZE);
+
+    if (!pixels || !bounds || bounds->width <= 0 || bounds->height <= 0)
+        return false;
+
+    int fit_width;
+    int fit_height;
+    fit_size(bounds->width, bounds->height, &fit_width, &fit_height);
+
+    uint8_t box[PREPROCESS_FIT_SIZE * PREPROCESS_FIT_SIZE];
+    const uint8_t *crop = pixels + bounds->y * stride + bounds->x;
+
+    if (!resample_area(crop, bounds->width, bounds->height, stride, box, fit_width, fit_height))
+        return false;
+
+    int offset_x = center_offset(box, fit_width, fit_height, true);
+    int offset_y = center_offset(box, fit_width, fit_height, false);
+    if (offset_x < 0 || offset_y < 0)
+        return false;
+
+    for (int y = 0; y < fit_height; y++)
+    {
+        memcpy(output + (offset_y + y) * PREPROCESS_OUTPUT_SIZE + offset_x, box + y * fit_width, fit_width);
+    }
+
+    if (options && options->stroke_width > 0)
+    {
+        normalize_stroke_width(output, PREPROCESS_OUTPUT_SIZE, PREPROCESS_OUTPUT_SIZE, options->stroke_width);
+    }
+
+    return true;
+}
+
+static void fit_size(int width, int height, int *fit_width, int *fit_height)
+{
+    if (width >= height)
+    {
+        *fit_width = PREPROCESS_FIT_SIZE;
+        *fit_height = (height * PREPROCESS_FIT_SIZE + width / 2) / width;
+    }
+    else
+    {
+        *fit_height = PREPROCESS_FIT_SIZE;
+        *fit_width = (width * PREPROCESS_FIT_SIZE + height / 2) / height;
+    }
+
+    if (*fit_width < 1)
+        *fit_width = 1;
+    if (*fit_height < 1)
+        *fit_height = 1;
+}
+
+// Places the box so its center of mass lands on the middle of the output, clamped so the box stays inside.
+// Returns -1 if the box has no ink.
+static int center_offset(const uint8_t *box, int width, int height, bool horizontal)
+{
+    uint32_t mass = 0;
+    uint32_t moment = 0;
+
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            uint32_t value = box[y * width + x];
+            mass += value;
+            moment += value * (uint32_t)(2 * (horizontal ? x : y) + 1);
+        }
+    }
+
+    if (mass == 0)
+        return -1;
+
+    int size = horizontal ? width : height;
+
+    // Pixel centers sit at half-integers, so the moment is taken in half-pixel units.
+    int center_half = (int)((moment + mass / 2) / mass);
+    int offset = (PREPROCESS_OUTPUT_SIZE - center_half + 1) >> 1;
+
+    if (offset < 0)
+        offset = 0;
+    if (offset > PREPROCESS_OUTPUT_SIZE - size)
+        offset = PREPROCESS_OUTPUT_SIZE - size;
+
+    return offset;
+}
+
+// Estimates the mean stroke width as 2 * ink mass / perimeter and thickens or thins the strokes with
+// 3x3 grayscale dilation or erosion until the estimate is within half a pixel of the target.
+static void normalize_stroke_width(uint8_t *box, int width, int height, int target)
+{
+    for (int pass = 0; pass < MAX_STROKE_PASSES; pass++)
+    {
+        int mass;
+        int perimeter;
+        measure_strokes(box, width, height, &mass, &perimeter);
+
+        if (mass == 0 || perimeter == 0)
+            return;
+
+        if (4 * mass < perimeter * (2 * target - 1) * 255)
+        {
+            morph_3x3(box, width, height, true);
+        }
+        else if (4 * mass > perimeter * (2 * target + 1) * 255)
+        {
+            uint8_t backup[PREPROCESS_OUTPUT_SIZE * PREPROCESS_OUTPUT_SIZE];
+            memcpy(backup, box, width * height);
+
+            morph_3x3(box, width, height, false);
+
+            measure_strokes(box, width, height, &mass, &perimeter);
+            if (mass == 0)
+            {
+                memcpy(box, backup, width * height);
+                return;
+            }
+        }
+        else
+        {
+            return;
+        }
+    }
+}
+
+static void measure_strokes(const uint8_t *box, int width, int height, int *mass, int *perimeter)
+{
+    *mass = 0;
+    *perimeter = 0;
+
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            if (!box[y * width + x])
+                continue;
+
+            *mass += box[y * width + x];
+
+            bool edge = x == 0 || y == 0 || x == width - 1 || y == height - 1 || !box[y * width + x - 1] ||
+                        !box[y * width + x + 1] || !box[(y - 1) * width + x] || !box[(y + 1) * width + x];
+            if (edge)
+                (*perimeter)++;
+        }
+    }
+}
+
+static void morph_3x3(uint8_t *box, int width, int height, bool dilate)
+{
+    uint8_t source[PREPROCESS_OUTPUT_SIZE * PREPROCESS_OUTPUT_SIZE];
+    memcpy(source, box, width * height);
+
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            uint8_t value = source[y * width + x];
+
+            for (int dy = -1; dy <= 1; dy++)
+            {
+                for (int dx = -1; dx <= 1; dx++)
+                {
+                    int nx = x + dx;
+                    int ny = y + dy;
+                    uint8_t neighbour = (nx >= 0 && ny >= 0 && nx < width && ny < height) ? source[ny * width + nx] : 0;
+
+                    if (dilate ? neighbour > value : neighbour < value)
+                        value = neighbour;
+                }
+            }
+
+            box[y * width + x] = value;
+        }
+    }
+}
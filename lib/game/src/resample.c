@@ -0,0 +1,162 @@
+#include "resample.h"
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#define RESAMPLE_MAX_SOURCE_AREA (1u << 24)
+
+typedef struct
+{
+    uint16_t start;
+    uint16_t length;
+    uint16_t first_weight;
+    uint16_t last_weight;
+} ColumnSpan;
+
+static void accumulate_row(const uint8_t *row, int width, uint16_t weight, uint32_t *columns);
+static void build_column_spans(int src_width, int dst_width, ColumnSpan *spans);
+static void emit_row(const uint32_t *columns, const ColumnSpan *spans, int dst_width, uint32_t area, uint8_t *out);
+
+bool resample_area(const uint8_t *src, int src_width, int src_height, int src_stride, uint8_t *dst, int dst_width,
+                   int dst_height)
+{
+    if (!src || !dst || src_width <= 0 || src_height <= 0 || dst_width <= 0 || dst_height <= 0)
+        return false;
+
+    if (src_stride < src_width || src_width > RESAMPLE_MAX_SOURCE_WIDTH)
+        return false;
+
+    if (dst_width > RESAMPLE_MAX_OUTPUT_SIZE || dst_height > RESAMPLE_MAX_OUTPUT_SIZE)
+        return false;
+
+    if ((uint32_t)src_width * (uint32_t)src_height > RESAMPLE_MAX_SOURCE_AREA)
+        return false;
+
+    ColumnSpan spans[RESAMPLE_MAX_OUTPUT_SIZE];
+    uint32_t columns[RESAMPLE_MAX_SOURCE_WIDTH];
+
+    build_column_spans(src_width, dst_width, spans);
+
+    uint32_t area = (uint32_t)src_width * (uint32_t)src_height;
+
+    // Source row sy covers [sy * dst_height, (sy + 1) * dst_height) and output row oy covers
+    // [oy * src_height, (oy + 1) * src_height) on a shared axis, so every overlap is an exact integer.
+    // Rows are first reduced vertically into per-column sums, then each output row is reduced horizontally once.
+    memset(columns, 0, sizeof(uint32_t) * src_width);
+    int oy = 0;
+    uint32_t boundary = (uint32_t)src_height;
+
+    for (int sy = 0; sy < src_height; sy++)
+    {
+        const uint8_t *row = src + (long)sy * src_stride;
+        uint32_t pos = (uint32_t)sy * dst_height;
+        uint32_t row_end = pos + dst_height;
+
+        while (pos < row_end)
+        {
+            uint32_t segment_end = row_end < boundary ? row_end : boundary;
+
+            accumulate_row(row, src_width, (uint16_t)(segment_end - pos), columns);
+
+            pos = segment_end;
+            if (pos == boundary)
+            {
+                emit_row(columns, spans, dst_width, area, dst + oy * dst_width);
+
+                memset(columns, 0, sizeof(uint32_t) * src_width);
+                oy++;
+                boundary += (uint32_t)src_height;
+            }
+        }
+    }
+
+    return true;
+}
+
+// Output column ox covers [ox * src_width, (ox + 1) * src_width) and source pixel sx covers
+// [sx * dst_width, (sx + 1) * dst_width). Only the first and last pixel of a span can be partial.
+static void build_column_spans(int src_width, int dst_width, ColumnSpan *spans)
+{
+    for (int ox = 0; ox < dst_width; ox++)
+    {
+        uint32_t left = (uint32_t)ox * src_width;
+        uint32_t right = left + src_width;
+        uint32_t first = left / dst_width;
+        uint32_t last = (right - 1) / dst_width;
+
+        spans[ox].start = (uint16_t)first;
+        spans[ox].length = (uint16_t)(last - first + 1);
+
+        if (first == last)
+        {
+            spans[ox].first_weight = (uint16_t)src_width;
+            spans[ox].last_weight = (uint16_t)dst_width;
+        }
+        else
+        {
+            spans[ox].first_weight = (uint16_t)((first + 1) * dst_width - left);
+            spans[ox].last_weight = (uint16_t)(right - last * dst_width);
+        }
+    }
+}
+
+static void emit_row(const uint32_t *columns, const ColumnSpan *spans, int dst_width, uint32_t area, uint8_t *out)
+{
+    for (int ox = 0; ox < dst_width; ox++)
+    {
+        const ColumnSpan *span = &spans[ox];
+        const uint32_t *sums = columns + span->start;
+        uint32_t total;
+
+        if (span->length == 1)
+        {
+            total = sums[0] * span->first_weight;
+        }
+        else
+        {
+            uint32_t sum = 0;
+            for (int x = 0; x < span->length; x++)
+            {
+                sum += sums[x];
+            }
+
+            total = sum * (uint32_t)dst_width;
+            total -= sums[0] * (uint32_t)(dst_width - span->first_weight);
+            total -= sums[span->length - 1] * (uint32_t)(dst_width - span->last_weight);
+        }
+
+        out[ox] = (uint8_t)((total + area / 2) / area);
+    }
+}
+
+// Row reduction kernel: columns[x] += row[x] * weight. The weight is at most RESAMPLE_MAX_OUTPUT_SIZE,
+// so each product fits in 16 bits and eight pixels can be widened and scaled per SSE2 multiply.
+static void accumulate_row(const uint8_t *row, int width, uint16_t weight, uint32_t *columns)
+{
+    int x = 0;
+
+#if defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i scale = _mm_set1_epi16((short)weight);
+
+    for (; x + 16 <= width; x += 16)
+    {
+        __m128i pixels = _mm_loadu_si128((const __m128i *)(row + x));
+        __m128i lo = _mm_mullo_epi16(_mm_unpacklo_epi8(pixels, zero), scale);
+        __m128i hi = _mm_mullo_epi16(_mm_unpackhi_epi8(pixels, zero), scale);
+
+        __m128i *dst = (__m128i *)(columns + x);
+        _mm_storeu_si128(dst, _mm_add_epi32(_mm_loadu_si128(dst), _mm_unpacklo_epi16(lo, zero)));
+        _mm_storeu_si128(dst + 1, _mm_add_epi32(_mm_loadu_si128(dst + 1), _mm_unpackhi_epi16(lo, zero)));
+        _mm_storeu_si128(dst + 2, _mm_add_epi32(_mm_loadu_si128(dst + 2), _mm_unpacklo_epi16(hi, zero)));
+        _mm_storeu_si128(dst + 3, _mm_add_epi32(_mm_loadu_si128(dst + 3), _mm_unpackhi_epi16(hi, zero)));
+    }
+#endif
+
+    for (; x < width; x++)
+    {
+        columns[x] += row[x] * (uint32_t)weight;
+    }
+}
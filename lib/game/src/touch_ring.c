@@ -0,0 +1,72 @@
+#include "touch_ring.h"
+#include <stddef.h>
+
+void touch_ring_init(TouchRing *ring)
+{
+    if (!ring)
+        return;
+
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+    atomic_init(&ring->overflow, 0);
+}
+
+bool touch_ring_push(TouchRing *ring, const TouchSample *sample)
+{
+    if (!ring || !sample)
+        return false;
+
+    unsigned int head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    unsigned int tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+
+    if (head - tail >= TOUCH_RING_SIZE)
+    {
+        atomic_fetch_add_explicit(&ring->overflow, 1, memory_order_relaxed);
+        return false;
+    }
+
+    ring->samples[head & (TOUCH_RING_SIZE - 1)] = *sample;
+
+    // Publishes the sample written above to the consumer
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+
+    return true;
+}
+
+bool touch_ring_pop(TouchRing *ring, TouchSample *sample)
+{
+    if (!ring || !sample)
+        return false;
+
+    unsigned int tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    unsigned int head = atomic_load_explicit(&ring->head, memory_order_acquire);
+
+    if (head == tail)
+        return false;
+
+    *sample = ring->samples[tail & (TOUCH_RING_SIZE - 1)];
+
+    // Hands the slot back to the producer only after it has been copied out
+    atomic_store_explicit(&ring->tail, tail + 1, memory_order_release);
+
+    return true;
+}
+
+unsigned int touch_ring_count(TouchRing *ring)
+{
+    if (!ring)
+        return 0;
+
+    unsigned int tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    unsigned int head = atomic_load_explicit(&ring->head, memory_order_acquire);
+
+    return head - tail;
+}
+
+unsigned int touch_ring_overflow_count(TouchRing *ring)
+{
+    if (!ring)
+        return 0;
+
+    return atomic_load_explicit(&ring->overflow, memory_order_relaxed);
+}
@@ -0,0 +1,64 @@
+#ifndef CANVAS_HISTORY_H_INCLUDED
+#define CANVAS_HISTORY_H_INCLUDED
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define CANVAS_TILE_SIZE 16
+#define CANVAS_HISTORY_MAX_STROKES 32
+#define CANVAS_HISTORY_MAX_TILES 1024
+
+// One canvas tile stored as a 1 bit per pixel snapshot. Canvas pixels are either 0 or 255.
+typedef struct
+{
+    uint16_t tile;
+    uint8_t bits[CANVAS_TILE_SIZE * CANVAS_TILE_SIZE / 8];
+} CanvasTileBlock;
+
+typedef struct
+{
+    int first_block;
+    int block_count;
+    int log_start;
+    int log_end;
+    int log_start_x;
+    int log_start_y;
+    int log_end_x;
+    int log_end_y;
+} CanvasHistoryEntry;
+
+// Undo history for a canvas. Before a stroke first writes to a tile, the tile is copied into the next block
+// of a caller-provided ring. Undo and redo swap a stroke's blocks with the live tiles, so both cost time and
+// memory proportional to the tiles the stroke touched. The oldest strokes are dropped when the ring is full.
+typedef struct
+{
+    CanvasTileBlock *blocks;
+    int block_capacity;
+    int block_start;
+    int block_used;
+
+    CanvasHistoryEntry entries[CANVAS_HISTORY_MAX_STROKES];
+    int entry_start;
+    int entry_count;
+    int undo_count;
+
+    bool in_stroke;
+    bool recording;
+    uint8_t saved_tiles[CANVAS_HISTORY_MAX_TILES / 8];
+} CanvasHistory;
+
+void canvas_history_init(CanvasHistory *history, CanvasTileBlock *blocks, int block_capacity);
+void canvas_history_reset(CanvasHistory *history);
+
+void canvas_history_begin_stroke(CanvasHistory *history, int log_length, int log_x, int log_y);
+void canvas_history_end_stroke(CanvasHistory *history, int log_length, int log_x, int log_y);
+CanvasTileBlock *canvas_history_save_tile(CanvasHistory *history, int tile);
+
+CanvasHistoryEntry *canvas_history_undo(CanvasHistory *history);
+CanvasHistoryEntry *canvas_history_redo(CanvasHistory *history);
+CanvasTileBlock *canvas_history_block(CanvasHistory *history, const CanvasHistoryEntry *entry, int index);
+
+bool canvas_history_can_undo(const CanvasHistory *history);
+bool canvas_history_can_redo(const CanvasHistory *history);
+
+#endif
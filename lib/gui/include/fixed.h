@@ -0,0 +1,33 @@
+#ifndef FIXED_H_INCLUDED
+#define FIXED_H_INCLUDED
+
+#include <stdint.h>
+
+// Q16.16 for general values and Q1.15 for values within [-1, 1], so GUI and game code never needs an FPU
+typedef int32_t q16_t;
+typedef int16_t q15_t;
+
+#define Q16_ONE ((q16_t)0x10000)
+#define Q15_ONE ((q15_t)0x7FFF)
+
+#define Q16_FROM_INT(n) ((q16_t)(n) * Q16_ONE)
+// Rounds half away from zero
+#define Q16_ROUND(q) ((int)((q) >= 0 ? ((q) + Q16_ONE / 2) >> 16 : -((-(q) + Q16_ONE / 2) >> 16)))
+#define Q16_FROM_Q15(q) ((q16_t)(q) * 2)
+
+// Angles are binary: 65536 is a full turn, so they wrap on their own
+#define ANGLE_FROM_DEGREES(degrees) ((uint16_t)((int32_t)(degrees) * 65536 / 360))
+
+q16_t q16_mul(q16_t a, q16_t b);
+// Saturates on division by zero
+q16_t q16_div(q16_t a, q16_t b);
+q16_t q16_lerp(q16_t from, q16_t to, q16_t t);
+q16_t q16_sqrt(q16_t x);
+q16_t q16_sin(uint16_t angle);
+q16_t q16_cos(uint16_t angle);
+
+q15_t q15_mul(q15_t a, q15_t b);
+q15_t q15_sin(uint16_t angle);
+q15_t q15_cos(uint16_t angle);
+
+#endif
@@ -4,11 +4,14 @@
 #include "color.h"
 
 #define MAX_DIRTY_RECTS 32
+#define MAX_OCCLUDERS 16
 
 // Used if you want to rotate/flip the screen
-#define FRAMEBUFFER_SET_PIXEL(fb, x, y, color) ((fb)->pixels[(y) * (fb)->width + (x)] = (color))
+#define FRAMEBUFFER_SET_PIXEL(fb, x, y, color) ((fb)->pixels[(y) * FRAMEBUFFER_STRIDE(fb) + (x)] = (color))
+#define FRAMEBUFFER_GET_PIXEL(fb, x, y) ((fb)->pixels[(y) * FRAMEBUFFER_STRIDE(fb) + (x)])
 #define FRAMEBUFFER_WIDTH(fb) ((fb)->width)
 #define FRAMEBUFFER_HEIGHT(fb) ((fb)->height)
+#define FRAMEBUFFER_STRIDE(fb) ((fb)->stride ? (fb)->stride : (fb)->width)
 
 typedef struct
 {
@@ -23,12 +26,31 @@ typedef struct
     Color *pixels;
     int width;
     int height;
+    // Pixels from one row to the next; 0 means rows are packed. Views into a larger framebuffer keep its stride.
+    int stride;
 
     DirtyRect dirty_rects[MAX_DIRTY_RECTS];
     int dirty_rect_count;
+    // Color dirty areas were last cleared to
+    Color background;
+
+    // Screen position of the container being traversed. Widget coordinates are relative to their parent,
+    // so containers shift this while they visit their children.
+    int origin_x;
+    int origin_y;
+
+    // Screen rects of opaque widgets that are drawn later in this frame, on top of whatever is being visited
+    DirtyRect occluders[MAX_OCCLUDERS];
+    int occluder_count;
 } Framebuffer;
 
 void framebuffer_clear(Framebuffer *framebuffer, Color clear_color);
 void framebuffer_clear_dirty_rects(Framebuffer *framebuffer, Color clear_color);
 
+// A framebuffer covering only the given screen rect, clipped to the parent. Drawing in screen coordinates lands in
+// the same place as in the parent, and anything outside the rect is cut off.
+Framebuffer framebuffer_view(const Framebuffer *framebuffer, int x, int y, int width, int height);
+// Moves the pixels of a rect up by dy rows, or down when dy is negative. The rows scrolled in keep stale pixels.
+void framebuffer_scroll(Framebuffer *framebuffer, int x, int y, int width, int height, int dy);
+
 #endif
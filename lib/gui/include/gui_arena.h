@@ -0,0 +1,76 @@
+#ifndef GUI_ARENA_H_INCLUDED
+#define GUI_ARENA_H_INCLUDED
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define GUI_ARENA_MAX_POOLS 16
+#define GUI_ARENA_ALIGN 8
+// Requests up to this size share power-of-two pools, so strings of similar length reuse each other's blocks.
+// Larger requests get a pool of their exact size, which gives every widget and data struct a pool of its own.
+#define GUI_ARENA_SMALL_LIMIT 64
+
+typedef struct
+{
+    size_t block_size;
+    void *free_list;
+    unsigned int blocks;
+    unsigned int in_use;
+    unsigned int peak_in_use;
+} GuiArenaPool;
+
+// Fixed-size pools carved on demand from one caller-owned buffer. Freed blocks go back to their pool and are
+// reused for the next request of the same class; reset releases everything at once. The arena never touches
+// the heap.
+typedef struct
+{
+    uint8_t *buffer;
+    size_t capacity;
+    size_t used;
+    size_t peak_used;
+    size_t live_bytes;
+    size_t peak_live_bytes;
+    unsigned int allocations;
+    unsigned int failed_allocations;
+    GuiArenaPool pools[GUI_ARENA_MAX_POOLS];
+    int pool_count;
+} GuiArena;
+
+typedef struct
+{
+    size_t capacity;
+    size_t used;
+    size_t peak_used;
+    size_t live_bytes;
+    size_t peak_live_bytes;
+    // Carved bytes sitting on free lists, waiting for a request of the same class
+    size_t free_bytes;
+    unsigned int live_blocks;
+    unsigned int allocations;
+    unsigned int failed_allocations;
+    int pool_count;
+    // Share of the carved bytes not holding live data: free blocks, headers and rounding
+    int fragmentation_percent;
+} GuiArenaStats;
+
+void gui_arena_init(GuiArena *arena, void *buffer, size_t capacity);
+void gui_arena_reset(GuiArena *arena);
+
+void *gui_arena_alloc(GuiArena *arena, size_t size);
+void gui_arena_free(GuiArena *arena, void *ptr);
+bool gui_arena_owns(const GuiArena *arena, const void *ptr);
+void gui_arena_get_stats(const GuiArena *arena, GuiArenaStats *stats);
+
+// Widgets allocate through these. While an arena is active they draw from it, otherwise from the heap; with
+// GUI_NO_HEAP defined there is no heap fallback and allocations fail without an arena. The arena has to stay
+// active until the widgets created from it are destroyed or the arena is reset.
+void gui_set_arena(GuiArena *arena);
+GuiArena *gui_get_arena(void);
+
+void *gui_alloc(size_t size);
+void *gui_realloc(void *ptr, size_t size);
+void gui_free(void *ptr);
+char *gui_strdup(const char *text);
+
+#endif
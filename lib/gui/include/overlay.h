@@ -0,0 +1,64 @@
+#ifndef OVERLAY_H_INCLUDED
+#define OVERLAY_H_INCLUDED
+
+#include "color.h"
+#include "framebuffer.h"
+#include <stdbool.h>
+
+#define MAX_OVERLAYS 8
+
+struct Overlay;
+
+// Draws the sprite into a framebuffer clipped to the overlay's rect; its top-left corner is at the origin
+typedef void (*OverlayDrawCallback)(const struct Overlay *overlay, Framebuffer *framebuffer);
+
+// A sprite drawn over the finished frame, outside the widget tree. The pixels it covers are copied into a
+// caller-owned buffer of width * height colors before it is drawn and put back before the next frame renders,
+// so moving it costs twice its area and never repaints the widgets underneath.
+typedef struct Overlay
+{
+    OverlayDrawCallback draw;
+    void *user_data;
+    Color *saved;
+    int x;
+    int y;
+    int width;
+    int height;
+    // Screen rect whose pixels are held in saved, clipped to the framebuffer
+    int saved_x;
+    int saved_y;
+    int saved_width;
+    int saved_height;
+    bool visible;
+    bool on_screen;
+    bool changed;
+} Overlay;
+
+// Overlays in drawing order, the last one on top
+typedef struct
+{
+    Overlay *overlays[MAX_OVERLAYS];
+    int count;
+} OverlayLayer;
+
+void overlay_init(Overlay *overlay, Color *save_buffer, int width, int height, OverlayDrawCallback draw,
+                  void *user_data);
+void overlay_move(Overlay *overlay, int x, int y);
+void overlay_set_visible(Overlay *overlay, bool visible);
+// Redraws the sprite on the next frame after what it shows changed
+void overlay_invalidate(Overlay *overlay);
+
+void overlay_layer_init(OverlayLayer *layer);
+bool overlay_layer_add(OverlayLayer *layer, Overlay *overlay);
+// Puts back the pixels under every overlay before the one removed goes; the rest are drawn again next frame
+void overlay_layer_remove(OverlayLayer *layer, Overlay *overlay, Framebuffer *framebuffer);
+
+// True when an overlay moved, changed, or is due on screen, so the layer has to be restored and drawn even
+// though no widget repaints
+bool overlay_layer_needs_update(const OverlayLayer *layer);
+// Puts back the pixels under every overlay on screen, topmost first. Call before the widgets render.
+void overlay_layer_restore(OverlayLayer *layer, Framebuffer *framebuffer);
+// Saves the pixels under every visible overlay and draws it, bottom first. Call after the widgets render.
+void overlay_layer_draw(OverlayLayer *layer, Framebuffer *framebuffer);
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef PAGE_SNAPSHOT_H_INCLUDED
+#define PAGE_SNAPSHOT_H_INCLUDED
+
+#include "color.h"
+#include "framebuffer.h"
+#include "widgets/widget.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Equal pixels in raster order. Runs carry on from one row into the next, so once a display's window is set to
+// the snapshot's rect the runs can be streamed to it as they are.
+typedef struct
+{
+    uint16_t length;
+    Color color;
+} SnapshotRun;
+
+// What a page looked like when it was last on screen, run-length encoded into one caller-owned buffer. Flat
+// backgrounds shrink to a few runs per widget edge; a page too busy to fit leaves the snapshot invalid.
+typedef struct
+{
+    SnapshotRun *runs;
+    size_t capacity;
+    size_t run_count;
+    int x;
+    int y;
+    int width;
+    int height;
+    bool valid;
+} PageSnapshot;
+
+void page_snapshot_init(PageSnapshot *snapshot, void *buffer, size_t size);
+void page_snapshot_invalidate(PageSnapshot *snapshot);
+// Encodes a screen rect, which has to lie inside the framebuffer. Returns false when the runs do not fit.
+bool page_snapshot_capture(PageSnapshot *snapshot, const Framebuffer *framebuffer, int x, int y, int width,
+                           int height);
+bool page_snapshot_restore(const PageSnapshot *snapshot, Framebuffer *framebuffer);
+
+// Pages are containers shown one at a time over the same rect of a parent. A suspended page is taken out of the
+// tree, so its widgets can keep changing without anything being drawn; they stay dirty until the page resumes.
+// Suspending captures the page as the screen shows it. Resuming puts those pixels back, so only the widgets that
+// changed in between are drawn, or clears the rect and draws everything when the snapshot cannot be used.
+void page_suspend(Widget *page, PageSnapshot *snapshot, const Framebuffer *framebuffer);
+bool page_resume(Widget *container, Widget *page, const PageSnapshot *snapshot, Framebuffer *framebuffer);
+
+#endif
@@ -9,6 +9,11 @@ void renderText(const char *text, Color color, int x, int y, const bdf_font_t *f
 
 int measureTextWidth(const char *text, const bdf_font_t *font);
 
+// Variants that stop after length characters, for drawing and measuring part of a longer string
+void renderTextSpan(const char *text, int length, Color color, int x, int y, const bdf_font_t *font,
+                    Framebuffer *framebuffer);
+int measureTextSpan(const char *text, int length, const bdf_font_t *font);
+
 int getFontHeight(const bdf_font_t *font);
 
 #endif
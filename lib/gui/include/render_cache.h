@@ -0,0 +1,54 @@
+#ifndef RENDER_CACHE_H_INCLUDED
+#define RENDER_CACHE_H_INCLUDED
+
+#include "framebuffer.h"
+#include "widgets/widget.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define RENDER_CACHE_MAX_ENTRIES 32
+
+typedef struct
+{
+    Widget *widget;
+    size_t offset;
+    int16_t width;
+    int16_t height;
+    // Clear color the surface was composited over
+    Color background;
+    bool valid;
+    uint32_t last_used;
+} RenderCacheEntry;
+
+// Surfaces of widgets marked cached, kept in the framebuffer's own pixel format inside one caller-owned buffer.
+// A widget whose content has not changed since it was captured is drawn by copying its surface, wherever it has
+// moved. When the buffer or the entry table is full the least recently drawn surface is evicted and the rest are
+// packed down; a widget larger than the whole buffer is simply drawn directly.
+typedef struct
+{
+    Color *pixels;
+    size_t capacity;
+    size_t used;
+    RenderCacheEntry entries[RENDER_CACHE_MAX_ENTRIES];
+    int entry_count;
+    uint32_t clock;
+    unsigned int hits;
+    unsigned int misses;
+    unsigned int evictions;
+} RenderCache;
+
+void render_cache_init(RenderCache *cache, void *buffer, size_t size);
+void render_cache_reset(RenderCache *cache);
+
+// Widgets draw through the active cache; with none active every widget is drawn directly
+void render_cache_set_active(RenderCache *cache);
+RenderCache *render_cache_get_active(void);
+
+// Draws a cached widget at its current position, capturing it first if needed. Returns false when the widget
+// could not be cached and has to be drawn directly.
+bool render_cache_draw(Widget *widget, Framebuffer *framebuffer);
+void render_cache_invalidate(Widget *widget);
+void render_cache_forget(Widget *widget);
+
+#endif
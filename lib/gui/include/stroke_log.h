@@ -0,0 +1,50 @@
+#ifndef STROKE_LOG_H_INCLUDED
+#define STROKE_LOG_H_INCLUDED
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef enum
+{
+    STROKE_OP_MOVE,
+    STROKE_OP_PEN_DOWN,
+    STROKE_OP_PEN_UP,
+} StrokeOp;
+
+// Pen events as a byte stream. Each event is a varint holding (zigzag(dx) << 2 | op), followed by a varint
+// zigzag(dy) for pen-down and move events. Deltas are relative to the previous point, so a typical move costs
+// two bytes. Once the buffer is full, further events are dropped and overflow is set; one byte is always kept
+// free so an open stroke can still be closed.
+typedef struct
+{
+    uint8_t *buffer;
+    int capacity;
+    int length;
+    int width;
+    int height;
+    int last_x;
+    int last_y;
+    bool pen_down;
+    bool overflow;
+} StrokeLog;
+
+typedef struct
+{
+    const uint8_t *data;
+    int length;
+    int position;
+    int x;
+    int y;
+} StrokeLogReader;
+
+void stroke_log_init(StrokeLog *log, uint8_t *buffer, int capacity, int width, int height);
+void stroke_log_reset(StrokeLog *log);
+
+bool stroke_log_pen_down(StrokeLog *log, int x, int y);
+bool stroke_log_move(StrokeLog *log, int x, int y);
+bool stroke_log_pen_up(StrokeLog *log);
+
+void stroke_log_reader_init(StrokeLogReader *reader, const uint8_t *data, int length);
+bool stroke_log_read(StrokeLogReader *reader, StrokeOp *op, int *x, int *y);
+
+#endif
@@ -0,0 +1,66 @@
+#ifndef TIMELINE_H_INCLUDED
+#define TIMELINE_H_INCLUDED
+
+#include "color.h"
+#include "widgets/widget.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define TIMELINE_MAX_TWEENS 16
+
+typedef enum
+{
+    TWEEN_PROPERTY_X,
+    TWEEN_PROPERTY_Y,
+    // Background of a button, text of a label
+    TWEEN_PROPERTY_COLOR,
+} TweenProperty;
+
+typedef enum
+{
+    EASING_LINEAR,
+    EASING_IN,
+    EASING_OUT,
+    EASING_IN_OUT,
+} Easing;
+
+typedef struct
+{
+    Widget *widget;
+    uint8_t property;
+    uint8_t easing;
+    bool active : 1;
+    bool loop : 1;
+    bool yoyo : 1;
+    // Pixels for positions, a packed ARGB value for colors
+    int32_t from;
+    int32_t to;
+    int32_t current;
+    uint16_t duration_ms;
+    uint16_t delay_ms;
+    uint32_t elapsed_ms;
+} Tween;
+
+// A fixed pool of tweens driven by integer milliseconds. Progress and easing are Q16 fixed point, and a widget is
+// only touched when the rounded value of its property changes, so its setter marks just the old and new areas.
+typedef struct
+{
+    Tween tweens[TIMELINE_MAX_TWEENS];
+} Timeline;
+
+void timeline_init(Timeline *timeline);
+void timeline_update(Timeline *timeline, int elapsed_ms);
+bool timeline_is_running(const Timeline *timeline);
+
+// The start value is applied at once. A widget has at most one tween per property; adding another replaces it.
+// Returns NULL when the pool is full.
+Tween *timeline_add(Timeline *timeline, Widget *widget, TweenProperty property, int from, int to, int duration_ms,
+                    Easing easing);
+Tween *timeline_add_color(Timeline *timeline, Widget *widget, Color from, Color to, int duration_ms, Easing easing);
+void timeline_cancel(Timeline *timeline, Widget *widget);
+
+void tween_set_delay(Tween *tween, int delay_ms);
+// Restarts forever; a yoyo tween runs back to its start value before restarting
+void tween_set_loop(Tween *tween, bool yoyo);
+
+#endif
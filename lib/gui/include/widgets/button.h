@@ -4,10 +4,11 @@
 #include "color.h"
 #include "font_types.h"
 #include "widgets/widget.h"
+#include "widgets/widget_text.h"
 
 typedef struct
 {
-    char *text;
+    WidgetText text;
     int padding;
     Color background_color;
     Color text_color;
@@ -16,11 +17,16 @@ typedef struct
     const bdf_font_t *font;
 } ButtonData;
 
+// Shared with generated layouts, which build buttons in static storage
+extern const WidgetVTable button_vtable;
+
 Widget *button_create(int x, int y, int width, int height, const char *text);
 
 Widget *button_create_auto(int x, int y, const char *text, const bdf_font_t *font);
+Widget *button_create_buffered(int x, int y, int width, int height, const char *text, int capacity);
 
 void button_set_text(Widget *button, const char *text);
+void button_set_static_text(Widget *button, const char *text);
 void button_set_padding(Widget *button, int padding);
 void button_set_background_color(Widget *button, Color color);
 void button_set_text_color(Widget *button, Color color);
@@ -1,8 +1,13 @@
 #ifndef CANVAS_H_INCLUDED
 #define CANVAS_H_INCLUDED
 
+#include "canvas_history.h"
 #include "color.h"
+#include "stroke_log.h"
 #include "widgets/widget.h"
+#include <stdint.h>
+
+#define CANVAS_DOWNSAMPLE_SIZE 28
 
 typedef struct
 {
@@ -17,16 +22,47 @@ typedef struct
     int dirty_width;
     int dirty_height;
     int has_dirty_rect;
+    uint16_t cell_ink[CANVAS_DOWNSAMPLE_SIZE * CANVAS_DOWNSAMPLE_SIZE];
+    unsigned int ink_count;
+    int ink_min_x;
+    int ink_min_y;
+    int ink_max_x;
+    int ink_max_y;
+    bool ink_bounds_stale;
+    unsigned int version;
+    StrokeLog *stroke_log;
+    CanvasHistory *history;
+    bool full_redraw;
+    // Between canvas_begin_stroke and canvas_end_stroke; stroke_open is cleared while the pointer is off the canvas
+    bool stroke_active;
+    bool stroke_open;
+    int stroke_x;
+    int stroke_y;
 } CanvasData;
 
 Widget *canvas_create(int x, int y, int width, int height);
 
 void canvas_set_brush_size(Widget *canvas, int size);
+int canvas_get_brush_size(Widget *canvas);
 void canvas_set_brush_color(Widget *canvas, Color color);
 void canvas_set_background_color(Widget *canvas, Color color);
 void canvas_set_border(Widget *canvas, Color color, int thickness);
 
 void canvas_draw_at(Widget *canvas, int x, int y);
+void canvas_draw_line(Widget *canvas, int x0, int y0, int x1, int y1);
 void canvas_clear(Widget *canvas);
 
+void canvas_begin_stroke(Widget *canvas, int x, int y);
+void canvas_end_stroke(Widget *canvas);
+void canvas_set_stroke_log(Widget *canvas, StrokeLog *log);
+void canvas_replay_stroke_log(Widget *canvas, const StrokeLog *log);
+
+bool canvas_set_history(Widget *canvas, CanvasHistory *history);
+bool canvas_undo(Widget *canvas);
+bool canvas_redo(Widget *canvas);
+
+void canvas_get_downsample(Widget *canvas, uint8_t *output_buffer);
+unsigned int canvas_get_version(Widget *canvas);
+bool canvas_get_ink_bounds(Widget *canvas, int *x, int *y, int *width, int *height);
+
 #endif
@@ -37,14 +37,29 @@ typedef struct
     Alignment justify;
     int grid_columns;
     AnimationType animation;
-    float animation_phase;
+    // Millidegrees; the speed is in degrees per second, so each millisecond adds the speed
+    int32_t animation_phase;
     int animation_speed;
+    bool bounds_valid;
+    int bounds_x;
+    int bounds_y;
+    int bounds_width;
+    int bounds_height;
+    int update_depth;
+    bool measure_valid;
+    int measured_width;
+    int measured_height;
+    int *sizes;
 } ContainerData;
 
+extern const WidgetVTable container_vtable;
+
 Widget *container_create(int x, int y, int width, int height, LayoutType layout_type);
 
 void container_add_child(Widget *container, Widget *child);
 void container_remove_child(Widget *container, Widget *child);
+// Takes a child out without destroying it, leaving its pixels on screen; it can be added again later
+bool container_detach_child(Widget *container, Widget *child);
 void container_clear_children(Widget *container);
 
 void container_set_spacing(Widget *container, int spacing);
@@ -55,9 +70,14 @@ void container_set_grid_columns(Widget *container, int columns);
 
 void container_set_animation(Widget *container, AnimationType animation);
 void container_set_animation_speed(Widget *container, int speed);
-void container_update_animation(Widget *container, float delta_time);
+void container_update_animation(Widget *container, int delta_ms);
 
 void container_update_layout(Widget *container);
+void container_begin_update(Widget *container);
+void container_end_update(Widget *container);
+
+void container_measure(Widget *container, int *width, int *height);
+void container_get_bounds(Widget *container, int *x, int *y, int *width, int *height);
 
 int container_get_child_count(Widget *container);
 Widget *container_get_child(Widget *container, int index);
@@ -11,6 +11,8 @@ typedef struct
     int border_thickness;
 } ImageWidgetData;
 
+extern const WidgetVTable image_widget_vtable;
+
 Widget *image_widget_create(int x, int y, const Image *image);
 void image_widget_set_border(Widget *image_widget, Color color, int thickness);
 
@@ -4,18 +4,23 @@
 #include "color.h"
 #include "font_types.h"
 #include "widgets/widget.h"
+#include "widgets/widget_text.h"
 
 typedef struct
 {
-    char *text;
+    WidgetText text;
     Color text_color;
     const bdf_font_t *font;
 } LabelData;
 
+extern const WidgetVTable label_vtable;
+
 Widget *label_create(int x, int y, const char *text);
 Widget *label_create_auto(int x, int y, const char *text, const bdf_font_t *font);
+Widget *label_create_buffered(int x, int y, const char *text, int capacity);
 
 void label_set_text(Widget *label, const char *text);
+void label_set_static_text(Widget *label, const char *text);
 void label_set_color(Widget *label, Color color);
 void label_set_font(Widget *label, const bdf_font_t *font);
 
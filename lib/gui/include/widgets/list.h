@@ -0,0 +1,42 @@
+#ifndef LIST_H_INCLUDED
+#define LIST_H_INCLUDED
+
+#include "widgets/widget.h"
+
+typedef Widget *(*ListRowFactory)(void *user_data);
+typedef void (*ListBindCallback)(Widget *row, int index, void *user_data);
+
+// Only enough rows to fill the visible window are ever created. Item i is always shown by row i % row_count,
+// so scrolling rebinds a row only when a new item takes it over.
+typedef struct
+{
+    ListRowFactory create_row;
+    ListBindCallback bind_row;
+    void *user_data;
+    int item_count;
+    int row_height;
+    int scroll_offset;
+    // Scroll offset of the pixels currently on screen
+    int drawn_offset;
+    bool full_redraw;
+    Widget **rows;
+    int *row_items;
+    int row_count;
+} ListData;
+
+Widget *list_create(int x, int y, int width, int height, int row_height, ListRowFactory create_row,
+                    ListBindCallback bind_row, void *user_data);
+
+void list_set_item_count(Widget *list, int count);
+// Binds the visible rows again after the items behind them changed
+void list_refresh(Widget *list);
+
+void list_scroll_to(Widget *list, int offset);
+void list_scroll_by(Widget *list, int delta);
+int list_get_scroll_offset(Widget *list);
+int list_get_max_scroll(Widget *list);
+
+// Takes screen coordinates; returns -1 when no item is there
+int list_item_at(Widget *list, int x, int y);
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef PARAGRAPH_H_INCLUDED
+#define PARAGRAPH_H_INCLUDED
+
+#include "color.h"
+#include "font_types.h"
+#include "widgets/widget.h"
+#include "widgets/widget_text.h"
+
+// Lines store their offsets in 16 bits, so longer text is refused
+#define PARAGRAPH_MAX_TEXT_LENGTH UINT16_MAX
+
+typedef struct
+{
+    uint16_t start;
+    uint16_t length;
+    int16_t width;
+    // Hash of the line's characters, compared after a text change to find the lines that look different
+    uint32_t hash;
+} ParagraphLine;
+
+// Multi-line text wrapped at word boundaries to the widget's width. The line breaks are kept until the text,
+// font or width changes, and a text change repaints only the lines that differ from what is on screen.
+typedef struct
+{
+    WidgetText text;
+    Color text_color;
+    const bdf_font_t *font;
+    ParagraphLine *lines;
+    int line_count;
+    int line_capacity;
+    int line_height;
+    // Width the lines were broken for, or -1 when they have to be broken again
+    int wrap_width;
+    // Lines [changed_first, changed_end) are repainted when partial_redraw is set, otherwise the whole widget
+    int changed_first;
+    int changed_end;
+    bool partial_redraw;
+} ParagraphData;
+
+Widget *paragraph_create(int x, int y, int width, int height, const char *text, const bdf_font_t *font);
+
+void paragraph_set_text(Widget *paragraph, const char *text);
+void paragraph_set_static_text(Widget *paragraph, const char *text);
+void paragraph_set_color(Widget *paragraph, Color color);
+void paragraph_set_font(Widget *paragraph, const bdf_font_t *font);
+
+// Grows or shrinks the height to fit every line at the current width
+void paragraph_fit_height(Widget *paragraph);
+
+const char *paragraph_get_text(Widget *paragraph);
+int paragraph_get_line_count(Widget *paragraph);
+
+#endif
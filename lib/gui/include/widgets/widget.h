@@ -3,6 +3,8 @@
 
 #include "framebuffer.h"
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 
 struct Widget;
 
@@ -14,55 +16,104 @@ typedef enum
     WIDGET_TYPE_CONTAINER,
     WIDGET_TYPE_PARAGRAPH,
     WIDGET_TYPE_IMAGE,
+    WIDGET_TYPE_LIST,
 } WidgetType;
 
 typedef void (*WidgetClickCallback)(struct Widget *widget, void *user_data);
 typedef void (*WidgetRenderCallback)(struct Widget *widget, Framebuffer *framebuffer);
 typedef void (*WidgetDestroyCallback)(struct Widget *widget);
 typedef void (*WidgetDirtyCallback)(struct Widget *widget, Framebuffer *framebuffer);
+typedef void (*WidgetExposeCallback)(struct Widget *widget);
 
-typedef struct Widget
+// Size a widget asks its container for. A preferred size of 0 means fill the available space. Free space along
+// a box layout's axis is shared by flex weight; a child with no weight and a preferred size of 0 counts as
+// weight 1. A max of 0 means unbounded.
+typedef struct
 {
-    WidgetType type;
-
-    int x;
-    int y;
-    int width;
-    int height;
-
-    bool visible;
-    bool enabled;
-
-    bool dirty;
-    int prev_x;
-    int prev_y;
-    int prev_width;
-    int prev_height;
+    int16_t preferred_width;
+    int16_t preferred_height;
+    int16_t min_width;
+    int16_t min_height;
+    int16_t max_width;
+    int16_t max_height;
+    int16_t flex;
+} WidgetLayout;
+
+// Behaviour shared by every widget of a type; each type keeps one static instance
+typedef struct
+{
+    WidgetRenderCallback render;
     WidgetDirtyCallback on_dirty;
+    // The area under the widget was cleared, so a widget that repaints only what changed must draw all of it
+    WidgetExposeCallback on_expose;
+    WidgetDestroyCallback destroy;
+} WidgetVTable;
 
+// Kept to one cache line. Type-specific data is allocated inline, directly after the widget.
+typedef struct Widget
+{
+    uint8_t type;
+    bool visible : 1;
+    bool enabled : 1;
+    bool dirty : 1;
+    bool needs_layout : 1;
+    bool has_data : 1;
+    // Paints every pixel of its rect, so siblings drawn before it and fully beneath it can be skipped
+    bool opaque : 1;
+    // Drawn from a surface in the active render cache until its content changes
+    bool cached : 1;
+    // Lives in static storage, such as a generated layout, so the tree never frees it or grows its arrays
+    bool preallocated : 1;
+
+    // Relative to the parent; the screen position is only resolved while traversing the tree
+    int16_t x;
+    int16_t y;
+    int16_t width;
+    int16_t height;
+    // Screen geometry at the last render
+    int16_t prev_x;
+    int16_t prev_y;
+    int16_t prev_width;
+    int16_t prev_height;
+    WidgetLayout layout;
+
+    const WidgetVTable *vtable;
     struct Widget *parent;
 
     WidgetClickCallback on_click;
-    WidgetRenderCallback render;
-    WidgetDestroyCallback destroy;
-
     void *user_data;
-
-    void *data;
 } Widget;
 
+_Static_assert(sizeof(Widget) <= 64, "Widget should fit in one cache line");
+
+Widget *widget_create(WidgetType type, const WidgetVTable *vtable, size_t data_size, int x, int y, int width,
+                      int height);
 void widget_init(Widget *widget, WidgetType type, int x, int y, int width, int height);
 void widget_destroy(Widget *widget);
+void *widget_data(Widget *widget);
 
 void widget_render(Widget *widget, Framebuffer *framebuffer);
 void widget_set_position(Widget *widget, int x, int y);
 void widget_set_size(Widget *widget, int width, int height);
 void widget_set_visible(Widget *widget, bool visible);
 void widget_set_enabled(Widget *widget, bool enabled);
+void widget_set_opaque(Widget *widget, bool opaque);
+void widget_set_cached(Widget *widget, bool cached);
 void widget_mark_dirty(Widget *widget);
+// Flags the widget and every descendant for drawing in full; ancestors are left to widget_mark_dirty
+void widget_mark_subtree_dirty(Widget *widget);
+void widget_mark_layout_dirty(Widget *widget);
 void widget_handle_dirty(Widget *widget, Framebuffer *framebuffer);
 
+void widget_set_flex(Widget *widget, int flex);
+void widget_set_size_limits(Widget *widget, int min_width, int min_height, int max_width, int max_height);
+void widget_measure(Widget *widget, int *width, int *height);
+void widget_invalidate_measure(Widget *widget);
+
+void widget_get_screen_position(Widget *widget, int *x, int *y);
 bool widget_contains_point(Widget *widget, int x, int y);
+Widget *widget_hit_test(Widget *widget, int x, int y);
 void widget_handle_click(Widget *widget, int x, int y);
+void widget_invalidate_bounds(Widget *widget);
 
 #endif
@@ -0,0 +1,23 @@
+#ifndef WIDGET_TEXT_H_INCLUDED
+#define WIDGET_TEXT_H_INCLUDED
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Text shown by a label or button: a heap copy, a string borrowed from the caller, or a copy in a fixed buffer
+// reserved inline with the widget. Borrowed strings must outlive the widget. Only the heap copy allocates, and
+// only when the widget has no buffer of its own.
+typedef struct
+{
+    const char *value;
+    char *buffer;
+    uint16_t capacity;
+    bool owned;
+} WidgetText;
+
+void widget_text_init(WidgetText *text, char *buffer, int capacity);
+bool widget_text_set(WidgetText *text, const char *value);
+bool widget_text_borrow(WidgetText *text, const char *value);
+void widget_text_release(WidgetText *text);
+
+#endif
@@ -0,0 +1,182 @@
+#include "canvas_history.h"
+#include <stddef.h>
+#include <string.h>
+
+static CanvasHistoryEntry *entry_at(CanvasHistory *history, int index);
+static void drop_oldest(CanvasHistory *history);
+
+void canvas_history_init(CanvasHistory *history, CanvasTileBlock *blocks, int block_capacity)
+{
+    if (!history)
+        return;
+
+    history->blocks = blocks;
+    history->block_capacity = blocks ? block_capacity : 0;
+    canvas_history_reset(history);
+}
+
+void canvas_history_reset(CanvasHistory *history)
+{
+    if (!history)
+        return;
+
+    history->block_start = 0;
+    history->block_used = 0;
+    history->entry_start = 0;
+    history->entry_count = 0;
+    history->undo_count = 0;
+    history->in_stroke = false;
+    history->recording = false;
+    memset(history->saved_tiles, 0, sizeof(history->saved_tiles));
+}
+
+void canvas_history_begin_stroke(CanvasHistory *history, int log_length, int log_x, int log_y)
+{
+    if (!history || history->block_capacity <= 0)
+        return;
+
+    if (history->in_stroke)
+    {
+        canvas_history_end_stroke(history, log_length, log_x, log_y);
+    }
+
+    // A new stroke makes the redo entries unreachable; they are the newest, so their blocks are at the end.
+    while (history->entry_count > history->undo_count)
+    {
+        history->block_used -= entry_at(history, history->entry_count - 1)->block_count;
+        history->entry_count--;
+    }
+
+    if (history->entry_count == CANVAS_HISTORY_MAX_STROKES)
+    {
+        drop_oldest(history);
+    }
+
+    CanvasHistoryEntry *entry = entry_at(history, history->entry_count);
+    entry->first_block = (history->block_start + history->block_used) % history->block_capacity;
+    entry->block_count = 0;
+    entry->log_start = log_length;
+    entry->log_end = log_length;
+    entry->log_start_x = log_x;
+    entry->log_start_y = log_y;
+    entry->log_end_x = log_x;
+    entry->log_end_y = log_y;
+
+    history->entry_count++;
+    history->undo_count = history->entry_count;
+    history->in_stroke = true;
+    history->recording = true;
+    memset(history->saved_tiles, 0, sizeof(history->saved_tiles));
+}
+
+void canvas_history_end_stroke(CanvasHistory *history, int log_length, int log_x, int log_y)
+{
+    if (!history || !history->in_stroke)
+        return;
+
+    history->in_stroke = false;
+
+    if (!history->recording)
+        return;
+
+    CanvasHistoryEntry *entry = entry_at(history, history->entry_count - 1);
+    if (entry->block_count == 0)
+    {
+        history->entry_count--;
+        history->undo_count = history->entry_count;
+        return;
+    }
+
+    entry->log_end = log_length;
+    entry->log_end_x = log_x;
+    entry->log_end_y = log_y;
+}
+
+CanvasTileBlock *canvas_history_save_tile(CanvasHistory *history, int tile)
+{
+    if (!history || !history->in_stroke || !history->recording)
+        return NULL;
+
+    if (tile < 0 || tile >= CANVAS_HISTORY_MAX_TILES)
+        return NULL;
+
+    uint8_t mask = (uint8_t)(1u << (tile & 7));
+    if (history->saved_tiles[tile >> 3] & mask)
+        return NULL;
+
+    if (history->block_used == history->block_capacity)
+    {
+        if (history->entry_count <= 1)
+        {
+            // The stroke alone is larger than the ring and cannot be undone; forget the whole history.
+            canvas_history_reset(history);
+            history->in_stroke = true;
+            return NULL;
+        }
+
+        drop_oldest(history);
+    }
+
+    CanvasHistoryEntry *entry = entry_at(history, history->entry_count - 1);
+    CanvasTileBlock *block = &history->blocks[(entry->first_block + entry->block_count) % history->block_capacity];
+
+    entry->block_count++;
+    history->block_used++;
+    history->saved_tiles[tile >> 3] |= mask;
+
+    block->tile = (uint16_t)tile;
+    return block;
+}
+
+CanvasHistoryEntry *canvas_history_undo(CanvasHistory *history)
+{
+    if (!canvas_history_can_undo(history))
+        return NULL;
+
+    history->undo_count--;
+    return entry_at(history, history->undo_count);
+}
+
+CanvasHistoryEntry *canvas_history_redo(CanvasHistory *history)
+{
+    if (!canvas_history_can_redo(history))
+        return NULL;
+
+    history->undo_count++;
+    return entry_at(history, history->undo_count - 1);
+}
+
+CanvasTileBlock *canvas_history_block(CanvasHistory *history, const CanvasHistoryEntry *entry, int index)
+{
+    if (!history || !entry || index < 0 || index >= entry->block_count)
+        return NULL;
+
+    return &history->blocks[(entry->first_block + index) % history->block_capacity];
+}
+
+bool canvas_history_can_undo(const CanvasHistory *history)
+{
+    return history && !history->in_stroke && history->undo_count > 0;
+}
+
+bool canvas_history_can_redo(const CanvasHistory *history)
+{
+    return history && !history->in_stroke && history->undo_count < history->entry_count;
+}
+
+static CanvasHistoryEntry *entry_at(CanvasHistory *history, int index)
+{
+    return &history->entries[(history->entry_start + index) % CANVAS_HISTORY_MAX_STROKES];
+}
+
+static void drop_oldest(CanvasHistory *history)
+{
+    CanvasHistoryEntry *oldest = entry_at(history, 0);
+
+    history->block_start = (history->block_start + oldest->block_count) % history->block_capacity;
+    history->block_used -= oldest->block_count;
+    history->entry_start = (history->entry_start + 1) % CANVAS_HISTORY_MAX_STROKES;
+    history->entry_count--;
+    if (history->undo_count > 0)
+        history->undo_count--;
+}
@@ -0,0 +1,95 @@
+#include "fixed.h"
+
+#define QUARTER_SEGMENTS 64
+
+// First quarter of a sine wave, sampled every 256 angle units
+static const q15_t quarter_sine[QUARTER_SEGMENTS + 1] = {
+    0,     804,   1608,  2410,  3212,  4011,  4808,  5602,  6393,  7179,  7962,  8739,  9512,
+    10278, 11039, 11793, 12539, 13279, 14010, 14732, 15446, 16151, 16846, 17530, 18204, 18868,
+    19519, 20159, 20787, 21403, 22005, 22594, 23170, 23731, 24279, 24811, 25329, 25832, 26319,
+    26790, 27245, 27683, 28105, 28510, 28898, 29268, 29621, 29956, 30273, 30571, 30852, 31113,
+    31356, 31580, 31785, 31971, 32137, 32285, 32412, 32521, 32609, 32678, 32728, 32757, 32767};
+
+q16_t q16_mul(q16_t a, q16_t b)
+{
+    return (q16_t)(((int64_t)a * b + Q16_ONE / 2) >> 16);
+}
+
+q16_t q16_div(q16_t a, q16_t b)
+{
+    if (b == 0)
+        return a >= 0 ? INT32_MAX : INT32_MIN;
+
+    return (q16_t)(((int64_t)a * Q16_ONE) / b);
+}
+
+q16_t q16_lerp(q16_t from, q16_t to, q16_t t)
+{
+    return from + q16_mul(to - from, t);
+}
+
+// Bit-by-bit square root of x << 16, which is the Q16 root of x
+q16_t q16_sqrt(q16_t x)
+{
+    if (x <= 0)
+        return 0;
+
+    uint64_t value = (uint64_t)x << 16;
+    uint64_t root = 0;
+    uint64_t bit = (uint64_t)1 << 62;
+
+    while (bit > value)
+        bit >>= 2;
+
+    while (bit != 0)
+    {
+        if (value >= root + bit)
+        {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else
+        {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    return (q16_t)root;
+}
+
+q16_t q16_sin(uint16_t angle)
+{
+    return Q16_FROM_Q15(q15_sin(angle));
+}
+
+q16_t q16_cos(uint16_t angle)
+{
+    return Q16_FROM_Q15(q15_cos(angle));
+}
+
+q15_t q15_mul(q15_t a, q15_t b)
+{
+    return (q15_t)(((int32_t)a * b + (1 << 14)) >> 15);
+}
+
+// The quarter table is mirrored for the second quarter and negated for the second half
+q15_t q15_sin(uint16_t angle)
+{
+    uint16_t quarter_angle = angle & 0x3FFF;
+    if (angle & 0x4000)
+        quarter_angle = 0x4000 - quarter_angle;
+
+    int segment = quarter_angle >> 8;
+    int fraction = quarter_angle & 0xFF;
+    int32_t value = quarter_sine[segment];
+    if (segment < QUARTER_SEGMENTS)
+        value += ((quarter_sine[segment + 1] - value) * fraction) >> 8;
+
+    return (q15_t)(angle & 0x8000 ? -value : value);
+}
+
+q15_t q15_cos(uint16_t angle)
+{
+    return q15_sin((uint16_t)(angle + 0x4000));
+}
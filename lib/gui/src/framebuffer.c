@@ -1,7 +1,9 @@
 #include "framebuffer.h"
+#include <string.h>
 
 void framebuffer_clear(Framebuffer *framebuffer, Color clear_color)
 {
+    framebuffer->background = clear_color;
     for (int i = 0; i < FRAMEBUFFER_WIDTH(framebuffer) * FRAMEBUFFER_HEIGHT(framebuffer); i++)
     {
         framebuffer->pixels[i] = clear_color;
@@ -10,6 +12,7 @@ void framebuffer_clear(Framebuffer *framebuffer, Color clear_color)
 
 void framebuffer_clear_dirty_rects(Framebuffer *framebuffer, Color clear_color)
 {
+    framebuffer->background = clear_color;
     for (int i = 0; i < framebuffer->dirty_rect_count; i++)
     {
         DirtyRect rect = framebuffer->dirty_rects[i];
@@ -26,3 +29,42 @@ void framebuffer_clear_dirty_rects(Framebuffer *framebuffer, Color clear_color)
 
     framebuffer->dirty_rect_count = 0;
 }
+
+Framebuffer framebuffer_view(const Framebuffer *framebuffer, int x, int y, int width, int height)
+{
+    int left = x < 0 ? 0 : x;
+    int top = y < 0 ? 0 : y;
+    int right = x + width > FRAMEBUFFER_WIDTH(framebuffer) ? FRAMEBUFFER_WIDTH(framebuffer) : x + width;
+    int bottom = y + height > FRAMEBUFFER_HEIGHT(framebuffer) ? FRAMEBUFFER_HEIGHT(framebuffer) : y + height;
+
+    Framebuffer view = {0};
+    view.background = framebuffer->background;
+    if (right <= left || bottom <= top)
+        return view;
+
+    view.pixels = &FRAMEBUFFER_GET_PIXEL(framebuffer, left, top);
+    view.width = right - left;
+    view.height = bottom - top;
+    view.stride = FRAMEBUFFER_STRIDE(framebuffer);
+    view.origin_x = -left;
+    view.origin_y = -top;
+
+    return view;
+}
+
+void framebuffer_scroll(Framebuffer *framebuffer, int x, int y, int width, int height, int dy)
+{
+    if (dy == 0 || dy >= height || -dy >= height || width <= 0)
+        return;
+
+    int rows = height - (dy > 0 ? dy : -dy);
+    for (int i = 0; i < rows; i++)
+    {
+        // Rows are copied in the direction that never reads a row already overwritten
+        int row = dy > 0 ? i : rows - 1 - i;
+        int to = dy > 0 ? y + row : y + row - dy;
+        int from = to + dy;
+        memcpy(&FRAMEBUFFER_GET_PIXEL(framebuffer, x, to), &FRAMEBUFFER_GET_PIXEL(framebuffer, x, from),
+               width * sizeof(Color));
+    }
+}
@@ -0,0 +1,256 @@
+#include "gui_arena.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Precedes every block so a pointer can be returned to its pool without the caller knowing its size
+typedef struct
+{
+    uint32_t pool;
+    uint32_t size;
+} BlockHeader;
+
+_Static_assert(sizeof(BlockHeader) % GUI_ARENA_ALIGN == 0, "block header must keep payloads aligned");
+
+static GuiArena *g_active_arena = NULL;
+
+static size_t size_class(size_t size);
+static int find_pool(GuiArena *arena, size_t block_size);
+
+void gui_arena_init(GuiArena *arena, void *buffer, size_t capacity)
+{
+    if (!arena)
+        return;
+
+    memset(arena, 0, sizeof(GuiArena));
+
+    if (!buffer)
+        return;
+
+    uintptr_t start = (uintptr_t)buffer;
+    uintptr_t aligned = (start + GUI_ARENA_ALIGN - 1) & ~(uintptr_t)(GUI_ARENA_ALIGN - 1);
+    if (aligned - start >= capacity)
+        return;
+
+    arena->buffer = (uint8_t *)aligned;
+    arena->capacity = capacity - (aligned - start);
+}
+
+// Releases every block at once; the peaks are kept so a buffer can be sized from a full session
+void gui_arena_reset(GuiArena *arena)
+{
+    if (!arena)
+        return;
+
+    arena->used = 0;
+    arena->live_bytes = 0;
+    arena->pool_count = 0;
+    memset(arena->pools, 0, sizeof(arena->pools));
+}
+
+void *gui_arena_alloc(GuiArena *arena, size_t size)
+{
+    if (!arena || !arena->buffer || size == 0)
+        return NULL;
+
+    size_t block_size = size_class(size);
+    int index = find_pool(arena, block_size);
+    if (index < 0)
+    {
+        arena->failed_allocations++;
+        return NULL;
+    }
+
+    GuiArenaPool *pool = &arena->pools[index];
+    BlockHeader *header;
+
+    if (pool->free_list)
+    {
+        void *block = pool->free_list;
+        pool->free_list = *(void **)block;
+        header = (BlockHeader *)block - 1;
+    }
+    else
+    {
+        size_t needed = sizeof(BlockHeader) + block_size;
+        if (arena->capacity - arena->used < needed)
+        {
+            arena->failed_allocations++;
+            return NULL;
+        }
+
+        header = (BlockHeader *)(arena->buffer + arena->used);
+        header->pool = (uint32_t)index;
+        arena->used += needed;
+        if (arena->used > arena->peak_used)
+            arena->peak_used = arena->used;
+        pool->blocks++;
+    }
+
+    header->size = (uint32_t)size;
+    arena->allocations++;
+    pool->in_use++;
+    if (pool->in_use > pool->peak_in_use)
+        pool->peak_in_use = pool->in_use;
+
+    arena->live_bytes += size;
+    if (arena->live_bytes > arena->peak_live_bytes)
+        arena->peak_live_bytes = arena->live_bytes;
+
+    return header + 1;
+}
+
+void gui_arena_free(GuiArena *arena, void *ptr)
+{
+    if (!gui_arena_owns(arena, ptr))
+        return;
+
+    BlockHeader *header = (BlockHeader *)ptr - 1;
+    GuiArenaPool *pool = &arena->pools[header->pool];
+
+    arena->live_bytes -= header->size;
+    header->size = 0;
+    pool->in_use--;
+
+    *(void **)ptr = pool->free_list;
+    pool->free_list = ptr;
+}
+
+bool gui_arena_owns(const GuiArena *arena, const void *ptr)
+{
+    if (!arena || !arena->buffer || !ptr)
+        return false;
+
+    const uint8_t *byte = (const uint8_t *)ptr;
+    return byte >= arena->buffer + sizeof(BlockHeader) && byte < arena->buffer + arena->used;
+}
+
+void gui_arena_get_stats(const GuiArena *arena, GuiArenaStats *stats)
+{
+    if (!arena || !stats)
+        return;
+
+    memset(stats, 0, sizeof(GuiArenaStats));
+    stats->capacity = arena->capacity;
+    stats->used = arena->used;
+    stats->peak_used = arena->peak_used;
+    stats->live_bytes = arena->live_bytes;
+    stats->peak_live_bytes = arena->peak_live_bytes;
+    stats->allocations = arena->allocations;
+    stats->failed_allocations = arena->failed_allocations;
+    stats->pool_count = arena->pool_count;
+
+    for (int i = 0; i < arena->pool_count; i++)
+    {
+        const GuiArenaPool *pool = &arena->pools[i];
+        stats->live_blocks += pool->in_use;
+        stats->free_bytes += (size_t)(pool->blocks - pool->in_use) * (sizeof(BlockHeader) + pool->block_size);
+    }
+
+    if (arena->used > 0)
+        stats->fragmentation_percent = (int)((arena->used - arena->live_bytes) * 100 / arena->used);
+}
+
+void gui_set_arena(GuiArena *arena)
+{
+    g_active_arena = arena;
+}
+
+GuiArena *gui_get_arena(void)
+{
+    return g_active_arena;
+}
+
+void *gui_alloc(size_t size)
+{
+    if (g_active_arena)
+        return gui_arena_alloc(g_active_arena, size);
+
+#ifdef GUI_NO_HEAP
+    return NULL;
+#else
+    return malloc(size);
+#endif
+}
+
+void *gui_realloc(void *ptr, size_t size)
+{
+    if (!ptr)
+        return gui_alloc(size);
+
+    if (gui_arena_owns(g_active_arena, ptr))
+    {
+        void *block = gui_arena_alloc(g_active_arena, size);
+        if (!block)
+            return NULL;
+
+        size_t old_size = ((BlockHeader *)ptr - 1)->size;
+        memcpy(block, ptr, old_size < size ? old_size : size);
+        gui_arena_free(g_active_arena, ptr);
+        return block;
+    }
+
+#ifdef GUI_NO_HEAP
+    return NULL;
+#else
+    return realloc(ptr, size);
+#endif
+}
+
+void gui_free(void *ptr)
+{
+    if (!ptr)
+        return;
+
+    if (gui_arena_owns(g_active_arena, ptr))
+    {
+        gui_arena_free(g_active_arena, ptr);
+        return;
+    }
+
+#ifndef GUI_NO_HEAP
+    free(ptr);
+#endif
+}
+
+char *gui_strdup(const char *text)
+{
+    if (!text)
+        return NULL;
+
+    size_t length = strlen(text) + 1;
+    char *copy = (char *)gui_alloc(length);
+    if (copy)
+        memcpy(copy, text, length);
+
+    return copy;
+}
+
+static size_t size_class(size_t size)
+{
+    if (size <= GUI_ARENA_SMALL_LIMIT)
+    {
+        size_t block_size = GUI_ARENA_ALIGN * 2;
+        while (block_size < size)
+            block_size <<= 1;
+        return block_size;
+    }
+
+    return (size + GUI_ARENA_ALIGN - 1) & ~(size_t)(GUI_ARENA_ALIGN - 1);
+}
+
+static int find_pool(GuiArena *arena, size_t block_size)
+{
+    for (int i = 0; i < arena->pool_count; i++)
+    {
+        if (arena->pools[i].block_size == block_size)
+            return i;
+    }
+
+    if (arena->pool_count >= GUI_ARENA_MAX_POOLS)
+        return -1;
+
+    GuiArenaPool *pool = &arena->pools[arena->pool_count];
+    memset(pool, 0, sizeof(GuiArenaPool));
+    pool->block_size = block_size;
+    return arena->pool_count++;
+}
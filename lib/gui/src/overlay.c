@@ -0,0 +1,170 @@
+#include "overlay.h"
+#include <string.h>
+
+static void restore_under(Overlay *overlay, Framebuffer *framebuffer);
+static void save_under(Overlay *overlay, Framebuffer *framebuffer);
+
+void overlay_init(Overlay *overlay, Color *save_buffer, int width, int height, OverlayDrawCallback draw,
+                  void *user_data)
+{
+    if (!overlay)
+        return;
+
+    memset(overlay, 0, sizeof(Overlay));
+    overlay->saved = save_buffer;
+    overlay->width = save_buffer && width > 0 ? width : 0;
+    overlay->height = save_buffer && height > 0 ? height : 0;
+    overlay->draw = draw;
+    overlay->user_data = user_data;
+}
+
+void overlay_move(Overlay *overlay, int x, int y)
+{
+    if (!overlay || (overlay->x == x && overlay->y == y))
+        return;
+
+    overlay->x = x;
+    overlay->y = y;
+    overlay->changed = overlay->visible || overlay->on_screen;
+}
+
+void overlay_set_visible(Overlay *overlay, bool visible)
+{
+    if (!overlay || overlay->visible == visible)
+        return;
+
+    overlay->visible = visible;
+    overlay->changed = true;
+}
+
+void overlay_invalidate(Overlay *overlay)
+{
+    if (overlay && overlay->visible)
+        overlay->changed = true;
+}
+
+void overlay_layer_init(OverlayLayer *layer)
+{
+    if (layer)
+        memset(layer, 0, sizeof(OverlayLayer));
+}
+
+bool overlay_layer_add(OverlayLayer *layer, Overlay *overlay)
+{
+    if (!layer || !overlay || layer->count >= MAX_OVERLAYS)
+        return false;
+
+    layer->overlays[layer->count++] = overlay;
+    overlay->on_screen = false;
+    overlay->changed = overlay->visible;
+    return true;
+}
+
+void overlay_layer_remove(OverlayLayer *layer, Overlay *overlay, Framebuffer *framebuffer)
+{
+    if (!layer || !overlay)
+        return;
+
+    for (int i = 0; i < layer->count; i++)
+    {
+        if (layer->overlays[i] != overlay)
+            continue;
+
+        if (framebuffer)
+            overlay_layer_restore(layer, framebuffer);
+
+        memmove(&layer->overlays[i], &layer->overlays[i + 1], sizeof(Overlay *) * (layer->count - i - 1));
+        layer->count--;
+        overlay->on_screen = false;
+        return;
+    }
+}
+
+bool overlay_layer_needs_update(const OverlayLayer *layer)
+{
+    if (!layer)
+        return false;
+
+    for (int i = 0; i < layer->count; i++)
+    {
+        const Overlay *overlay = layer->overlays[i];
+        if (overlay->changed || overlay->visible != overlay->on_screen)
+            return true;
+    }
+
+    return false;
+}
+
+// Overlays above may have saved pixels of the ones below, so the stack is unwound from the top
+void overlay_layer_restore(OverlayLayer *layer, Framebuffer *framebuffer)
+{
+    if (!layer || !framebuffer)
+        return;
+
+    for (int i = layer->count - 1; i >= 0; i--)
+        restore_under(layer->overlays[i], framebuffer);
+}
+
+void overlay_layer_draw(OverlayLayer *layer, Framebuffer *framebuffer)
+{
+    if (!layer || !framebuffer)
+        return;
+
+    for (int i = 0; i < layer->count; i++)
+    {
+        Overlay *overlay = layer->overlays[i];
+        overlay->changed = false;
+        if (!overlay->visible || overlay->on_screen)
+            continue;
+
+        save_under(overlay, framebuffer);
+        if (!overlay->on_screen || !overlay->draw)
+            continue;
+
+        Framebuffer view = framebuffer_view(framebuffer, overlay->x, overlay->y, overlay->width, overlay->height);
+        view.origin_x += overlay->x;
+        view.origin_y += overlay->y;
+        overlay->draw(overlay, &view);
+    }
+}
+
+static void restore_under(Overlay *overlay, Framebuffer *framebuffer)
+{
+    if (!overlay->on_screen)
+        return;
+
+    for (int row = 0; row < overlay->saved_height; row++)
+    {
+        memcpy(&FRAMEBUFFER_GET_PIXEL(framebuffer, overlay->saved_x, overlay->saved_y + row),
+               &overlay->saved[row * overlay->saved_width], sizeof(Color) * overlay->saved_width);
+    }
+
+    overlay->on_screen = false;
+}
+
+static void save_under(Overlay *overlay, Framebuffer *framebuffer)
+{
+    int left = overlay->x < 0 ? 0 : overlay->x;
+    int top = overlay->y < 0 ? 0 : overlay->y;
+    int right = overlay->x + overlay->width;
+    int bottom = overlay->y + overlay->height;
+    if (right > FRAMEBUFFER_WIDTH(framebuffer))
+        right = FRAMEBUFFER_WIDTH(framebuffer);
+    if (bottom > FRAMEBUFFER_HEIGHT(framebuffer))
+        bottom = FRAMEBUFFER_HEIGHT(framebuffer);
+    if (right <= left || bottom <= top)
+        return;
+
+    overlay->saved_x = left;
+    overlay->saved_y = top;
+    overlay->saved_width = right - left;
+    overlay->saved_height = bottom - top;
+
+    for (int row = 0; row < overlay->saved_height; row++)
+    {
+        memcpy(&overlay->saved[row * overlay->saved_width], &FRAMEBUFFER_GET_PIXEL(framebuffer, left, top + row),
+               sizeof(Color) * overlay->saved_width);
+    }
+
+    overlay->on_screen = true;
+}
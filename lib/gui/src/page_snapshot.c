@@ -0,0 +1,143 @@
+#include "page_snapshot.h"
+#include "widgets/container.h"
+#include <string.h>
+
+static bool inside(const Framebuffer *framebuffer, int x, int y, int width, int height);
+
+void page_snapshot_init(PageSnapshot *snapshot, void *buffer, size_t size)
+{
+    if (!snapshot)
+        return;
+
+    memset(snapshot, 0, sizeof(PageSnapshot));
+    snapshot->runs = (SnapshotRun *)buffer;
+    snapshot->capacity = buffer ? size / sizeof(SnapshotRun) : 0;
+}
+
+void page_snapshot_invalidate(PageSnapshot *snapshot)
+{
+    if (!snapshot)
+        return;
+
+    snapshot->valid = false;
+    snapshot->run_count = 0;
+}
+
+bool page_snapshot_capture(PageSnapshot *snapshot, const Framebuffer *framebuffer, int x, int y, int width,
+                           int height)
+{
+    page_snapshot_invalidate(snapshot);
+    if (!snapshot || !framebuffer || !inside(framebuffer, x, y, width, height))
+        return false;
+
+    SnapshotRun *run = NULL;
+    size_t count = 0;
+    for (int row = 0; row < height; row++)
+    {
+        const Color *pixels = &FRAMEBUFFER_GET_PIXEL(framebuffer, x, y + row);
+        for (int col = 0; col < width; col++)
+        {
+            if (run && run->length < UINT16_MAX && COLOR_COMPARE(run->color, pixels[col]))
+            {
+                run->length++;
+                continue;
+            }
+
+            if (count == snapshot->capacity)
+                return false;
+
+            run = &snapshot->runs[count++];
+            run->length = 1;
+            run->color = pixels[col];
+        }
+    }
+
+    snapshot->run_count = count;
+    snapshot->x = x;
+    snapshot->y = y;
+    snapshot->width = width;
+    snapshot->height = height;
+    snapshot->valid = true;
+    return true;
+}
+
+bool page_snapshot_restore(const PageSnapshot *snapshot, Framebuffer *framebuffer)
+{
+    if (!snapshot || !snapshot->valid || !framebuffer ||
+        !inside(framebuffer, snapshot->x, snapshot->y, snapshot->width, snapshot->height))
+        return false;
+
+    int row = 0;
+    int col = 0;
+    Color *pixels = &FRAMEBUFFER_GET_PIXEL(framebuffer, snapshot->x, snapshot->y);
+    for (size_t i = 0; i < snapshot->run_count && row < snapshot->height; i++)
+    {
+        int remaining = snapshot->runs[i].length;
+        while (remaining > 0 && row < snapshot->height)
+        {
+            int span = snapshot->width - col < remaining ? snapshot->width - col : remaining;
+            for (int n = 0; n < span; n++)
+                pixels[col + n] = snapshot->runs[i].color;
+
+            remaining -= span;
+            col += span;
+            if (col == snapshot->width)
+            {
+                col = 0;
+                row++;
+                pixels += FRAMEBUFFER_STRIDE(framebuffer);
+            }
+        }
+    }
+
+    return true;
+}
+
+void page_suspend(Widget *page, PageSnapshot *snapshot, const Framebuffer *framebuffer)
+{
+    if (!page)
+        return;
+
+    // A page that has never been drawn has nothing on screen worth keeping
+    int x = 0;
+    int y = 0;
+    widget_get_screen_position(page, &x, &y);
+    if (page->parent && page->visible && page->prev_width > 0)
+        page_snapshot_capture(snapshot, framebuffer, x, y, page->width, page->height);
+    else
+        page_snapshot_invalidate(snapshot);
+
+    container_detach_child(page->parent, page);
+}
+
+bool page_resume(Widget *container, Widget *page, const PageSnapshot *snapshot, Framebuffer *framebuffer)
+{
+    if (!container || !page || !framebuffer || page->parent)
+        return false;
+
+    container_add_child(container, page);
+    if (page->parent != container)
+        return false;
+
+    int x = 0;
+    int y = 0;
+    widget_get_screen_position(page, &x, &y);
+    if (snapshot && snapshot->x == x && snapshot->y == y && snapshot->width == page->width &&
+        snapshot->height == page->height && page_snapshot_restore(snapshot, framebuffer))
+    {
+        widget_mark_dirty(page);
+        return true;
+    }
+
+    if (framebuffer->dirty_rect_count < MAX_DIRTY_RECTS)
+        framebuffer->dirty_rects[framebuffer->dirty_rect_count++] = (DirtyRect){x, y, page->width, page->height};
+    widget_mark_subtree_dirty(page);
+    widget_mark_dirty(page);
+    return false;
+}
+
+static bool inside(const Framebuffer *framebuffer, int x, int y, int width, int height)
+{
+    return width > 0 && height > 0 && x >= 0 && y >= 0 && x + width <= FRAMEBUFFER_WIDTH(framebuffer) &&
+           y + height <= FRAMEBUFFER_HEIGHT(framebuffer);
+}
@@ -27,7 +27,7 @@ void renderImage(int x, int y, const Image *image, Framebuffer *framebuffer)
             }
             else
             {
-                Color dst_color = framebuffer->pixels[pixel_y * framebuffer->width + pixel_x];
+                Color dst_color = FRAMEBUFFER_GET_PIXEL(framebuffer, pixel_x, pixel_y);
 
                 uint16_t alpha = src_color.a;
                 uint16_t inv_alpha = 255 - alpha;
@@ -1,4 +1,5 @@
 #include "primitives/text.h"
+#include <string.h>
 
 static const bdf_char_t *find_char(int encoding, const bdf_font_t *font)
 {
@@ -17,9 +18,18 @@ void renderText(const char *text, Color color, int x, int y, const bdf_font_t *f
     if (!text)
         return;
 
+    renderTextSpan(text, (int)strlen(text), color, x, y, font, framebuffer);
+}
+
+void renderTextSpan(const char *text, int length, Color color, int x, int y, const bdf_font_t *font,
+                    Framebuffer *framebuffer)
+{
+    if (!text || !font)
+        return;
+
     int x_pos = x;
 
-    for (int i = 0; text[i] != '\0'; i++)
+    for (int i = 0; i < length && text[i] != '\0'; i++)
     {
         const bdf_char_t *ch = find_char((int)text[i], font);
         if (!ch)
@@ -54,13 +64,21 @@ void renderText(const char *text, Color color, int x, int y, const bdf_font_t *f
 }
 
 int measureTextWidth(const char *text, const bdf_font_t *font)
+{
+    if (!text)
+        return 0;
+
+    return measureTextSpan(text, (int)strlen(text), font);
+}
+
+int measureTextSpan(const char *text, int length, const bdf_font_t *font)
 {
     if (!text || !font)
         return 0;
 
     int total_width = 0;
 
-    for (int i = 0; text[i] != '\0'; i++)
+    for (int i = 0; i < length && text[i] != '\0'; i++)
     {
         const bdf_char_t *ch = find_char((int)text[i], font);
         if (ch)
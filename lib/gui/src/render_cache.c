@@ -0,0 +1,203 @@
+#include "render_cache.h"
+#include <string.h>
+
+static RenderCache *g_active_cache = NULL;
+
+static RenderCacheEntry *find_entry(RenderCache *cache, Widget *widget);
+static void remove_entry(RenderCache *cache, RenderCacheEntry *entry);
+static RenderCacheEntry *add_entry(RenderCache *cache, Widget *widget, size_t size);
+static void capture(Widget *widget, RenderCacheEntry *entry, Color *pixels, Color background);
+static void blit(const RenderCacheEntry *entry, const Color *pixels, int x, int y, Framebuffer *framebuffer);
+
+void render_cache_init(RenderCache *cache, void *buffer, size_t size)
+{
+    if (!cache)
+        return;
+
+    memset(cache, 0, sizeof(RenderCache));
+    cache->pixels = (Color *)buffer;
+    cache->capacity = buffer ? size / sizeof(Color) : 0;
+}
+
+void render_cache_reset(RenderCache *cache)
+{
+    if (!cache)
+        return;
+
+    cache->used = 0;
+    cache->entry_count = 0;
+}
+
+void render_cache_set_active(RenderCache *cache)
+{
+    g_active_cache = cache;
+}
+
+RenderCache *render_cache_get_active(void)
+{
+    return g_active_cache;
+}
+
+bool render_cache_draw(Widget *widget, Framebuffer *framebuffer)
+{
+    RenderCache *cache = g_active_cache;
+    if (!cache || !widget || !framebuffer || !widget->vtable || !widget->vtable->render)
+        return false;
+
+    if (widget->width <= 0 || widget->height <= 0)
+        return false;
+
+    size_t size = (size_t)widget->width * widget->height;
+    RenderCacheEntry *entry = find_entry(cache, widget);
+
+    if (entry && (entry->width != widget->width || entry->height != widget->height))
+    {
+        remove_entry(cache, entry);
+        entry = NULL;
+    }
+
+    if (entry && entry->valid && COLOR_COMPARE(entry->background, framebuffer->background))
+    {
+        cache->hits++;
+    }
+    else
+    {
+        if (!entry)
+            entry = add_entry(cache, widget, size);
+        if (!entry)
+            return false;
+
+        cache->misses++;
+        capture(widget, entry, cache->pixels + entry->offset, framebuffer->background);
+    }
+
+    entry->last_used = ++cache->clock;
+    blit(entry, cache->pixels + entry->offset, framebuffer->origin_x + widget->x, framebuffer->origin_y + widget->y,
+         framebuffer);
+    return true;
+}
+
+// The surface stays allocated so the next capture can reuse it in place
+void render_cache_invalidate(Widget *widget)
+{
+    if (!g_active_cache)
+        return;
+
+    RenderCacheEntry *entry = find_entry(g_active_cache, widget);
+    if (entry)
+        entry->valid = false;
+}
+
+void render_cache_forget(Widget *widget)
+{
+    if (!g_active_cache)
+        return;
+
+    RenderCacheEntry *entry = find_entry(g_active_cache, widget);
+    if (entry)
+        remove_entry(g_active_cache, entry);
+}
+
+static RenderCacheEntry *find_entry(RenderCache *cache, Widget *widget)
+{
+    for (int i = 0; i < cache->entry_count; i++)
+    {
+        if (cache->entries[i].widget == widget)
+            return &cache->entries[i];
+    }
+
+    return NULL;
+}
+
+// Surfaces above the removed one are moved down, so the free space is always one run at the end of the buffer
+static void remove_entry(RenderCache *cache, RenderCacheEntry *entry)
+{
+    size_t size = (size_t)entry->width * entry->height;
+    size_t end = entry->offset + size;
+
+    memmove(cache->pixels + entry->offset, cache->pixels + end, (cache->used - end) * sizeof(Color));
+    cache->used -= size;
+
+    for (int i = 0; i < cache->entry_count; i++)
+    {
+        if (cache->entries[i].offset > entry->offset)
+            cache->entries[i].offset -= size;
+    }
+
+    *entry = cache->entries[--cache->entry_count];
+}
+
+static RenderCacheEntry *add_entry(RenderCache *cache, Widget *widget, size_t size)
+{
+    if (size > cache->capacity)
+        return NULL;
+
+    while (cache->entry_count > 0 &&
+           (cache->capacity - cache->used < size || cache->entry_count >= RENDER_CACHE_MAX_ENTRIES))
+    {
+        RenderCacheEntry *oldest = &cache->entries[0];
+        for (int i = 1; i < cache->entry_count; i++)
+        {
+            if (cache->entries[i].last_used < oldest->last_used)
+                oldest = &cache->entries[i];
+        }
+
+        remove_entry(cache, oldest);
+        cache->evictions++;
+    }
+
+    RenderCacheEntry *entry = &cache->entries[cache->entry_count++];
+    memset(entry, 0, sizeof(RenderCacheEntry));
+    entry->widget = widget;
+    entry->offset = cache->used;
+    entry->width = widget->width;
+    entry->height = widget->height;
+    cache->used += size;
+
+    return entry;
+}
+
+// The widget draws into its surface as if it were the framebuffer. The surface starts as the clear color with
+// zero alpha: blended pixels mix with the clear color and come out opaque, and pixels left untouched stay
+// transparent so the copy skips them.
+static void capture(Widget *widget, RenderCacheEntry *entry, Color *pixels, Color background)
+{
+    Color transparent = background;
+    transparent.a = 0x00;
+
+    size_t size = (size_t)entry->width * entry->height;
+    for (size_t i = 0; i < size; i++)
+        pixels[i] = transparent;
+
+    Framebuffer surface = {0};
+    surface.pixels = pixels;
+    surface.width = entry->width;
+    surface.height = entry->height;
+    surface.origin_x = -widget->x;
+    surface.origin_y = -widget->y;
+    surface.background = background;
+
+    widget->vtable->render(widget, &surface);
+
+    entry->background = background;
+    entry->valid = true;
+}
+
+static void blit(const RenderCacheEntry *entry, const Color *pixels, int x, int y, Framebuffer *framebuffer)
+{
+    int col_start = x < 0 ? -x : 0;
+    int row_start = y < 0 ? -y : 0;
+    int col_end = x + entry->width > FRAMEBUFFER_WIDTH(framebuffer) ? FRAMEBUFFER_WIDTH(framebuffer) - x : entry->width;
+    int row_end =
+        y + entry->height > FRAMEBUFFER_HEIGHT(framebuffer) ? FRAMEBUFFER_HEIGHT(framebuffer) - y : entry->height;
+
+    for (int row = row_start; row < row_end; row++)
+    {
+        const Color *source = pixels + (size_t)row * entry->width;
+        for (int col = col_start; col < col_end; col++)
+        {
+            if (source[col].a != 0x00)
+                FRAMEBUFFER_SET_PIXEL(framebuffer, x + col, y + row, source[col]);
+        }
+    }
+}
@@ -0,0 +1,179 @@
+#include "stroke_log.h"
+#include <stddef.h>
+
+#define VARINT_MAX_BYTES 5
+
+static int encode_varint(uint32_t value, uint8_t *out);
+static bool decode_varint(StrokeLogReader *reader, uint32_t *value);
+static bool append_event(StrokeLog *log, StrokeOp op, int x, int y);
+
+void stroke_log_init(StrokeLog *log, uint8_t *buffer, int capacity, int width, int height)
+{
+    if (!log)
+        return;
+
+    log->buffer = buffer;
+    log->capacity = buffer ? capacity : 0;
+    log->width = width;
+    log->height = height;
+    stroke_log_reset(log);
+}
+
+void stroke_log_reset(StrokeLog *log)
+{
+    if (!log)
+        return;
+
+    log->length = 0;
+    log->last_x = 0;
+    log->last_y = 0;
+    log->pen_down = false;
+    log->overflow = false;
+}
+
+bool stroke_log_pen_down(StrokeLog *log, int x, int y)
+{
+    if (!log)
+        return false;
+
+    if (log->pen_down && !stroke_log_pen_up(log))
+        return false;
+
+    if (!append_event(log, STROKE_OP_PEN_DOWN, x, y))
+        return false;
+
+    log->pen_down = true;
+    return true;
+}
+
+bool stroke_log_move(StrokeLog *log, int x, int y)
+{
+    if (!log || !log->pen_down)
+        return false;
+
+    if (x == log->last_x && y == log->last_y)
+        return true;
+
+    return append_event(log, STROKE_OP_MOVE, x, y);
+}
+
+bool stroke_log_pen_up(StrokeLog *log)
+{
+    if (!log || !log->pen_down)
+        return false;
+
+    log->pen_down = false;
+
+    if (log->length >= log->capacity)
+    {
+        log->overflow = true;
+        return false;
+    }
+
+    log->buffer[log->length++] = STROKE_OP_PEN_UP;
+    return true;
+}
+
+void stroke_log_reader_init(StrokeLogReader *reader, const uint8_t *data, int length)
+{
+    if (!reader)
+        return;
+
+    reader->data = data;
+    reader->length = data ? length : 0;
+    reader->position = 0;
+    reader->x = 0;
+    reader->y = 0;
+}
+
+bool stroke_log_read(StrokeLogReader *reader, StrokeOp *op, int *x, int *y)
+{
+    if (!reader || !op || !x || !y)
+        return false;
+
+    uint32_t head;
+    if (!decode_varint(reader, &head))
+        return false;
+
+    *op = (StrokeOp)(head & 0x3);
+
+    if (*op != STROKE_OP_PEN_UP)
+    {
+        uint32_t dy;
+        if (!decode_varint(reader, &dy))
+            return false;
+
+        uint32_t dx = head >> 2;
+        reader->x += (int)(dx >> 1) ^ -(int)(dx & 1);
+        reader->y += (int)(dy >> 1) ^ -(int)(dy & 1);
+    }
+
+    *x = reader->x;
+    *y = reader->y;
+    return true;
+}
+
+static bool append_event(StrokeLog *log, StrokeOp op, int x, int y)
+{
+    if (log->overflow)
+        return false;
+
+    int32_t dx = x - log->last_x;
+    int32_t dy = y - log->last_y;
+
+    uint8_t scratch[2 * VARINT_MAX_BYTES];
+    int size = encode_varint(((((uint32_t)dx << 1) ^ (uint32_t)(dx >> 31)) << 2) | (uint32_t)op, scratch);
+    size += encode_varint(((uint32_t)dy << 1) ^ (uint32_t)(dy >> 31), scratch + size);
+
+    // Keep one byte free for the pen-up that closes the stroke.
+    if (log->length + size + 1 > log->capacity)
+    {
+        log->overflow = true;
+        return false;
+    }
+
+    for (int i = 0; i < size; i++)
+    {
+        log->buffer[log->length++] = scratch[i];
+    }
+
+    log->last_x = x;
+    log->last_y = y;
+    return true;
+}
+
+static int encode_varint(uint32_t value, uint8_t *out)
+{
+    int size = 0;
+
+    while (value >= 0x80)
+    {
+        out[size++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    out[size++] = (uint8_t)value;
+
+    return size;
+}
+
+static bool decode_varint(StrokeLogReader *reader, uint32_t *value)
+{
+    uint32_t result = 0;
+
+    for (int shift = 0; shift < 7 * VARINT_MAX_BYTES; shift += 7)
+    {
+        if (reader->position >= reader->length)
+            return false;
+
+        uint8_t byte = reader->data[reader->position++];
+        result |= (uint32_t)(byte & 0x7F) << shift;
+
+        if (!(byte & 0x80))
+        {
+            *value = result;
+            return true;
+        }
+    }
+
+    return false;
+}
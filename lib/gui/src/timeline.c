@@ -0,0 +1,254 @@
+#include "timeline.h"
+#include "fixed.h"
+#include "widgets/button.h"
+#include "widgets/label.h"
+#include <string.h>
+
+#define EASING_SEGMENTS 16
+
+// Sampled at sixteenths of the duration in Q16 and interpolated between samples
+static const q16_t ease_in_table[EASING_SEGMENTS + 1] = {0,     256,   1024,  2304,  4096,  6400,
+                                                           9216,  12544, 16384, 20736, 25600, 30976,
+                                                           36864, 43264, 50176, 57600, 65536};
+static const q16_t ease_out_table[EASING_SEGMENTS + 1] = {0,     7936,  15360, 22272, 28672, 34560,
+                                                            39936, 44800, 49152, 52992, 56320, 59136,
+                                                            61440, 63232, 64512, 65280, 65536};
+static const q16_t ease_in_out_table[EASING_SEGMENTS + 1] = {0,     630,   2494,  5522,  9598,  14563,
+                                                               20228, 26375, 32768, 39161, 45308, 50973,
+                                                               55938, 60014, 63042, 64906, 65536};
+
+static q16_t ease(Easing easing, q16_t t);
+static int32_t lerp(int32_t from, int32_t to, q16_t t);
+static int32_t pack_color(Color color);
+static Color unpack_color(int32_t value);
+static int32_t tween_value(const Tween *tween, q16_t t);
+static void apply(Tween *tween, int32_t value);
+
+void timeline_init(Timeline *timeline)
+{
+    if (!timeline)
+        return;
+
+    memset(timeline, 0, sizeof(Timeline));
+}
+
+void timeline_update(Timeline *timeline, int elapsed_ms)
+{
+    if (!timeline || elapsed_ms < 0)
+        return;
+
+    for (int i = 0; i < TIMELINE_MAX_TWEENS; i++)
+    {
+        Tween *tween = &timeline->tweens[i];
+        if (!tween->active)
+            continue;
+
+        tween->elapsed_ms += elapsed_ms;
+        if (tween->elapsed_ms < tween->delay_ms)
+            continue;
+
+        uint32_t local = tween->elapsed_ms - tween->delay_ms;
+        bool reverse = false;
+
+        if (tween->loop)
+        {
+            // The elapsed time is folded back into one period so it never overflows
+            uint32_t period = tween->yoyo ? 2u * tween->duration_ms : tween->duration_ms;
+            local %= period;
+            tween->elapsed_ms = tween->delay_ms + local;
+            if (local >= tween->duration_ms)
+            {
+                local -= tween->duration_ms;
+                reverse = true;
+            }
+        }
+        else if (local >= tween->duration_ms)
+        {
+            apply(tween, tween->to);
+            tween->active = false;
+            continue;
+        }
+
+        q16_t t = (q16_t)(local * Q16_ONE / tween->duration_ms);
+        apply(tween, tween_value(tween, reverse ? Q16_ONE - t : t));
+    }
+}
+
+bool timeline_is_running(const Timeline *timeline)
+{
+    if (!timeline)
+        return false;
+
+    for (int i = 0; i < TIMELINE_MAX_TWEENS; i++)
+    {
+        if (timeline->tweens[i].active)
+            return true;
+    }
+
+    return false;
+}
+
+Tween *timeline_add(Timeline *timeline, Widget *widget, TweenProperty property, int from, int to, int duration_ms,
+                    Easing easing)
+{
+    if (!timeline || !widget || duration_ms <= 0 || duration_ms > UINT16_MAX)
+        return NULL;
+
+    Tween *slot = NULL;
+    for (int i = 0; i < TIMELINE_MAX_TWEENS; i++)
+    {
+        Tween *tween = &timeline->tweens[i];
+        if (tween->active && tween->widget == widget && tween->property == property)
+        {
+            slot = tween;
+            break;
+        }
+        if (!tween->active && !slot)
+            slot = tween;
+    }
+
+    if (!slot)
+        return NULL;
+
+    memset(slot, 0, sizeof(Tween));
+    slot->widget = widget;
+    slot->property = property;
+    slot->easing = easing;
+    slot->active = true;
+    slot->from = from;
+    slot->to = to;
+    slot->duration_ms = duration_ms;
+
+    switch (property)
+    {
+    case TWEEN_PROPERTY_X:
+        slot->current = widget->x;
+        break;
+    case TWEEN_PROPERTY_Y:
+        slot->current = widget->y;
+        break;
+    default:
+        slot->current = ~from;
+        break;
+    }
+    apply(slot, from);
+
+    return slot;
+}
+
+Tween *timeline_add_color(Timeline *timeline, Widget *widget, Color from, Color to, int duration_ms, Easing easing)
+{
+    return timeline_add(timeline, widget, TWEEN_PROPERTY_COLOR, pack_color(from), pack_color(to), duration_ms,
+                        easing);
+}
+
+void timeline_cancel(Timeline *timeline, Widget *widget)
+{
+    if (!timeline)
+        return;
+
+    for (int i = 0; i < TIMELINE_MAX_TWEENS; i++)
+    {
+        if (timeline->tweens[i].widget == widget)
+            timeline->tweens[i].active = false;
+    }
+}
+
+void tween_set_delay(Tween *tween, int delay_ms)
+{
+    if (!tween)
+        return;
+
+    tween->delay_ms = delay_ms < 0 ? 0 : delay_ms > UINT16_MAX ? UINT16_MAX : delay_ms;
+}
+
+void tween_set_loop(Tween *tween, bool yoyo)
+{
+    if (!tween)
+        return;
+
+    tween->loop = true;
+    tween->yoyo = yoyo;
+}
+
+static q16_t ease(Easing easing, q16_t t)
+{
+    const q16_t *table;
+    switch (easing)
+    {
+    case EASING_IN:
+        table = ease_in_table;
+        break;
+    case EASING_OUT:
+        table = ease_out_table;
+        break;
+    case EASING_IN_OUT:
+        table = ease_in_out_table;
+        break;
+    default:
+        return t;
+    }
+
+    int segment = t >> 12;
+    if (segment >= EASING_SEGMENTS)
+        return table[EASING_SEGMENTS];
+
+    q16_t fraction = t & 0xFFF;
+    return table[segment] + (((table[segment + 1] - table[segment]) * fraction) >> 12);
+}
+
+static int32_t lerp(int32_t from, int32_t to, q16_t t)
+{
+    return Q16_ROUND(q16_lerp(Q16_FROM_INT(from), Q16_FROM_INT(to), t));
+}
+
+static int32_t pack_color(Color color)
+{
+    return (int32_t)((uint32_t)color.a << 24 | (uint32_t)color.r << 16 | (uint32_t)color.g << 8 | color.b);
+}
+
+static Color unpack_color(int32_t value)
+{
+    uint32_t bits = (uint32_t)value;
+    return (Color){(uint8_t)(bits >> 24), (uint8_t)(bits >> 16), (uint8_t)(bits >> 8), (uint8_t)bits};
+}
+
+static int32_t tween_value(const Tween *tween, q16_t t)
+{
+    q16_t eased = ease(tween->easing, t);
+
+    if (tween->property != TWEEN_PROPERTY_COLOR)
+        return lerp(tween->from, tween->to, eased);
+
+    // Each channel is interpolated on its own
+    Color from = unpack_color(tween->from);
+    Color to = unpack_color(tween->to);
+    Color color = {(uint8_t)lerp(from.a, to.a, eased), (uint8_t)lerp(from.r, to.r, eased),
+                   (uint8_t)lerp(from.g, to.g, eased), (uint8_t)lerp(from.b, to.b, eased)};
+    return pack_color(color);
+}
+
+static void apply(Tween *tween, int32_t value)
+{
+    if (value == tween->current)
+        return;
+
+    tween->current = value;
+    Widget *widget = tween->widget;
+
+    switch (tween->property)
+    {
+    case TWEEN_PROPERTY_X:
+        widget_set_position(widget, value, widget->y);
+        break;
+    case TWEEN_PROPERTY_Y:
+        widget_set_position(widget, widget->x, value);
+        break;
+    case TWEEN_PROPERTY_COLOR:
+        if (widget->type == WIDGET_TYPE_BUTTON)
+            button_set_background_color(widget, unpack_color(value));
+        else if (widget->type == WIDGET_TYPE_LABEL)
+            label_set_color(widget, unpack_color(value));
+        break;
+    }
+}
@@ -1,5 +1,6 @@
 #include "widgets/button.h"
 #include "framebuffer.h"
+#include "gui_arena.h"
 #include "primitives/rectangle.h"
 #include "primitives/text.h"
 #include "widgets/widget.h"
@@ -9,73 +10,73 @@
 static void button_render_callback(Widget *widget, Framebuffer *framebuffer);
 static void button_destroy_callback(Widget *widget);
 
+const WidgetVTable button_vtable = {
+    .render = button_render_callback,
+    .destroy = button_destroy_callback,
+};
+
 Widget *button_create(int x, int y, int width, int height, const char *text)
 {
-    Widget *button = (Widget *)malloc(sizeof(Widget));
-    if (!button)
-        return NULL;
+    return button_create_buffered(x, y, width, height, text, 0);
+}
 
-    widget_init(button, WIDGET_TYPE_BUTTON, x, y, width, height);
+// The text buffer is reserved inline after the button's data, so setting text never allocates
+Widget *button_create_buffered(int x, int y, int width, int height, const char *text, int capacity)
+{
+    if (capacity < 0)
+        capacity = 0;
 
-    ButtonData *data = (ButtonData *)malloc(sizeof(ButtonData));
-    if (!data)
-    {
-        free(button);
+    Widget *button =
+        widget_create(WIDGET_TYPE_BUTTON, &button_vtable, sizeof(ButtonData) + capacity, x, y, width, height);
+    if (!button)
         return NULL;
-    }
 
-    data->text = text ? strdup(text) : NULL;
+    ButtonData *data = (ButtonData *)widget_data(button);
+    widget_text_init(&data->text, (char *)(data + 1), capacity);
+    widget_text_set(&data->text, text);
     data->padding = 8;
     data->background_color = COLOR_GRAY_75;
     data->text_color = COLOR_BLACK;
     data->border_color = COLOR_BLACK;
     data->border_thickness = 1;
     data->font = NULL;
-
-    button->data = data;
-
-    button->render = button_render_callback;
-    button->destroy = button_destroy_callback;
+    button->opaque = true;
 
     return button;
 }
 
 static void button_render_callback(Widget *widget, Framebuffer *framebuffer)
 {
-    if (!widget || !widget->data)
+    if (!widget || !widget_data(widget))
         return;
 
-    ButtonData *data = (ButtonData *)widget->data;
+    ButtonData *data = (ButtonData *)widget_data(widget);
+    int x = framebuffer->origin_x + widget->x;
+    int y = framebuffer->origin_y + widget->y;
 
-    renderFilledRectangle(widget->x, widget->y, widget->width, widget->height, data->background_color, framebuffer);
+    renderFilledRectangle(x, y, widget->width, widget->height, data->background_color, framebuffer);
 
     if (data->border_thickness > 0)
     {
-        renderRectangle(widget->x, widget->y, widget->width, widget->height, data->border_color, data->border_thickness,
-                        framebuffer);
+        renderRectangle(x, y, widget->width, widget->height, data->border_color, data->border_thickness, framebuffer);
     }
 
-    if (data->text && data->font)
+    if (data->text.value && data->font)
     {
-        int text_x = widget->x + data->padding;
-        int text_y = widget->y + data->padding;
+        int text_x = x + data->padding;
+        int text_y = y + data->padding;
 
-        renderText(data->text, data->text_color, text_x, text_y, data->font, framebuffer);
+        renderText(data->text.value, data->text_color, text_x, text_y, data->font, framebuffer);
     }
 }
 
 static void button_destroy_callback(Widget *widget)
 {
-    if (!widget || !widget->data)
+    if (!widget || !widget_data(widget))
         return;
 
-    ButtonData *data = (ButtonData *)widget->data;
-
-    if (data->text)
-    {
-        free(data->text);
-        data->text = NULL;
-    }
+    ButtonData *data = (ButtonData *)widget_data(widget);
+    widget_text_release(&data->text);
 }
 
 void button_set_text(Widget *button, const char *text)
@@ -83,17 +84,25 @@ void button_set_text(Widget *button, const char *text)
     if (!button || button->type != WIDGET_TYPE_BUTTON)
         return;
 
-    ButtonData *data = (ButtonData *)button->data;
+    ButtonData *data = (ButtonData *)widget_data(button);
     if (!data)
         return;
 
-    if (data->text)
-    {
-        free(data->text);
-    }
+    if (widget_text_set(&data->text, text))
+        widget_mark_dirty(button);
+}
 
-    data->text = text ? strdup(text) : NULL;
-    widget_mark_dirty(button);
+void button_set_static_text(Widget *button, const char *text)
+{
+    if (!button || button->type != WIDGET_TYPE_BUTTON)
+        return;
+
+    ButtonData *data = (ButtonData *)widget_data(button);
+    if (!data)
+        return;
+
+    if (widget_text_borrow(&data->text, text))
+        widget_mark_dirty(button);
 }
 
 void button_set_padding(Widget *button, int padding)
@@ -101,7 +110,7 @@ void button_set_padding(Widget *button, int padding)
     if (!button || button->type != WIDGET_TYPE_BUTTON)
         return;
 
-    ButtonData *data = (ButtonData *)button->data;
+    ButtonData *data = (ButtonData *)widget_data(button);
     if (!data)
         return;
 
@@ -117,7 +126,7 @@ void button_set_background_color(Widget *button, Color color)
     if (!button || button->type != WIDGET_TYPE_BUTTON)
         return;
 
-    ButtonData *data = (ButtonData *)button->data;
+    ButtonData *data = (ButtonData *)widget_data(button);
     if (!data)
         return;
 
@@ -133,7 +142,7 @@ void button_set_text_color(Widget *button, Color color)
     if (!button || button->type != WIDGET_TYPE_BUTTON)
         return;
 
-    ButtonData *data = (ButtonData *)button->data;
+    ButtonData *data = (ButtonData *)widget_data(button);
     if (!data)
         return;
 
@@ -149,7 +158,7 @@ void button_set_border(Widget *button, Color color, int thickness)
     if (!button || button->type != WIDGET_TYPE_BUTTON)
         return;
 
-    ButtonData *data = (ButtonData *)button->data;
+    ButtonData *data = (ButtonData *)widget_data(button);
     if (!data)
         return;
 
@@ -166,7 +175,7 @@ void button_set_font(Widget *button, const bdf_font_t *font)
     if (!button || button->type != WIDGET_TYPE_BUTTON)
         return;
 
-    ButtonData *data = (ButtonData *)button->data;
+    ButtonData *data = (ButtonData *)widget_data(button);
     if (!data)
         return;
 
@@ -188,11 +197,11 @@ const char *button_get_text(Widget *button)
     if (!button || button->type != WIDGET_TYPE_BUTTON)
         return NULL;
 
-    ButtonData *data = (ButtonData *)button->data;
+    ButtonData *data = (ButtonData *)widget_data(button);
     if (!data)
         return NULL;
 
-    return data->text;
+    return data->text.value;
 }
 
 void button_auto_size(Widget *button)
@@ -200,11 +209,11 @@ void button_auto_size(Widget *button)
     if (!button || button->type != WIDGET_TYPE_BUTTON)
         return;
 
-    ButtonData *data = (ButtonData *)button->data;
-    if (!data || !data->font || !data->text)
+    ButtonData *data = (ButtonData *)widget_data(button);
+    if (!data || !data->font || !data->text.value)
         return;
 
-    int text_width = measureTextWidth(data->text, data->font);
+    int text_width = measureTextWidth(data->text.value, data->font);
     int text_height = getFontHeight(data->font);
 
     int total_padding = data->padding * 2;
@@ -213,6 +222,12 @@ void button_auto_size(Widget *button)
     button->width = text_width + total_padding + total_border;
     button->height = text_height + total_padding + total_border;
 
+    button->layout.preferred_width = button->width;
+    button->layout.preferred_height = button->height;
+
+    widget_invalidate_bounds(button);
+    widget_invalidate_measure(button);
+    widget_mark_layout_dirty(button->parent);
     widget_mark_dirty(button);
 }
 
@@ -1,6 +1,7 @@
 #include "widgets/canvas.h"
 #include "color.h"
 #include "framebuffer.h"
+#include "gui_arena.h"
 #include "primitives/rectangle.h"
 #include "widgets/widget.h"
 #include <stdlib.h>
@@ -10,28 +11,35 @@ static void canvas_render_callback(Widget *widget, Framebuffer *framebuffer);
 static void canvas_destroy_callback(Widget *widget);
 static void canvas_dirty_callback(Widget *widget, Framebuffer *framebuffer);
 static void expand_dirty_rect(CanvasData *data, int x, int y, int width, int height);
+static int cell_start(int cell, int size);
+static void stamp_brush(Widget *canvas, CanvasData *data, int canvas_x, int canvas_y, int half_brush);
+static void stamp_segment(Widget *canvas, CanvasData *data, int x0, int y0, int x1, int y1, int half_brush);
+static void save_tile(Widget *canvas, CanvasData *data, int px, int py);
+static void swap_tile(Widget *canvas, CanvasData *data, CanvasTileBlock *block);
+static void restore_history_entry(Widget *canvas, CanvasData *data, const CanvasHistoryEntry *entry);
+static void refresh_ink_bounds(Widget *canvas, CanvasData *data);
+static void history_begin_stroke(CanvasData *data);
+static void history_end_stroke(CanvasData *data);
+
+static const WidgetVTable canvas_vtable = {
+    .render = canvas_render_callback,
+    .on_dirty = canvas_dirty_callback,
+    .destroy = canvas_destroy_callback,
+};
 
 Widget *canvas_create(int x, int y, int width, int height)
 {
-    Widget *canvas = (Widget *)malloc(sizeof(Widget));
+    Widget *canvas = widget_create(WIDGET_TYPE_CANVAS, &canvas_vtable, sizeof(CanvasData), x, y, width, height);
     if (!canvas)
         return NULL;
 
-    widget_init(canvas, WIDGET_TYPE_CANVAS, x, y, width, height);
-
-    CanvasData *data = (CanvasData *)malloc(sizeof(CanvasData));
-    if (!data)
-    {
-        free(canvas);
-        return NULL;
-    }
+    CanvasData *data = (CanvasData *)widget_data(canvas);
 
     int pixel_count = width * height;
-    data->pixels = (uint8_t *)malloc(pixel_count * sizeof(uint8_t));
+    data->pixels = (uint8_t *)gui_alloc(pixel_count * sizeof(uint8_t));
     if (!data->pixels)
     {
-        free(data);
-        free(canvas);
+        gui_free(canvas);
         return NULL;
     }
 
@@ -50,12 +58,21 @@ Widget *canvas_create(int x, int y, int width, int height)
     data->dirty_width = 0;
     data->dirty_height = 0;
     data->has_dirty_rect = 0;
-
-    canvas->data = data;
-
-    canvas->render = canvas_render_callback;
-    canvas->destroy = canvas_destroy_callback;
-    canvas->on_dirty = canvas_dirty_callback;
+    memset(data->cell_ink, 0, sizeof(data->cell_ink));
+    data->ink_count = 0;
+    data->ink_min_x = 0;
+    data->ink_min_y = 0;
+    data->ink_max_x = 0;
+    data->ink_max_y = 0;
+    data->ink_bounds_stale = false;
+    data->version = 0;
+    data->stroke_log = NULL;
+    data->history = NULL;
+    data->full_redraw = true;
+    data->stroke_active = false;
+    data->stroke_open = false;
+    data->stroke_x = 0;
+    data->stroke_y = 0;
 
     return canvas;
 }
@@ -65,15 +82,18 @@ static void canvas_dirty_callback(Widget *widget, Framebuffer *framebuffer)
     if (!widget || !framebuffer)
         return;
 
-    CanvasData *data = (CanvasData *)widget->data;
+    CanvasData *data = (CanvasData *)widget_data(widget);
 
     if (!widget->visible)
     {
+        if (data)
+            data->full_redraw = true;
+
         if (framebuffer->dirty_rect_count < MAX_DIRTY_RECTS)
         {
             DirtyRect *rect = &framebuffer->dirty_rects[framebuffer->dirty_rect_count];
-            rect->x = widget->x;
-            rect->y = widget->y;
+            rect->x = framebuffer->origin_x + widget->x;
+            rect->y = framebuffer->origin_y + widget->y;
             rect->width = widget->width;
             rect->height = widget->height;
             framebuffer->dirty_rect_count++;
@@ -87,8 +107,8 @@ static void canvas_dirty_callback(Widget *widget, Framebuffer *framebuffer)
     if (framebuffer->dirty_rect_count < MAX_DIRTY_RECTS)
     {
         DirtyRect *rect = &framebuffer->dirty_rects[framebuffer->dirty_rect_count];
-        rect->x = widget->x + data->dirty_x;
-        rect->y = widget->y + data->dirty_y;
+        rect->x = framebuffer->origin_x + widget->x + data->dirty_x;
+        rect->y = framebuffer->origin_y + widget->y + data->dirty_y;
         rect->width = data->dirty_width;
         rect->height = data->dirty_height;
         framebuffer->dirty_rect_count++;
@@ -97,18 +117,36 @@ static void canvas_dirty_callback(Widget *widget, Framebuffer *framebuffer)
 
 static void canvas_render_callback(Widget *widget, Framebuffer *framebuffer)
 {
-    if (!widget || !widget->data)
+    if (!widget || !widget_data(widget))
         return;
 
-    CanvasData *data = (CanvasData *)widget->data;
+    CanvasData *data = (CanvasData *)widget_data(widget);
+
+    // Only the dirty region was cleared behind the canvas, so unless it moved or was hidden only that is redrawn
+    int first_row = 0;
+    int last_row = widget->height;
+    int first_col = 0;
+    int last_col = widget->width;
 
-    for (int row = 0; row < widget->height; row++)
+    int x = framebuffer->origin_x + widget->x;
+    int y = framebuffer->origin_y + widget->y;
+    bool moved = x != widget->prev_x || y != widget->prev_y || widget->width != widget->prev_width ||
+                 widget->height != widget->prev_height;
+    if (!data->full_redraw && !moved && data->has_dirty_rect)
     {
-        for (int col = 0; col < widget->width; col++)
+        first_row = data->dirty_y;
+        last_row = data->dirty_y + data->dirty_height;
+        first_col = data->dirty_x;
+        last_col = data->dirty_x + data->dirty_width;
+    }
+
+    for (int row = first_row; row < last_row; row++)
+    {
+        for (int col = first_col; col < last_col; col++)
         {
             int canvas_idx = row * widget->width + col;
-            int fb_x = widget->x + col;
-            int fb_y = widget->y + row;
+            int fb_x = x + col;
+            int fb_y = y + row;
 
             if (fb_x >= 0 && fb_x < FRAMEBUFFER_WIDTH(framebuffer) && fb_y >= 0 &&
                 fb_y < FRAMEBUFFER_HEIGHT(framebuffer))
@@ -123,10 +161,10 @@ static void canvas_render_callback(Widget *widget, Framebuffer *framebuffer)
 
     if (data->border_thickness > 0)
     {
-        renderRectangle(widget->x, widget->y, widget->width, widget->height, data->border_color, data->border_thickness,
-                        framebuffer);
+        renderRectangle(x, y, widget->width, widget->height, data->border_color, data->border_thickness, framebuffer);
     }
 
+    data->full_redraw = false;
     data->has_dirty_rect = 0;
     data->dirty_x = 0;
     data->dirty_y = 0;
@@ -136,14 +174,14 @@ static void canvas_render_callback(Widget *widget, Framebuffer *framebuffer)
 
 static void canvas_destroy_callback(Widget *widget)
 {
-    if (!widget || !widget->data)
+    if (!widget || !widget_data(widget))
         return;
 
-    CanvasData *data = (CanvasData *)widget->data;
+    CanvasData *data = (CanvasData *)widget_data(widget);
 
     if (data->pixels)
     {
-        free(data->pixels);
+        gui_free(data->pixels);
         data->pixels = NULL;
     }
 }
@@ -187,19 +225,31 @@ void canvas_set_brush_size(Widget *canvas, int size)
     if (!canvas || canvas->type != WIDGET_TYPE_CANVAS)
         return;
 
-    CanvasData *data = (CanvasData *)canvas->data;
+    CanvasData *data = (CanvasData *)widget_data(canvas);
     if (!data)
         return;
 
     data->brush_size = size > 0 ? size : 1;
 }
 
+int canvas_get_brush_size(Widget *canvas)
+{
+    if (!canvas || canvas->type != WIDGET_TYPE_CANVAS)
+        return 0;
+
+    CanvasData *data = (CanvasData *)widget_data(canvas);
+    if (!data)
+        return 0;
+
+    return data->brush_size;
+}
+
 void canvas_set_brush_color(Widget *canvas, Color color)
 {
     if (!canvas || canvas->type != WIDGET_TYPE_CANVAS)
         return;
 
-    CanvasData *data = (CanvasData *)canvas->data;
+    CanvasData *data = (CanvasData *)widget_data(canvas);
     if (!data)
         return;
 
@@ -211,7 +261,7 @@ void canvas_set_background_color(Widget *canvas, Color color)
     if (!canvas || canvas->type != WIDGET_TYPE_CANVAS)
         return;
 
-    CanvasData *data = (CanvasData *)canvas->data;
+    CanvasData *data = (CanvasData *)widget_data(canvas);
     if (!data)
         return;
 
@@ -223,7 +273,7 @@ void canvas_set_border(Widget *canvas, Color color, int thickness)
     if (!canvas || canvas->type != WIDGET_TYPE_CANVAS)
         return;
 
-    CanvasData *data = (CanvasData *)canvas->data;
+    CanvasData *data = (CanvasData *)widget_data(canvas);
     if (!data)
         return;
 
@@ -236,20 +286,108 @@ void canvas_draw_at(Widget *canvas, int x, int y)
     if (!canvas || canvas->type != WIDGET_TYPE_CANVAS)
         return;
 
-    CanvasData *data = (CanvasData *)canvas->data;
+    CanvasData *data = (CanvasData *)widget_data(canvas);
     if (!data || !data->pixels)
         return;
 
-    int canvas_x = x - canvas->x;
-    int canvas_y = y - canvas->y;
+    int screen_x, screen_y;
+    widget_get_screen_position(canvas, &screen_x, &screen_y);
+    int canvas_x = x - screen_x;
+    int canvas_y = y - screen_y;
 
+    // Leaving the canvas lifts the pen, so coming back does not join the exit and re-entry points
     if (canvas_x < 0 || canvas_x >= canvas->width || canvas_y < 0 || canvas_y >= canvas->height)
     {
+        data->stroke_open = false;
+        if (data->stroke_log && data->stroke_log->pen_down)
+            stroke_log_pen_up(data->stroke_log);
         return;
     }
 
+    if (data->history && !data->history->in_stroke)
+    {
+        history_begin_stroke(data);
+    }
+
+    if (data->stroke_log)
+    {
+        if (data->stroke_log->pen_down)
+            stroke_log_move(data->stroke_log, canvas_x, canvas_y);
+        else
+            stroke_log_pen_down(data->stroke_log, canvas_x, canvas_y);
+    }
+
+    // Within a stroke consecutive points are joined, so fast pointer motion leaves no gaps
+    if (data->stroke_open)
+        stamp_segment(canvas, data, data->stroke_x, data->stroke_y, canvas_x, canvas_y, data->brush_size / 2);
+    else
+        stamp_brush(canvas, data, canvas_x, canvas_y, data->brush_size / 2);
+
+    data->stroke_x = canvas_x;
+    data->stroke_y = canvas_y;
+    data->stroke_open = data->stroke_active;
+
+    widget_mark_dirty(canvas);
+}
+
+void canvas_draw_line(Widget *canvas, int x0, int y0, int x1, int y1)
+{
+    if (!canvas || canvas->type != WIDGET_TYPE_CANVAS)
+        return;
+
+    CanvasData *data = (CanvasData *)widget_data(canvas);
+    if (!data || !data->pixels)
+        return;
+
+    int screen_x, screen_y;
+    widget_get_screen_position(canvas, &screen_x, &screen_y);
+    int start_x = x0 - screen_x;
+    int start_y = y0 - screen_y;
     int half_brush = data->brush_size / 2;
 
+    if (start_x >= 0 && start_x < canvas->width && start_y >= 0 && start_y < canvas->height)
+        stamp_brush(canvas, data, start_x, start_y, half_brush);
+
+    stamp_segment(canvas, data, start_x, start_y, x1 - screen_x, y1 - screen_y, half_brush);
+
+    widget_mark_dirty(canvas);
+}
+
+// Stamps the brush on every pixel of the line except the first, which the previous stamp already covered
+static void stamp_segment(Widget *canvas, CanvasData *data, int x0, int y0, int x1, int y1, int half_brush)
+{
+    int dx = x1 > x0 ? x1 - x0 : x0 - x1;
+    int dy = y1 > y0 ? y0 - y1 : y1 - y0;
+    int step_x = x0 < x1 ? 1 : -1;
+    int step_y = y0 < y1 ? 1 : -1;
+    int error = dx + dy;
+
+    bool first = true;
+    for (;;)
+    {
+        if (!first && x0 >= 0 && x0 < canvas->width && y0 >= 0 && y0 < canvas->height)
+            stamp_brush(canvas, data, x0, y0, half_brush);
+        first = false;
+
+        if (x0 == x1 && y0 == y1)
+            break;
+
+        int doubled = 2 * error;
+        if (doubled >= dy)
+        {
+            error += dy;
+            x0 += step_x;
+        }
+        if (doubled <= dx)
+        {
+            error += dx;
+            y0 += step_y;
+        }
+    }
+}
+
+static void stamp_brush(Widget *canvas, CanvasData *data, int canvas_x, int canvas_y, int half_brush)
+{
     int min_x = canvas_x - half_brush;
     int min_y = canvas_y - half_brush;
     int max_x = canvas_x + half_brush;
@@ -264,24 +402,49 @@ void canvas_draw_at(Widget *canvas, int x, int y)
     if (max_y >= canvas->height)
         max_y = canvas->height - 1;
 
-    for (int dy = -half_brush; dy <= half_brush; dy++)
+    unsigned int stamped = 0;
+
+    for (int py = min_y; py <= max_y; py++)
     {
-        for (int dx = -half_brush; dx <= half_brush; dx++)
+        int cell_row = (py * CANVAS_DOWNSAMPLE_SIZE / canvas->height) * CANVAS_DOWNSAMPLE_SIZE;
+
+        for (int px = min_x; px <= max_x; px++)
         {
-            int px = canvas_x + dx;
-            int py = canvas_y + dy;
+            int idx = py * canvas->width + px;
+            if (data->pixels[idx])
+                continue;
 
-            if (px >= 0 && px < canvas->width && py >= 0 && py < canvas->height)
-            {
-                int idx = py * canvas->width + px;
-                data->pixels[idx] = 255;
-            }
+            if (data->history && data->history->recording)
+                save_tile(canvas, data, px, py);
+
+            data->pixels[idx] = 255;
+            data->cell_ink[cell_row + px * CANVAS_DOWNSAMPLE_SIZE / canvas->width]++;
+            stamped++;
         }
     }
 
-    expand_dirty_rect(data, min_x, min_y, max_x - min_x + 1, max_y - min_y + 1);
+    if (stamped > 0)
+    {
+        if (data->ink_count == 0)
+        {
+            data->ink_min_x = min_x;
+            data->ink_min_y = min_y;
+            data->ink_max_x = max_x;
+            data->ink_max_y = max_y;
+        }
+        else
+        {
+            data->ink_min_x = min_x < data->ink_min_x ? min_x : data->ink_min_x;
+            data->ink_min_y = min_y < data->ink_min_y ? min_y : data->ink_min_y;
+            data->ink_max_x = max_x > data->ink_max_x ? max_x : data->ink_max_x;
+            data->ink_max_y = max_y > data->ink_max_y ? max_y : data->ink_max_y;
+        }
 
-    widget_mark_dirty(canvas);
+        data->ink_count += stamped;
+        data->version++;
+    }
+
+    expand_dirty_rect(data, min_x, min_y, max_x - min_x + 1, max_y - min_y + 1);
 }
 
 void canvas_clear(Widget *canvas)
@@ -289,7 +452,7 @@ void canvas_clear(Widget *canvas)
     if (!canvas || canvas->type != WIDGET_TYPE_CANVAS)
         return;
 
-    CanvasData *data = (CanvasData *)canvas->data;
+    CanvasData *data = (CanvasData *)widget_data(canvas);
     if (!data || !data->pixels)
         return;
 
@@ -299,7 +462,422 @@ void canvas_clear(Widget *canvas)
         data->pixels[i] = 0;
     }
 
+    if (data->stroke_log)
+    {
+        stroke_log_reset(data->stroke_log);
+    }
+
+    if (data->history)
+    {
+        canvas_history_reset(data->history);
+    }
+
+    data->stroke_open = false;
+
+    if (data->ink_count > 0)
+    {
+        memset(data->cell_ink, 0, sizeof(data->cell_ink));
+        data->ink_count = 0;
+        data->ink_bounds_stale = false;
+        data->version++;
+    }
+
     expand_dirty_rect(data, 0, 0, canvas->width, canvas->height);
 
     widget_mark_dirty(canvas);
 }
+
+static int cell_start(int cell, int size)
+{
+    return (cell * size + CANVAS_DOWNSAMPLE_SIZE - 1) / CANVAS_DOWNSAMPLE_SIZE;
+}
+
+void canvas_get_downsample(Widget *canvas, uint8_t *output_buffer)
+{
+    if (!canvas || canvas->type != WIDGET_TYPE_CANVAS || !output_buffer)
+        return;
+
+    CanvasData *data = (CanvasData *)widget_data(canvas);
+    if (!data)
+        return;
+
+    for (int cy = 0; cy < CANVAS_DOWNSAMPLE_SIZE; cy++)
+    {
+        int cell_height = cell_start(cy + 1, canvas->height) - cell_start(cy, canvas->height);
+
+        for (int cx = 0; cx < CANVAS_DOWNSAMPLE_SIZE; cx++)
+        {
+            int idx = cy * CANVAS_DOWNSAMPLE_SIZE + cx;
+            unsigned int area =
+                (unsigned int)((cell_start(cx + 1, canvas->width) - cell_start(cx, canvas->width)) * cell_height);
+
+            output_buffer[idx] = area > 0 ? (uint8_t)((data->cell_ink[idx] * 255u + area / 2) / area) : 0;
+        }
+    }
+}
+
+unsigned int canvas_get_version(Widget *canvas)
+{
+    if (!canvas || canvas->type != WIDGET_TYPE_CANVAS)
+        return 0;
+
+    CanvasData *data = (CanvasData *)widget_data(canvas);
+    if (!data)
+        return 0;
+
+    return data->version;
+}
+
+bool canvas_get_ink_bounds(Widget *canvas, int *x, int *y, int *width, int *height)
+{
+    if (!canvas || canvas->type != WIDGET_TYPE_CANVAS || !x || !y || !width || !height)
+        return false;
+
+    CanvasData *data = (CanvasData *)widget_data(canvas);
+    if (!data || data->ink_count == 0)
+        return false;
+
+    if (data->ink_bounds_stale)
+        refresh_ink_bounds(canvas, data);
+
+    *x = data->ink_min_x;
+    *y = data->ink_min_y;
+    *width = data->ink_max_x - data->ink_min_x + 1;
+    *height = data->ink_max_y - data->ink_min_y + 1;
+
+    return true;
+}
+
+void canvas_begin_stroke(Widget *canvas, int x, int y)
+{
+    if (!canvas || canvas->type != WIDGET_TYPE_CANVAS)
+        return;
+
+    CanvasData *data = (CanvasData *)widget_data(canvas);
+    if (!data)
+        return;
+
+    if (data->stroke_log && data->stroke_log->pen_down)
+    {
+        stroke_log_pen_up(data->stroke_log);
+    }
+
+    history_end_stroke(data);
+
+    data->stroke_active = true;
+    data->stroke_open = false;
+    canvas_draw_at(canvas, x, y);
+}
+
+void canvas_end_stroke(Widget *canvas)
+{
+    if (!canvas || canvas->type != WIDGET_TYPE_CANVAS)
+        return;
+
+    CanvasData *data = (CanvasData *)widget_data(canvas);
+    if (!data)
+        return;
+
+    if (data->stroke_log)
+        stroke_log_pen_up(data->stroke_log);
+
+    history_end_stroke(data);
+    data->stroke_active = false;
+    data->stroke_open = false;
+}
+
+void canvas_set_stroke_log(Widget *canvas, StrokeLog *log)
+{
+    if (!canvas || canvas->type != WIDGET_TYPE_CANVAS)
+        return;
+
+    CanvasData *data = (CanvasData *)widget_data(canvas);
+    if (!data)
+        return;
+
+    data->stroke_log = log;
+}
+
+void canvas_replay_stroke_log(Widget *canvas, const StrokeLog *log)
+{
+    if (!canvas || canvas->type != WIDGET_TYPE_CANVAS || !log || log->width <= 0 || log->height <= 0)
+        return;
+
+    CanvasData *data = (CanvasData *)widget_data(canvas);
+    if (!data || !data->pixels)
+        return;
+
+    StrokeLogReader reader;
+    stroke_log_reader_init(&reader, log->buffer, log->length);
+
+    StrokeOp op;
+    int x;
+    int y;
+    int previous_x = 0;
+    int previous_y = 0;
+
+    while (stroke_log_read(&reader, &op, &x, &y))
+    {
+        if (op == STROKE_OP_PEN_UP)
+            continue;
+
+        int canvas_x = (x * canvas->width + log->width / 2) / log->width;
+        int canvas_y = (y * canvas->height + log->height / 2) / log->height;
+
+        if (op == STROKE_OP_MOVE)
+        {
+            stamp_segment(canvas, data, previous_x, previous_y, canvas_x, canvas_y, data->brush_size / 2);
+        }
+        else if (canvas_x >= 0 && canvas_x < canvas->width && canvas_y >= 0 && canvas_y < canvas->height)
+        {
+            stamp_brush(canvas, data, canvas_x, canvas_y, data->brush_size / 2);
+        }
+
+        previous_x = canvas_x;
+        previous_y = canvas_y;
+    }
+
+    widget_mark_dirty(canvas);
+}
+
+bool canvas_set_history(Widget *canvas, CanvasHistory *history)
+{
+    if (!canvas || canvas->type != WIDGET_TYPE_CANVAS)
+        return false;
+
+    CanvasData *data = (CanvasData *)widget_data(canvas);
+    if (!data)
+        return false;
+
+    int tiles_x = (canvas->width + CANVAS_TILE_SIZE - 1) / CANVAS_TILE_SIZE;
+    int tiles_y = (canvas->height + CANVAS_TILE_SIZE - 1) / CANVAS_TILE_SIZE;
+    if (history && tiles_x * tiles_y > CANVAS_HISTORY_MAX_TILES)
+        return false;
+
+    if (history)
+        canvas_history_reset(history);
+
+    data->history = history;
+    return true;
+}
+
+bool canvas_undo(Widget *canvas)
+{
+    if (!canvas || canvas->type != WIDGET_TYPE_CANVAS)
+        return false;
+
+    CanvasData *data = (CanvasData *)widget_data(canvas);
+    if (!data || !data->history)
+        return false;
+
+    if (data->history->in_stroke)
+        canvas_end_stroke(canvas);
+
+    CanvasHistoryEntry *entry = canvas_history_undo(data->history);
+    if (!entry)
+        return false;
+
+    restore_history_entry(canvas, data, entry);
+
+    // Drop the stroke from the log as well, as long as nothing was logged after it
+    StrokeLog *log = data->stroke_log;
+    if (log && !log->pen_down && !log->overflow && log->length == entry->log_end)
+    {
+        log->length = entry->log_start;
+        log->last_x = entry->log_start_x;
+        log->last_y = entry->log_start_y;
+    }
+
+    return true;
+}
+
+bool canvas_redo(Widget *canvas)
+{
+    if (!canvas || canvas->type != WIDGET_TYPE_CANVAS)
+        return false;
+
+    CanvasData *data = (CanvasData *)widget_data(canvas);
+    if (!data || !data->history)
+        return false;
+
+    if (data->history->in_stroke)
+        canvas_end_stroke(canvas);
+
+    CanvasHistoryEntry *entry = canvas_history_redo(data->history);
+    if (!entry)
+        return false;
+
+    restore_history_entry(canvas, data, entry);
+
+    // The undone bytes are still in the buffer if no stroke was logged since
+    StrokeLog *log = data->stroke_log;
+    if (log && !log->pen_down && !log->overflow && log->length == entry->log_start)
+    {
+        log->length = entry->log_end;
+        log->last_x = entry->log_end_x;
+        log->last_y = entry->log_end_y;
+    }
+
+    return true;
+}
+
+static void history_begin_stroke(CanvasData *data)
+{
+    if (!data->history)
+        return;
+
+    StrokeLog *log = data->stroke_log;
+    canvas_history_begin_stroke(data->history, log ? log->length : 0, log ? log->last_x : 0, log ? log->last_y : 0);
+}
+
+static void history_end_stroke(CanvasData *data)
+{
+    if (!data->history)
+        return;
+
+    StrokeLog *log = data->stroke_log;
+    canvas_history_end_stroke(data->history, log ? log->length : 0, log ? log->last_x : 0, log ? log->last_y : 0);
+}
+
+static void save_tile(Widget *canvas, CanvasData *data, int px, int py)
+{
+    int tiles_x = (canvas->width + CANVAS_TILE_SIZE - 1) / CANVAS_TILE_SIZE;
+    int tile = (py / CANVAS_TILE_SIZE) * tiles_x + px / CANVAS_TILE_SIZE;
+
+    CanvasTileBlock *block = canvas_history_save_tile(data->history, tile);
+    if (!block)
+        return;
+
+    memset(block->bits, 0, sizeof(block->bits));
+
+    int origin_x = (px / CANVAS_TILE_SIZE) * CANVAS_TILE_SIZE;
+    int origin_y = (py / CANVAS_TILE_SIZE) * CANVAS_TILE_SIZE;
+    int width = canvas->width - origin_x < CANVAS_TILE_SIZE ? canvas->width - origin_x : CANVAS_TILE_SIZE;
+    int height = canvas->height - origin_y < CANVAS_TILE_SIZE ? canvas->height - origin_y : CANVAS_TILE_SIZE;
+
+    for (int ty = 0; ty < height; ty++)
+    {
+        const uint8_t *row = &data->pixels[(origin_y + ty) * canvas->width + origin_x];
+        for (int tx = 0; tx < width; tx++)
+        {
+            if (row[tx])
+            {
+                int bit = ty * CANVAS_TILE_SIZE + tx;
+                block->bits[bit >> 3] |= (uint8_t)(1u << (bit & 7));
+            }
+        }
+    }
+}
+
+// Exchanges a tile on the canvas with its snapshot, so the same block serves both undo and redo
+static void swap_tile(Widget *canvas, CanvasData *data, CanvasTileBlock *block)
+{
+    int tiles_x = (canvas->width + CANVAS_TILE_SIZE - 1) / CANVAS_TILE_SIZE;
+    int origin_x = (block->tile % tiles_x) * CANVAS_TILE_SIZE;
+    int origin_y = (block->tile / tiles_x) * CANVAS_TILE_SIZE;
+    int width = canvas->width - origin_x < CANVAS_TILE_SIZE ? canvas->width - origin_x : CANVAS_TILE_SIZE;
+    int height = canvas->height - origin_y < CANVAS_TILE_SIZE ? canvas->height - origin_y : CANVAS_TILE_SIZE;
+
+    for (int ty = 0; ty < height; ty++)
+    {
+        int py = origin_y + ty;
+        int cell_row = (py * CANVAS_DOWNSAMPLE_SIZE / canvas->height) * CANVAS_DOWNSAMPLE_SIZE;
+        uint8_t *row = &data->pixels[py * canvas->width];
+
+        for (int tx = 0; tx < width; tx++)
+        {
+            int px = origin_x + tx;
+            int bit = ty * CANVAS_TILE_SIZE + tx;
+            uint8_t mask = (uint8_t)(1u << (bit & 7));
+            bool saved = (block->bits[bit >> 3] & mask) != 0;
+            bool current = row[px] != 0;
+
+            if (saved == current)
+                continue;
+
+            uint16_t *cell = &data->cell_ink[cell_row + px * CANVAS_DOWNSAMPLE_SIZE / canvas->width];
+            if (saved)
+            {
+                row[px] = 255;
+                (*cell)++;
+                data->ink_count++;
+                block->bits[bit >> 3] &= (uint8_t)~mask;
+            }
+            else
+            {
+                row[px] = 0;
+                (*cell)--;
+                data->ink_count--;
+                block->bits[bit >> 3] |= mask;
+            }
+        }
+    }
+
+    if (data->ink_count > 0)
+    {
+        int max_x = origin_x + width - 1;
+        int max_y = origin_y + height - 1;
+
+        data->ink_min_x = origin_x < data->ink_min_x ? origin_x : data->ink_min_x;
+        data->ink_min_y = origin_y < data->ink_min_y ? origin_y : data->ink_min_y;
+        data->ink_max_x = max_x > data->ink_max_x ? max_x : data->ink_max_x;
+        data->ink_max_y = max_y > data->ink_max_y ? max_y : data->ink_max_y;
+    }
+
+    expand_dirty_rect(data, origin_x, origin_y, width, height);
+}
+
+static void restore_history_entry(Widget *canvas, CanvasData *data, const CanvasHistoryEntry *entry)
+{
+    bool was_empty = data->ink_count == 0;
+
+    for (int i = 0; i < entry->block_count; i++)
+    {
+        CanvasTileBlock *block = canvas_history_block(data->history, entry, i);
+
+        if (was_empty && data->ink_count == 0)
+        {
+            // Seed the bounds inside the first tile so the union below starts from it
+            int tiles_x = (canvas->width + CANVAS_TILE_SIZE - 1) / CANVAS_TILE_SIZE;
+            data->ink_min_x = data->ink_max_x = (block->tile % tiles_x) * CANVAS_TILE_SIZE;
+            data->ink_min_y = data->ink_max_y = (block->tile / tiles_x) * CANVAS_TILE_SIZE;
+        }
+
+        swap_tile(canvas, data, block);
+    }
+
+    // The bounds only ever grew above; they are tightened the next time someone asks for them
+    data->ink_bounds_stale = data->ink_count > 0;
+    data->version++;
+
+    widget_mark_dirty(canvas);
+}
+
+static void refresh_ink_bounds(Widget *canvas, CanvasData *data)
+{
+    int min_x = data->ink_max_x;
+    int min_y = data->ink_max_y;
+    int max_x = data->ink_min_x;
+    int max_y = data->ink_min_y;
+
+    for (int py = data->ink_min_y; py <= data->ink_max_y; py++)
+    {
+        const uint8_t *row = &data->pixels[py * canvas->width];
+        for (int px = data->ink_min_x; px <= data->ink_max_x; px++)
+        {
+            if (!row[px])
+                continue;
+
+            min_x = px < min_x ? px : min_x;
+            min_y = py < min_y ? py : min_y;
+            max_x = px > max_x ? px : max_x;
+            max_y = py > max_y ? py : max_y;
+        }
+    }
+
+    data->ink_min_x = min_x;
+    data->ink_min_y = min_y;
+    data->ink_max_x = max_x;
+    data->ink_max_y = max_y;
+    data->ink_bounds_stale = false;
+}
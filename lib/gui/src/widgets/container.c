@@ -1,38 +1,49 @@
 #include "widgets/container.h"
+#include "fixed.h"
+#include "gui_arena.h"
 #include "widgets/widget.h"
 #include <stdlib.h>
 #include <string.h>
 
+#define FLOATING_AMPLITUDE 10
+#define FLOATING_PHASE_STEP 20
+#define MILLIDEGREES_PER_TURN 360000
+
 static void container_render_callback(Widget *widget, Framebuffer *framebuffer);
 static void container_dirty_callback(Widget *widget, Framebuffer *framebuffer);
 static void container_destroy_callback(Widget *widget);
-static void update_hbox_layout(Widget *container);
-static void update_vbox_layout(Widget *container);
+static void update_box_layout(Widget *container, bool horizontal);
 static void update_grid_layout(Widget *container);
-static float sine(float phase, float amplitude);
+static int floating_offset(ContainerData *data, int index, int32_t phase);
+static bool layout_deferred(Widget *container);
+static void request_layout(Widget *container);
+static void flush_layout(Widget *widget);
+static bool is_occluder(Widget *widget);
+static bool is_occluded(Widget *widget, Framebuffer *framebuffer);
+static void cull_widget(Widget *widget, Framebuffer *framebuffer);
+
+const WidgetVTable container_vtable = {
+    .render = container_render_callback,
+    .on_dirty = container_dirty_callback,
+    .destroy = container_destroy_callback,
+};
 
 Widget *container_create(int x, int y, int width, int height, LayoutType layout_type)
 {
-    Widget *container = (Widget *)malloc(sizeof(Widget));
+    Widget *container =
+        widget_create(WIDGET_TYPE_CONTAINER, &container_vtable, sizeof(ContainerData), x, y, width, height);
     if (!container)
         return NULL;
 
-    widget_init(container, WIDGET_TYPE_CONTAINER, x, y, width, height);
-    container->on_dirty = container_dirty_callback;
-
-    ContainerData *data = (ContainerData *)malloc(sizeof(ContainerData));
-    if (!data)
-    {
-        free(container);
-        return NULL;
-    }
-
+    ContainerData *data = (ContainerData *)widget_data(container);
     data->child_capacity = 8;
-    data->children = (Widget **)malloc(sizeof(Widget *) * data->child_capacity);
-    if (!data->children)
+    data->children = (Widget **)gui_alloc(sizeof(Widget *) * data->child_capacity);
+    data->sizes = (int *)gui_alloc(sizeof(int) * data->child_capacity);
+    if (!data->children || !data->sizes)
     {
-        free(data);
-        free(container);
+        gui_free(data->children);
+        gui_free(data->sizes);
+        gui_free(container);
         return NULL;
     }
 
@@ -44,30 +55,135 @@ Widget *container_create(int x, int y, int width, int height, LayoutType layout_
     data->justify = ALIGN_START;
     data->grid_columns = 2;
     data->animation = ANIMATION_NONE;
-    data->animation_phase = 0.0f;
+    data->animation_phase = 0;
     data->animation_speed = 1;
-
-    container->data = data;
-    container->render = container_render_callback;
-    container->destroy = container_destroy_callback;
+    data->bounds_valid = false;
+    data->update_depth = 0;
+    data->measure_valid = false;
+    data->measured_width = 0;
+    data->measured_height = 0;
 
     return container;
 }
 
+// Moving a container only changes its own offset, so the children notice it here: they are flagged so their old
+// screen area is cleared and they are drawn again at the new one.
+static void mark_children_if_moved(Widget *widget, ContainerData *data, Framebuffer *framebuffer)
+{
+    if (framebuffer->origin_x + widget->x == widget->prev_x && framebuffer->origin_y + widget->y == widget->prev_y)
+        return;
+
+    for (int i = 0; i < data->child_count; i++)
+    {
+        if (data->children[i])
+            data->children[i]->dirty = true;
+    }
+}
+
 static void container_render_callback(Widget *widget, Framebuffer *framebuffer)
 {
-    if (!widget || !widget->data)
+    if (!widget || !widget_data(widget))
         return;
 
-    ContainerData *data = (ContainerData *)widget->data;
+    ContainerData *data = (ContainerData *)widget_data(widget);
+
+    mark_children_if_moved(widget, data, framebuffer);
+
+    framebuffer->origin_x += widget->x;
+    framebuffer->origin_y += widget->y;
+
+    // Opaque children drawn this frame are pushed last-first, so the ones above child i are always the top of the
+    // stack. When the stack fills up, the lowest occluders are left out and only cull less.
+    int inherited = framebuffer->occluder_count;
+    int first_pushed = data->child_count;
+    while (first_pushed > 0 && framebuffer->occluder_count < MAX_OCCLUDERS)
+    {
+        Widget *child = data->children[--first_pushed];
+        if (is_occluder(child))
+            framebuffer->occluders[framebuffer->occluder_count++] = (DirtyRect){
+                framebuffer->origin_x + child->x, framebuffer->origin_y + child->y, child->width, child->height};
+    }
 
+    int above = framebuffer->occluder_count - inherited;
     for (int i = 0; i < data->child_count; i++)
     {
-        if (data->children[i])
+        Widget *child = data->children[i];
+        if (!child)
+            continue;
+
+        if (i >= first_pushed && is_occluder(child))
+            above--;
+        framebuffer->occluder_count = inherited + above;
+
+        if (child->visible && child->dirty && is_occluded(child, framebuffer))
+            cull_widget(child, framebuffer);
+        else
+            widget_render(child, framebuffer);
+    }
+
+    framebuffer->occluder_count = inherited;
+    framebuffer->origin_x -= widget->x;
+    framebuffer->origin_y -= widget->y;
+}
+
+static bool is_occluder(Widget *widget)
+{
+    return widget && widget->visible && widget->opaque && widget->dirty && widget->width > 0 && widget->height > 0;
+}
+
+// Tests the widget, or a container's whole subtree, against the occluders of this and every enclosing level
+static bool is_occluded(Widget *widget, Framebuffer *framebuffer)
+{
+    int x = widget->x;
+    int y = widget->y;
+    int width = widget->width;
+    int height = widget->height;
+    if (widget->type == WIDGET_TYPE_CONTAINER)
+        container_get_bounds(widget, &x, &y, &width, &height);
+
+    x += framebuffer->origin_x;
+    y += framebuffer->origin_y;
+
+    for (int i = 0; i < framebuffer->occluder_count; i++)
+    {
+        DirtyRect *occluder = &framebuffer->occluders[i];
+        if (x >= occluder->x && y >= occluder->y && x + width <= occluder->x + occluder->width &&
+            y + height <= occluder->y + occluder->height)
+            return true;
+    }
+
+    return false;
+}
+
+// Brings a hidden subtree up to date as if it had been drawn, so it is neither cleared nor drawn next frame
+static void cull_widget(Widget *widget, Framebuffer *framebuffer)
+{
+    if (!widget->visible)
+    {
+        widget->dirty = false;
+        return;
+    }
+
+    if (widget->type == WIDGET_TYPE_CONTAINER && widget_data(widget))
+    {
+        ContainerData *data = (ContainerData *)widget_data(widget);
+
+        framebuffer->origin_x += widget->x;
+        framebuffer->origin_y += widget->y;
+        for (int i = 0; i < data->child_count; i++)
         {
-            widget_render(data->children[i], framebuffer);
+            if (data->children[i])
+                cull_widget(data->children[i], framebuffer);
         }
+        framebuffer->origin_x -= widget->x;
+        framebuffer->origin_y -= widget->y;
     }
+
+    widget->dirty = false;
+    widget->prev_x = framebuffer->origin_x + widget->x;
+    widget->prev_y = framebuffer->origin_y + widget->y;
+    widget->prev_width = widget->width;
+    widget->prev_height = widget->height;
 }
 
 static void container_dirty_callback(Widget *widget, Framebuffer *framebuffer)
@@ -75,9 +191,15 @@ static void container_dirty_callback(Widget *widget, Framebuffer *framebuffer)
     if (!widget || !widget->dirty)
         return;
 
-    ContainerData *data = (ContainerData *)widget->data;
+    ContainerData *data = (ContainerData *)widget_data(widget);
+
+    if (widget->needs_layout)
+        container_update_layout(widget);
 
-    container_update_layout(widget);
+    mark_children_if_moved(widget, data, framebuffer);
+
+    framebuffer->origin_x += widget->x;
+    framebuffer->origin_y += widget->y;
 
     for (int i = 0; i < data->child_count; i++)
     {
@@ -86,30 +208,37 @@ static void container_dirty_callback(Widget *widget, Framebuffer *framebuffer)
             widget_handle_dirty(data->children[i], framebuffer);
         }
     }
+
+    framebuffer->origin_x -= widget->x;
+    framebuffer->origin_y -= widget->y;
 }
 
 static void container_destroy_callback(Widget *widget)
 {
-    if (!widget || !widget->data)
+    if (!widget || !widget_data(widget))
         return;
 
-    ContainerData *data = (ContainerData *)widget->data;
+    ContainerData *data = (ContainerData *)widget_data(widget);
 
     for (int i = 0; i < data->child_count; i++)
     {
         if (data->children[i])
         {
             widget_destroy(data->children[i]);
-            free(data->children[i]);
+            if (!data->children[i]->preallocated)
+                gui_free(data->children[i]);
             data->children[i] = NULL;
         }
     }
 
-    if (data->children)
+    // A preallocated container's arrays are static as well
+    if (!widget->preallocated)
     {
-        free(data->children);
-        data->children = NULL;
+        gui_free(data->children);
+        gui_free(data->sizes);
     }
+    data->children = NULL;
+    data->sizes = NULL;
 }
 
 void container_add_child(Widget *container, Widget *child)
@@ -117,18 +246,32 @@ void container_add_child(Widget *container, Widget *child)
     if (!container || container->type != WIDGET_TYPE_CONTAINER || !child)
         return;
 
-    ContainerData *data = (ContainerData *)container->data;
+    ContainerData *data = (ContainerData *)widget_data(container);
     if (!data)
         return;
 
     if (data->child_count >= data->child_capacity)
     {
+        if (container->preallocated)
+            return;
+
+        // Both arrays are swapped in together, so a failed allocation leaves the container as it was
         int new_capacity = data->child_capacity * 2;
-        Widget **new_children = (Widget **)realloc(data->children, sizeof(Widget *) * new_capacity);
-        if (!new_children)
+        Widget **new_children = (Widget **)gui_alloc(sizeof(Widget *) * new_capacity);
+        int *new_sizes = (int *)gui_alloc(sizeof(int) * new_capacity);
+        if (!new_children || !new_sizes)
+        {
+            gui_free(new_children);
+            gui_free(new_sizes);
             return;
+        }
 
+        memcpy(new_children, data->children, sizeof(Widget *) * data->child_count);
+        memcpy(new_sizes, data->sizes, sizeof(int) * data->child_count);
+        gui_free(data->children);
+        gui_free(data->sizes);
         data->children = new_children;
+        data->sizes = new_sizes;
         data->child_capacity = new_capacity;
     }
 
@@ -137,17 +280,29 @@ void container_add_child(Widget *container, Widget *child)
 
     child->parent = container;
 
-    container_update_layout(container);
+    widget_invalidate_bounds(container);
+    widget_invalidate_measure(container);
+    request_layout(container);
 }
 
 void container_remove_child(Widget *container, Widget *child)
 {
-    if (!container || container->type != WIDGET_TYPE_CONTAINER || !child)
+    if (!container_detach_child(container, child))
         return;
 
-    ContainerData *data = (ContainerData *)container->data;
+    widget_destroy(child);
+    if (!child->preallocated)
+        gui_free(child);
+}
+
+bool container_detach_child(Widget *container, Widget *child)
+{
+    if (!container || container->type != WIDGET_TYPE_CONTAINER || !child)
+        return false;
+
+    ContainerData *data = (ContainerData *)widget_data(container);
     if (!data)
-        return;
+        return false;
 
     for (int i = 0; i < data->child_count; i++)
     {
@@ -155,19 +310,20 @@ void container_remove_child(Widget *container, Widget *child)
         {
             child->parent = NULL;
 
-            widget_destroy(child);
-            free(child);
-
             for (int j = i; j < data->child_count - 1; j++)
             {
                 data->children[j] = data->children[j + 1];
             }
 
             data->child_count--;
-            container_update_layout(container);
-            return;
+            widget_invalidate_bounds(container);
+            widget_invalidate_measure(container);
+            request_layout(container);
+            return true;
         }
     }
+
+    return false;
 }
 
 void container_clear_children(Widget *container)
@@ -175,7 +331,7 @@ void container_clear_children(Widget *container)
     if (!container || container->type != WIDGET_TYPE_CONTAINER)
         return;
 
-    ContainerData *data = (ContainerData *)container->data;
+    ContainerData *data = (ContainerData *)widget_data(container);
     if (!data)
         return;
 
@@ -186,13 +342,16 @@ void container_clear_children(Widget *container)
             data->children[i]->parent = NULL;
 
             widget_destroy(data->children[i]);
-            free(data->children[i]);
+            if (!data->children[i]->preallocated)
+                gui_free(data->children[i]);
             data->children[i] = NULL;
         }
     }
 
     data->child_count = 0;
-    container_update_layout(container);
+    widget_invalidate_bounds(container);
+    widget_invalidate_measure(container);
+    request_layout(container);
     widget_mark_dirty(container);
 }
 
@@ -201,12 +360,13 @@ void container_set_spacing(Widget *container, int spacing)
     if (!container || container->type != WIDGET_TYPE_CONTAINER)
         return;
 
-    ContainerData *data = (ContainerData *)container->data;
+    ContainerData *data = (ContainerData *)widget_data(container);
     if (!data)
         return;
 
     data->spacing = spacing;
-    container_update_layout(container);
+    widget_invalidate_measure(container);
+    request_layout(container);
     widget_mark_dirty(container);
 }
 
@@ -215,12 +375,13 @@ void container_set_padding(Widget *container, int padding)
     if (!container || container->type != WIDGET_TYPE_CONTAINER)
         return;
 
-    ContainerData *data = (ContainerData *)container->data;
+    ContainerData *data = (ContainerData *)widget_data(container);
     if (!data)
         return;
 
     data->padding = padding;
-    container_update_layout(container);
+    widget_invalidate_measure(container);
+    request_layout(container);
     widget_mark_dirty(container);
 }
 
@@ -229,12 +390,12 @@ void container_set_alignment(Widget *container, Alignment alignment)
     if (!container || container->type != WIDGET_TYPE_CONTAINER)
         return;
 
-    ContainerData *data = (ContainerData *)container->data;
+    ContainerData *data = (ContainerData *)widget_data(container);
     if (!data)
         return;
 
     data->alignment = alignment;
-    container_update_layout(container);
+    request_layout(container);
     widget_mark_dirty(container);
 }
 
@@ -243,12 +404,12 @@ void container_set_justify(Widget *container, Alignment justify)
     if (!container || container->type != WIDGET_TYPE_CONTAINER)
         return;
 
-    ContainerData *data = (ContainerData *)container->data;
+    ContainerData *data = (ContainerData *)widget_data(container);
     if (!data)
         return;
 
     data->justify = justify;
-    container_update_layout(container);
+    request_layout(container);
     widget_mark_dirty(container);
 }
 
@@ -257,12 +418,13 @@ void container_set_grid_columns(Widget *container, int columns)
     if (!container || container->type != WIDGET_TYPE_CONTAINER)
         return;
 
-    ContainerData *data = (ContainerData *)container->data;
+    ContainerData *data = (ContainerData *)widget_data(container);
     if (!data)
         return;
 
     data->grid_columns = columns > 0 ? columns : 1;
-    container_update_layout(container);
+    widget_invalidate_measure(container);
+    request_layout(container);
 }
 
 void container_update_layout(Widget *container)
@@ -270,7 +432,7 @@ void container_update_layout(Widget *container)
     if (!container || container->type != WIDGET_TYPE_CONTAINER)
         return;
 
-    ContainerData *data = (ContainerData *)container->data;
+    ContainerData *data = (ContainerData *)widget_data(container);
     if (!data)
         return;
 
@@ -279,20 +441,61 @@ void container_update_layout(Widget *container)
     case LAYOUT_TYPE_NONE:
         break;
     case LAYOUT_TYPE_HBOX:
-        update_hbox_layout(container);
+        update_box_layout(container, true);
         break;
     case LAYOUT_TYPE_VBOX:
-        update_vbox_layout(container);
+        update_box_layout(container, false);
         break;
     case LAYOUT_TYPE_GRID:
         update_grid_layout(container);
         break;
     }
+
+    // Cleared last, since resizing the children above flags their parent again
+    container->needs_layout = false;
+}
+
+static int clamp_size(int size, int min, int max)
+{
+    if (max > 0 && size > max)
+        size = max;
+    if (size < min)
+        size = min;
+    return size;
+}
+
+static int flex_weight(Widget *child, bool horizontal)
+{
+    if (child->layout.flex > 0)
+        return child->layout.flex;
+
+    int preferred = horizontal ? child->layout.preferred_width : child->layout.preferred_height;
+    return preferred == 0 ? 1 : 0;
+}
+
+// Moves and resizes a child without touching its preferred size, so layout never feeds on its own output.
+// A child container that changed is laid out right away, which settles nested layouts in one traversal.
+static void place_child(Widget *child, int x, int y, int width, int height)
+{
+    if (child->x != x || child->y != y || child->width != width || child->height != height)
+    {
+        child->x = x;
+        child->y = y;
+        child->width = width;
+        child->height = height;
+        if (child->type == WIDGET_TYPE_CONTAINER)
+            child->needs_layout = true;
+        widget_invalidate_bounds(child);
+        widget_mark_dirty(child);
+    }
+
+    if (child->type == WIDGET_TYPE_CONTAINER && child->needs_layout)
+        container_update_layout(child);
 }
 
-static void update_hbox_layout(Widget *container)
+static void update_box_layout(Widget *container, bool horizontal)
 {
-    ContainerData *data = (ContainerData *)container->data;
+    ContainerData *data = (ContainerData *)widget_data(container);
     if (!data || data->child_count == 0)
         return;
 
@@ -308,142 +511,103 @@ static void update_hbox_layout(Widget *container)
     if (visible_count == 0)
         return;
 
-    int available_width = container->width - (2 * data->padding) - ((visible_count - 1) * data->spacing);
-    int available_height = container->height - (2 * data->padding);
-
-    int total_fixed_width = 0;
-    int flexible_count = 0;
+    int container_main = horizontal ? container->width : container->height;
+    int container_cross = horizontal ? container->height : container->width;
+    int available_main = container_main - (2 * data->padding) - ((visible_count - 1) * data->spacing);
+    int available_cross = container_cross - (2 * data->padding);
 
+    // Measure: children without a flex weight get their clamped intrinsic size and are final.
+    // Flexible children are marked -1 until the free space has been shared out.
     for (int i = 0; i < data->child_count; i++)
     {
         Widget *child = data->children[i];
         if (!child->visible)
             continue;
 
-        if (child->width > 0)
-        {
-            total_fixed_width += child->width;
-        }
-        else
+        if (flex_weight(child, horizontal) > 0)
         {
-            flexible_count++;
+            data->sizes[i] = -1;
+            continue;
         }
-    }
 
-    int flexible_width = flexible_count > 0 ? (available_width - total_fixed_width) / flexible_count : 0;
-
-    int total_content_width =
-        total_fixed_width + (flexible_count * flexible_width) + ((visible_count - 1) * data->spacing);
-
-    int current_x = container->x + data->padding;
-    if (data->justify == ALIGN_CENTER && total_content_width < available_width)
-    {
-        current_x = container->x + (container->width - total_content_width) / 2;
-    }
-    else if (data->justify == ALIGN_END && total_content_width < available_width)
-    {
-        current_x = container->x + container->width - data->padding - total_content_width;
+        int measured_width, measured_height;
+        widget_measure(child, &measured_width, &measured_height);
+        data->sizes[i] = horizontal ? clamp_size(measured_width, child->layout.min_width, child->layout.max_width)
+                                    : clamp_size(measured_height, child->layout.min_height, child->layout.max_height);
     }
 
-    for (int i = 0; i < data->child_count; i++)
+    // Arrange: share the free space by weight. A child whose share breaks its min or max is fixed at the
+    // limit and the rest is shared again, so every round settles at least one child.
+    for (int round = 0; round < visible_count; round++)
     {
-        Widget *child = data->children[i];
-        if (!child->visible)
-            continue;
-
-        int child_width = child->width > 0 ? child->width : flexible_width;
-        int child_height;
-        int child_y;
+        int free_space = available_main;
+        int total_weight = 0;
 
-        if (data->alignment == ALIGN_STRETCH)
-        {
-            child_height = available_height;
-            child_y = container->y + data->padding;
-        }
-        else
+        for (int i = 0; i < data->child_count; i++)
         {
-            child_height = child->height > 0 ? child->height : available_height;
+            if (!data->children[i]->visible)
+                continue;
 
-            if (data->alignment == ALIGN_CENTER)
-            {
-                child_y = container->y + data->padding + (available_height - child_height) / 2;
-            }
-            else if (data->alignment == ALIGN_END)
-            {
-                child_y = container->y + data->padding + available_height - child_height;
-            }
-            else // ALIGN_START
-            {
-                child_y = container->y + data->padding;
-            }
+            if (data->sizes[i] >= 0)
+                free_space -= data->sizes[i];
+            else
+                total_weight += flex_weight(data->children[i], horizontal);
         }
 
-        if (data->animation == ANIMATION_FLOATING)
+        if (total_weight == 0)
+            break;
+        if (free_space < 0)
+            free_space = 0;
+
+        bool clamped = false;
+        for (int pass = 0; pass < 2 && !clamped; pass++)
         {
-            float phase_diff = 20.0f;
-            child_y += sine(data->animation_phase + i * phase_diff, 10.0f);
+            int weight_before = 0;
+            for (int i = 0; i < data->child_count; i++)
+            {
+                Widget *child = data->children[i];
+                if (!child->visible || data->sizes[i] >= 0)
+                    continue;
+
+                // Cumulative rounding hands out every pixel of the free space exactly once
+                int weight = flex_weight(child, horizontal);
+                int share = free_space * (weight_before + weight) / total_weight -
+                            free_space * weight_before / total_weight;
+                weight_before += weight;
+
+                int limited = horizontal ? clamp_size(share, child->layout.min_width, child->layout.max_width)
+                                         : clamp_size(share, child->layout.min_height, child->layout.max_height);
+                if (pass == 0 && limited != share)
+                {
+                    data->sizes[i] = limited;
+                    clamped = true;
+                }
+                else if (pass == 1)
+                {
+                    data->sizes[i] = share;
+                }
+            }
         }
 
-        widget_set_position(child, current_x, child_y);
-        widget_set_size(child, child_width, child_height);
-
-        current_x += child_width + data->spacing;
+        if (!clamped)
+            break;
     }
-}
 
-static void update_vbox_layout(Widget *container)
-{
-    ContainerData *data = (ContainerData *)container->data;
-    if (!data || data->child_count == 0)
-        return;
-
-    int visible_count = 0;
+    int total_content = (visible_count - 1) * data->spacing;
     for (int i = 0; i < data->child_count; i++)
     {
         if (data->children[i]->visible)
-        {
-            visible_count++;
-        }
-    }
-
-    if (visible_count == 0)
-        return;
-
-    int available_width = container->width - (2 * data->padding);
-    int available_height = container->height - (2 * data->padding) - ((visible_count - 1) * data->spacing);
-
-    int total_fixed_height = 0;
-    int flexible_count = 0;
-
-    for (int i = 0; i < data->child_count; i++)
-    {
-        Widget *child = data->children[i];
-        if (!child->visible)
-            continue;
-
-        if (child->height > 0)
-        {
-            total_fixed_height += child->height;
-        }
-        else
-        {
-            flexible_count++;
-        }
+            total_content += data->sizes[i] > 0 ? data->sizes[i] : 0;
     }
 
-    int flexible_height = flexible_count > 0 ? (available_height - total_fixed_height) / flexible_count : 0;
-
-    int total_content_height =
-        total_fixed_height + (flexible_count * flexible_height) + ((visible_count - 1) * data->spacing);
-
-    int current_y = container->y + data->padding;
-    if (data->justify == ALIGN_CENTER && total_content_height < available_height)
+    int current = data->padding;
+    if (data->justify == ALIGN_CENTER && total_content < available_main)
     {
-        current_y = container->y + (container->height - total_content_height) / 2;
+        current = (container_main - total_content) / 2;
     }
-    else if (data->justify == ALIGN_END && total_content_height < available_height)
+    else if (data->justify == ALIGN_END && total_content < available_main)
     {
-        current_y = container->y + container->height - data->padding - total_content_height;
+        current = container_main - data->padding - total_content;
     }
 
     for (int i = 0; i < data->child_count; i++)
@@ -452,43 +616,45 @@ static void update_vbox_layout(Widget *container)
         if (!child->visible)
             continue;
 
-        int child_height = child->height > 0 ? child->height : flexible_height;
-        int child_width;
-        int child_x;
+        int main_size = data->sizes[i] > 0 ? data->sizes[i] : 0;
+
+        int measured_width, measured_height;
+        widget_measure(child, &measured_width, &measured_height);
+        int cross_min = horizontal ? child->layout.min_height : child->layout.min_width;
+        int cross_max = horizontal ? child->layout.max_height : child->layout.max_width;
+        int cross_measured = horizontal ? measured_height : measured_width;
+        int cross_preferred = horizontal ? child->layout.preferred_height : child->layout.preferred_width;
 
-        if (data->alignment == ALIGN_STRETCH)
+        int cross_size = available_cross;
+        if (data->alignment != ALIGN_STRETCH && cross_preferred > 0)
+            cross_size = cross_measured;
+        cross_size = clamp_size(cross_size, cross_min, cross_max);
+
+        int cross = data->padding;
+        if (data->alignment == ALIGN_CENTER)
         {
-            child_width = available_width;
-            child_x = container->x + data->padding;
+            cross += (available_cross - cross_size) / 2;
         }
-        else
+        else if (data->alignment == ALIGN_END)
         {
-            child_width = child->width > 0 ? child->width : available_width;
-
-            if (data->alignment == ALIGN_CENTER)
-            {
-                child_x = container->x + data->padding + (available_width - child_width) / 2;
-            }
-            else if (data->alignment == ALIGN_END)
-            {
-                child_x = container->x + data->padding + available_width - child_width;
-            }
-            else // ALIGN_START
-            {
-                child_x = container->x + data->padding;
-            }
+            cross += available_cross - cross_size;
         }
 
-        widget_set_position(child, child_x, current_y);
-        widget_set_size(child, child_width, child_height);
+        if (horizontal)
+            cross += floating_offset(data, i, data->animation_phase);
+
+        if (horizontal)
+            place_child(child, current, cross, main_size, cross_size);
+        else
+            place_child(child, cross, current, cross_size, main_size);
 
-        current_y += child_height + data->spacing;
+        current += main_size + data->spacing;
     }
 }
 
 static void update_grid_layout(Widget *container)
 {
-    ContainerData *data = (ContainerData *)container->data;
+    ContainerData *data = (ContainerData *)widget_data(container);
     if (!data || data->child_count == 0)
         return;
 
@@ -508,41 +674,239 @@ static void update_grid_layout(Widget *container)
         int row = i / columns;
         int col = i % columns;
 
-        int child_x = container->x + data->padding + col * (cell_width + data->spacing);
-        int child_y = container->y + data->padding + row * (cell_height + data->spacing);
+        int child_x = data->padding + col * (cell_width + data->spacing);
+        int child_y = data->padding + row * (cell_height + data->spacing);
+
+        int measured_width, measured_height;
+        widget_measure(child, &measured_width, &measured_height);
 
         int child_width = cell_width;
         int child_height = cell_height;
 
-        if (data->alignment == ALIGN_STRETCH)
-        {
-            child_width = cell_width;
-            child_height = cell_height;
-        }
-        else if (data->alignment == ALIGN_CENTER)
+        if (data->alignment == ALIGN_CENTER)
         {
-            if (child->width > 0 && child->width < cell_width)
+            if (measured_width > 0 && measured_width < cell_width)
             {
-                child_x += (cell_width - child->width) / 2;
-                child_width = child->width;
+                child_x += (cell_width - measured_width) / 2;
+                child_width = measured_width;
             }
-            if (child->height > 0 && child->height < cell_height)
+            if (measured_height > 0 && measured_height < cell_height)
             {
-                child_y += (cell_height - child->height) / 2;
-                child_height = child->height;
+                child_y += (cell_height - measured_height) / 2;
+                child_height = measured_height;
             }
         }
-        else
+        else if (data->alignment != ALIGN_STRETCH)
+        {
+            if (measured_width > 0)
+                child_width = measured_width;
+            if (measured_height > 0)
+                child_height = measured_height;
+        }
+
+        child_width = clamp_size(child_width, child->layout.min_width, child->layout.max_width);
+        child_height = clamp_size(child_height, child->layout.min_height, child->layout.max_height);
+
+        place_child(child, child_x, child_y, child_width, child_height);
+    }
+}
+
+// Intrinsic size of the content, cached until a child or a setting that affects it changes. An explicit
+// preferred size on the container itself wins over the content.
+void container_measure(Widget *container, int *width, int *height)
+{
+    if (!container || container->type != WIDGET_TYPE_CONTAINER || !width || !height)
+        return;
+
+    ContainerData *data = (ContainerData *)widget_data(container);
+    if (!data)
+        return;
+
+    if (!data->measure_valid)
+    {
+        int content_width = 0;
+        int content_height = 0;
+        int counted = 0;
+
+        for (int i = 0; i < data->child_count; i++)
+        {
+            Widget *child = data->children[i];
+            if (!child->visible && data->layout_type != LAYOUT_TYPE_GRID)
+                continue;
+
+            int child_width, child_height;
+            widget_measure(child, &child_width, &child_height);
+            child_width = clamp_size(child_width, child->layout.min_width, child->layout.max_width);
+            child_height = clamp_size(child_height, child->layout.min_height, child->layout.max_height);
+
+            switch (data->layout_type)
+            {
+            case LAYOUT_TYPE_HBOX:
+                content_width += child_width;
+                content_height = child_height > content_height ? child_height : content_height;
+                break;
+            case LAYOUT_TYPE_VBOX:
+                content_height += child_height;
+                content_width = child_width > content_width ? child_width : content_width;
+                break;
+            case LAYOUT_TYPE_GRID:
+            case LAYOUT_TYPE_NONE:
+                content_width = child_width > content_width ? child_width : content_width;
+                content_height = child_height > content_height ? child_height : content_height;
+                break;
+            }
+            counted++;
+        }
+
+        if (data->layout_type == LAYOUT_TYPE_HBOX && counted > 1)
+        {
+            content_width += (counted - 1) * data->spacing;
+        }
+        else if (data->layout_type == LAYOUT_TYPE_VBOX && counted > 1)
+        {
+            content_height += (counted - 1) * data->spacing;
+        }
+        else if (data->layout_type == LAYOUT_TYPE_GRID && counted > 0)
+        {
+            int columns = counted < data->grid_columns ? counted : data->grid_columns;
+            int rows = (counted + data->grid_columns - 1) / data->grid_columns;
+            content_width = columns * content_width + (columns - 1) * data->spacing;
+            content_height = rows * content_height + (rows - 1) * data->spacing;
+        }
+
+        if (counted > 0)
         {
-            if (child->width > 0)
-                child_width = child->width;
-            if (child->height > 0)
-                child_height = child->height;
+            content_width += 2 * data->padding;
+            content_height += 2 * data->padding;
         }
 
-        widget_set_position(child, child_x, child_y);
-        widget_set_size(child, child_width, child_height);
+        data->measured_width =
+            container->layout.preferred_width > 0 ? container->layout.preferred_width : content_width;
+        data->measured_height =
+            container->layout.preferred_height > 0 ? container->layout.preferred_height : content_height;
+        data->measure_valid = true;
     }
+
+    *width = data->measured_width;
+    *height = data->measured_height;
+}
+
+// Between begin and end, mutations of the container or anything below it only flag the affected containers.
+// The outermost end_update then lays each flagged container out once. Calls may nest.
+void container_begin_update(Widget *container)
+{
+    if (!container || container->type != WIDGET_TYPE_CONTAINER)
+        return;
+
+    ContainerData *data = (ContainerData *)widget_data(container);
+    if (!data)
+        return;
+
+    data->update_depth++;
+}
+
+void container_end_update(Widget *container)
+{
+    if (!container || container->type != WIDGET_TYPE_CONTAINER)
+        return;
+
+    ContainerData *data = (ContainerData *)widget_data(container);
+    if (!data || data->update_depth == 0)
+        return;
+
+    data->update_depth--;
+
+    if (!layout_deferred(container))
+        flush_layout(container);
+}
+
+static bool layout_deferred(Widget *container)
+{
+    for (Widget *current = container; current; current = current->parent)
+    {
+        ContainerData *data = current->type == WIDGET_TYPE_CONTAINER ? (ContainerData *)widget_data(current) : NULL;
+        if (data && data->update_depth > 0)
+            return true;
+    }
+
+    return false;
+}
+
+static void request_layout(Widget *container)
+{
+    if (layout_deferred(container))
+        widget_mark_layout_dirty(container);
+    else
+        container_update_layout(container);
+}
+
+// Parents first, since laying out a parent resizes its children and flags them in turn
+static void flush_layout(Widget *widget)
+{
+    if (!widget || widget->type != WIDGET_TYPE_CONTAINER)
+        return;
+
+    ContainerData *data = (ContainerData *)widget_data(widget);
+    if (!data)
+        return;
+
+    if (widget->needs_layout)
+        container_update_layout(widget);
+
+    for (int i = 0; i < data->child_count; i++)
+    {
+        flush_layout(data->children[i]);
+    }
+}
+
+// Union of the container and everything below it, relative to the container's parent. The union is cached in the
+// container's own space, so it survives the container moving and is only dropped when a descendant changes.
+void container_get_bounds(Widget *container, int *x, int *y, int *width, int *height)
+{
+    if (!container || container->type != WIDGET_TYPE_CONTAINER || !x || !y || !width || !height)
+        return;
+
+    ContainerData *data = (ContainerData *)widget_data(container);
+    if (!data)
+        return;
+
+    if (!data->bounds_valid)
+    {
+        int left = 0;
+        int top = 0;
+        int right = container->width;
+        int bottom = container->height;
+
+        for (int i = 0; i < data->child_count; i++)
+        {
+            Widget *child = data->children[i];
+            if (!child)
+                continue;
+
+            int child_x = child->x;
+            int child_y = child->y;
+            int child_width = child->width;
+            int child_height = child->height;
+            if (child->type == WIDGET_TYPE_CONTAINER)
+                container_get_bounds(child, &child_x, &child_y, &child_width, &child_height);
+
+            left = child_x < left ? child_x : left;
+            top = child_y < top ? child_y : top;
+            right = child_x + child_width > right ? child_x + child_width : right;
+            bottom = child_y + child_height > bottom ? child_y + child_height : bottom;
+        }
+
+        data->bounds_x = left;
+        data->bounds_y = top;
+        data->bounds_width = right - left;
+        data->bounds_height = bottom - top;
+        data->bounds_valid = true;
+    }
+
+    *x = container->x + data->bounds_x;
+    *y = container->y + data->bounds_y;
+    *width = data->bounds_width;
+    *height = data->bounds_height;
 }
 
 int container_get_child_count(Widget *container)
@@ -550,7 +914,7 @@ int container_get_child_count(Widget *container)
     if (!container || container->type != WIDGET_TYPE_CONTAINER)
         return 0;
 
-    ContainerData *data = (ContainerData *)container->data;
+    ContainerData *data = (ContainerData *)widget_data(container);
     if (!data)
         return 0;
 
@@ -562,21 +926,22 @@ Widget *container_get_child(Widget *container, int index)
     if (!container || container->type != WIDGET_TYPE_CONTAINER)
         return NULL;
 
-    ContainerData *data = (ContainerData *)container->data;
+    ContainerData *data = (ContainerData *)widget_data(container);
     if (!data || index < 0 || index >= data->child_count)
         return NULL;
 
     return data->children[index];
 }
 
-static float sine(float phase, float amplitude)
+static int floating_offset(ContainerData *data, int index, int32_t phase)
 {
-    phase -= 360 * (int)(phase / 360.0f);
-
-    if (phase < 180)
-        return amplitude / 8100.0f * (180.0f * phase - phase * phase);
+    if (data->animation != ANIMATION_FLOATING)
+        return 0;
 
-    return amplitude / 8100.0f * (phase - 180.0f) * (phase - 360.0f);
+    // 360000 millidegrees map onto the 65536 binary angle units of a turn
+    uint16_t angle = (uint16_t)(phase * 2048 / 11250);
+    angle += ANGLE_FROM_DEGREES(index * FLOATING_PHASE_STEP);
+    return Q16_ROUND(FLOATING_AMPLITUDE * q16_sin(angle));
 }
 
 void container_set_animation(Widget *container, AnimationType animation)
@@ -584,12 +949,12 @@ void container_set_animation(Widget *container, AnimationType animation)
     if (!container || container->type != WIDGET_TYPE_CONTAINER)
         return;
 
-    ContainerData *data = (ContainerData *)container->data;
+    ContainerData *data = (ContainerData *)widget_data(container);
     if (!data)
         return;
 
     data->animation = animation;
-    container_update_layout(container);
+    request_layout(container);
     widget_mark_dirty(container);
 }
 
@@ -598,29 +963,44 @@ void container_set_animation_speed(Widget *container, int speed)
     if (!container || container->type != WIDGET_TYPE_CONTAINER)
         return;
 
-    ContainerData *data = (ContainerData *)container->data;
+    ContainerData *data = (ContainerData *)widget_data(container);
     if (!data)
         return;
 
     data->animation_speed = speed > 0 ? speed : 1;
 }
 
-void container_update_animation(Widget *container, float delta_time)
+void container_update_animation(Widget *container, int delta_ms)
 {
-    if (!container || container->type != WIDGET_TYPE_CONTAINER)
+    if (!container || container->type != WIDGET_TYPE_CONTAINER || delta_ms < 0)
         return;
 
-    ContainerData *data = (ContainerData *)container->data;
+    ContainerData *data = (ContainerData *)widget_data(container);
     if (!data)
         return;
 
     if (data->animation == ANIMATION_NONE)
         return;
 
-    float phase_increment = data->animation_speed * delta_time;
-    data->animation_phase += phase_increment;
-    if (data->animation_phase >= 360.0f)
-        data->animation_phase -= 360.0f;
+    int32_t previous_phase = data->animation_phase;
+    data->animation_phase = (int32_t)((data->animation_phase + (int64_t)data->animation_speed * delta_ms) %
+                                      MILLIDEGREES_PER_TURN);
+
+    if (data->layout_type != LAYOUT_TYPE_HBOX || container->needs_layout)
+    {
+        container_update_layout(container);
+        return;
+    }
 
-    container_update_layout(container);
+    // The layout itself is unchanged, so each child is only nudged by the change in its offset
+    for (int i = 0; i < data->child_count; i++)
+    {
+        Widget *child = data->children[i];
+        if (!child->visible)
+            continue;
+
+        int delta = floating_offset(data, i, data->animation_phase) - floating_offset(data, i, previous_phase);
+        if (delta != 0)
+            widget_set_position(child, child->x, child->y + delta);
+    }
 }
@@ -1,4 +1,5 @@
 #include "widgets/image_widget.h"
+#include "gui_arena.h"
 #include "primitives/image.h"
 #include "primitives/rectangle.h"
 #include <stdlib.h>
@@ -6,57 +7,54 @@
 static void image_widget_render_callback(Widget *widget, Framebuffer *framebuffer);
 static void image_widget_destroy_callback(Widget *widget);
 
+const WidgetVTable image_widget_vtable = {
+    .render = image_widget_render_callback,
+    .destroy = image_widget_destroy_callback,
+};
+
 Widget *image_widget_create(int x, int y, const Image *image)
 {
-    Widget *image_widget = (Widget *)malloc(sizeof(Widget));
-    if (!image_widget)
-        return NULL;
-
     int width = image ? image->width : 0;
     int height = image ? image->height : 0;
 
-    widget_init(image_widget, WIDGET_TYPE_IMAGE, x, y, width, height);
-
-    ImageWidgetData *data = (ImageWidgetData *)malloc(sizeof(ImageWidgetData));
-    if (!data)
-    {
-        free(image_widget);
+    Widget *image_widget =
+        widget_create(WIDGET_TYPE_IMAGE, &image_widget_vtable, sizeof(ImageWidgetData), x, y, width, height);
+    if (!image_widget)
         return NULL;
-    }
+
+    ImageWidgetData *data = (ImageWidgetData *)widget_data(image_widget);
 
     data->image = image;
     data->border_color = COLOR_BLACK;
     data->border_thickness = 0;
 
-    image_widget->data = data;
-    image_widget->render = image_widget_render_callback;
-    image_widget->destroy = image_widget_destroy_callback;
-
     return image_widget;
 }
 
 static void image_widget_render_callback(Widget *widget, Framebuffer *framebuffer)
 {
-    ImageWidgetData *data = (ImageWidgetData *)widget->data;
+    ImageWidgetData *data = (ImageWidgetData *)widget_data(widget);
+    int x = framebuffer->origin_x + widget->x;
+    int y = framebuffer->origin_y + widget->y;
 
     if (data->image)
     {
-        renderImage(widget->x, widget->y, data->image, framebuffer);
+        renderImage(x, y, data->image, framebuffer);
     }
 
     if (data->border_thickness > 0)
     {
         for (int i = 0; i < data->border_thickness; i++)
         {
-            renderRectangle(widget->x - i, widget->y - i, widget->width + 2 * i, widget->height + 2 * i,
-                            data->border_color, data->border_thickness, framebuffer);
+            renderRectangle(x - i, y - i, widget->width + 2 * i, widget->height + 2 * i, data->border_color,
+                            data->border_thickness, framebuffer);
         }
     }
 }
 
 static void image_widget_destroy_callback(Widget *widget)
 {
-    ImageWidgetData *data = (ImageWidgetData *)widget->data;
+    ImageWidgetData *data = (ImageWidgetData *)widget_data(widget);
     if (data)
     {
         data->image = NULL;
@@ -68,7 +66,7 @@ void image_widget_set_border(Widget *image_widget, Color color, int thickness)
     if (!image_widget || image_widget->type != WIDGET_TYPE_IMAGE)
         return;
 
-    ImageWidgetData *data = (ImageWidgetData *)image_widget->data;
+    ImageWidgetData *data = (ImageWidgetData *)widget_data(image_widget);
     data->border_color = color;
     data->border_thickness = thickness;
 
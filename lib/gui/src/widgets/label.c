@@ -1,6 +1,7 @@
 #include "widgets/label.h"
 #include "color.h"
 #include "framebuffer.h"
+#include "gui_arena.h"
 #include "primitives/text.h"
 #include "widgets/widget.h"
 #include <stdlib.h>
@@ -9,58 +10,57 @@
 static void label_render_callback(Widget *widget, Framebuffer *framebuffer);
 static void label_destroy_callback(Widget *widget);
 
+const WidgetVTable label_vtable = {
+    .render = label_render_callback,
+    .destroy = label_destroy_callback,
+};
+
 Widget *label_create(int x, int y, const char *text)
 {
-    Widget *label = (Widget *)malloc(sizeof(Widget));
-    if (!label)
-        return NULL;
+    return label_create_buffered(x, y, text, 0);
+}
 
-    widget_init(label, WIDGET_TYPE_LABEL, x, y, 0, 0);
+// The text buffer is reserved inline after the label's data, so setting text never allocates
+Widget *label_create_buffered(int x, int y, const char *text, int capacity)
+{
+    if (capacity < 0)
+        capacity = 0;
 
-    LabelData *data = (LabelData *)malloc(sizeof(LabelData));
-    if (!data)
-    {
-        free(label);
+    Widget *label = widget_create(WIDGET_TYPE_LABEL, &label_vtable, sizeof(LabelData) + capacity, x, y, 0, 0);
+    if (!label)
         return NULL;
-    }
 
-    data->text = text ? strdup(text) : NULL;
+    LabelData *data = (LabelData *)widget_data(label);
+    widget_text_init(&data->text, (char *)(data + 1), capacity);
+    widget_text_set(&data->text, text);
     data->text_color = COLOR_WHITE;
     data->font = NULL;
 
-    label->data = data;
-
-    label->render = label_render_callback;
-    label->destroy = label_destroy_callback;
-
     return label;
 }
 
 static void label_render_callback(Widget *widget, Framebuffer *framebuffer)
 {
-    if (!widget || !widget->data)
+    if (!widget || !widget_data(widget))
         return;
 
-    LabelData *data = (LabelData *)widget->data;
+    LabelData *data = (LabelData *)widget_data(widget);
 
-    if (data->text && data->font)
+    if (data->text.value && data->font)
     {
-        renderText(data->text, data->text_color, widget->x, widget->y, data->font, framebuffer);
+        int x = framebuffer->origin_x + widget->x;
+        int y = framebuffer->origin_y + widget->y;
+        renderText(data->text.value, data->text_color, x, y, data->font, framebuffer);
     }
 }
 
 static void label_destroy_callback(Widget *widget)
 {
-    if (!widget || !widget->data)
+    if (!widget || !widget_data(widget))
         return;
 
-    LabelData *data = (LabelData *)widget->data;
-
-    if (data->text)
-    {
-        free(data->text);
-        data->text = NULL;
-    }
+    LabelData *data = (LabelData *)widget_data(widget);
+    widget_text_release(&data->text);
 }
 
 void label_set_text(Widget *label, const char *text)
@@ -68,16 +68,29 @@ void label_set_text(Widget *label, const char *text)
     if (!label || label->type != WIDGET_TYPE_LABEL)
         return;
 
-    LabelData *data = (LabelData *)label->data;
+    LabelData *data = (LabelData *)widget_data(label);
     if (!data)
         return;
 
-    if (data->text)
-    {
-        free(data->text);
-    }
+    if (!widget_text_set(&data->text, text))
+        return;
+
+    label_auto_size(label);
+    widget_mark_dirty(label);
+}
+
+void label_set_static_text(Widget *label, const char *text)
+{
+    if (!label || label->type != WIDGET_TYPE_LABEL)
+        return;
+
+    LabelData *data = (LabelData *)widget_data(label);
+    if (!data)
+        return;
+
+    if (!widget_text_borrow(&data->text, text))
+        return;
 
-    data->text = text ? strdup(text) : NULL;
     label_auto_size(label);
     widget_mark_dirty(label);
 }
@@ -87,10 +100,13 @@ void label_set_color(Widget *label, Color color)
     if (!label || label->type != WIDGET_TYPE_LABEL)
         return;
 
-    LabelData *data = (LabelData *)label->data;
+    LabelData *data = (LabelData *)widget_data(label);
     if (!data)
         return;
 
+    if (COLOR_COMPARE(data->text_color, color))
+        return;
+
     data->text_color = color;
     widget_mark_dirty(label);
 }
@@ -100,7 +116,7 @@ void label_set_font(Widget *label, const bdf_font_t *font)
     if (!label || label->type != WIDGET_TYPE_LABEL)
         return;
 
-    LabelData *data = (LabelData *)label->data;
+    LabelData *data = (LabelData *)widget_data(label);
     if (!data)
         return;
 
@@ -113,11 +129,11 @@ const char *label_get_text(Widget *label)
     if (!label || label->type != WIDGET_TYPE_LABEL)
         return NULL;
 
-    LabelData *data = (LabelData *)label->data;
+    LabelData *data = (LabelData *)widget_data(label);
     if (!data)
         return NULL;
 
-    return data->text;
+    return data->text.value;
 }
 
 void label_auto_size(Widget *label)
@@ -125,16 +141,26 @@ void label_auto_size(Widget *label)
     if (!label || label->type != WIDGET_TYPE_LABEL)
         return;
 
-    LabelData *data = (LabelData *)label->data;
-    if (!data || !data->font || !data->text)
+    LabelData *data = (LabelData *)widget_data(label);
+    if (!data || !data->font || !data->text.value)
         return;
 
-    int text_width = measureTextWidth(data->text, data->font);
+    int text_width = measureTextWidth(data->text.value, data->font);
     int text_height = getFontHeight(data->font);
 
+    if (label->width == text_width && label->height == text_height &&
+        label->layout.preferred_width == text_width && label->layout.preferred_height == text_height)
+        return;
+
     label->width = text_width;
     label->height = text_height;
 
+    label->layout.preferred_width = label->width;
+    label->layout.preferred_height = label->height;
+
+    widget_invalidate_bounds(label);
+    widget_invalidate_measure(label);
+    widget_mark_layout_dirty(label->parent);
     widget_mark_dirty(label);
 }
 
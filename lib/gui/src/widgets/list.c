@@ -0,0 +1,308 @@
+#include "widgets/list.h"
+#include "gui_arena.h"
+#include "primitives/rectangle.h"
+#include <stdlib.h>
+
+static void list_render_callback(Widget *widget, Framebuffer *framebuffer);
+static void list_dirty_callback(Widget *widget, Framebuffer *framebuffer);
+static void list_expose_callback(Widget *widget);
+static void list_destroy_callback(Widget *widget);
+static bool ensure_rows(Widget *list, ListData *data);
+static void bind_visible_rows(Widget *list, ListData *data, bool rebind);
+static void draw_band(Widget *list, ListData *data, Framebuffer *framebuffer, int top, int bottom);
+
+static const WidgetVTable list_vtable = {
+    .render = list_render_callback,
+    .on_dirty = list_dirty_callback,
+    .on_expose = list_expose_callback,
+    .destroy = list_destroy_callback,
+};
+
+Widget *list_create(int x, int y, int width, int height, int row_height, ListRowFactory create_row,
+                    ListBindCallback bind_row, void *user_data)
+{
+    if (row_height <= 0 || !create_row || !bind_row)
+        return NULL;
+
+    Widget *list = widget_create(WIDGET_TYPE_LIST, &list_vtable, sizeof(ListData), x, y, width, height);
+    if (!list)
+        return NULL;
+
+    ListData *data = (ListData *)widget_data(list);
+    data->create_row = create_row;
+    data->bind_row = bind_row;
+    data->user_data = user_data;
+    data->row_height = row_height;
+    data->full_redraw = true;
+
+    return list;
+}
+
+static void list_dirty_callback(Widget *widget, Framebuffer *framebuffer)
+{
+    if (!widget || !framebuffer)
+        return;
+
+    ListData *data = (ListData *)widget_data(widget);
+
+    // A scroll repaints in place, so the old area only has to be cleared when the list moved or disappeared
+    bool moved = framebuffer->origin_x + widget->x != widget->prev_x ||
+                 framebuffer->origin_y + widget->y != widget->prev_y || widget->width != widget->prev_width ||
+                 widget->height != widget->prev_height;
+    if (widget->visible && !moved)
+        return;
+
+    data->full_redraw = true;
+
+    if (framebuffer->dirty_rect_count < MAX_DIRTY_RECTS)
+    {
+        framebuffer->dirty_rects[framebuffer->dirty_rect_count] =
+            (DirtyRect){widget->prev_x, widget->prev_y, widget->prev_width, widget->prev_height};
+        framebuffer->dirty_rect_count++;
+    }
+}
+
+static void list_expose_callback(Widget *widget)
+{
+    ((ListData *)widget_data(widget))->full_redraw = true;
+}
+
+static void list_render_callback(Widget *widget, Framebuffer *framebuffer)
+{
+    ListData *data = (ListData *)widget_data(widget);
+    if (!ensure_rows(widget, data))
+        return;
+
+    bind_visible_rows(widget, data, false);
+
+    int x = framebuffer->origin_x + widget->x;
+    int y = framebuffer->origin_y + widget->y;
+    bool on_screen = x >= 0 && y >= 0 && x + widget->width <= FRAMEBUFFER_WIDTH(framebuffer) &&
+                     y + widget->height <= FRAMEBUFFER_HEIGHT(framebuffer);
+    int delta = data->scroll_offset - data->drawn_offset;
+
+    // Rows still on screen are moved with one copy; only the band scrolled into view is drawn
+    if (data->full_redraw || !on_screen || abs(delta) >= widget->height)
+    {
+        draw_band(widget, data, framebuffer, 0, widget->height);
+    }
+    else if (delta > 0)
+    {
+        framebuffer_scroll(framebuffer, x, y, widget->width, widget->height, delta);
+        draw_band(widget, data, framebuffer, widget->height - delta, widget->height);
+    }
+    else if (delta < 0)
+    {
+        framebuffer_scroll(framebuffer, x, y, widget->width, widget->height, delta);
+        draw_band(widget, data, framebuffer, 0, -delta);
+    }
+
+    // Rows whose content changed without a scroll
+    for (int i = 0; i < data->row_count; i++)
+    {
+        Widget *row = data->rows[i];
+        if (data->row_items[i] >= 0 && row->dirty)
+            draw_band(widget, data, framebuffer, row->y, row->y + row->height);
+    }
+
+    data->full_redraw = false;
+    data->drawn_offset = data->scroll_offset;
+}
+
+static void list_destroy_callback(Widget *widget)
+{
+    ListData *data = (ListData *)widget_data(widget);
+    if (!data)
+        return;
+
+    for (int i = 0; i < data->row_count; i++)
+    {
+        widget_destroy(data->rows[i]);
+        gui_free(data->rows[i]);
+    }
+
+    gui_free(data->rows);
+    gui_free(data->row_items);
+    data->rows = NULL;
+    data->row_items = NULL;
+    data->row_count = 0;
+}
+
+void list_set_item_count(Widget *list, int count)
+{
+    if (!list || list->type != WIDGET_TYPE_LIST)
+        return;
+
+    ListData *data = (ListData *)widget_data(list);
+    data->item_count = count > 0 ? count : 0;
+    if (data->scroll_offset > list_get_max_scroll(list))
+        data->scroll_offset = list_get_max_scroll(list);
+
+    list_refresh(list);
+}
+
+void list_refresh(Widget *list)
+{
+    if (!list || list->type != WIDGET_TYPE_LIST)
+        return;
+
+    ListData *data = (ListData *)widget_data(list);
+    if (ensure_rows(list, data))
+        bind_visible_rows(list, data, true);
+
+    data->full_redraw = true;
+    widget_mark_dirty(list);
+}
+
+void list_scroll_to(Widget *list, int offset)
+{
+    if (!list || list->type != WIDGET_TYPE_LIST)
+        return;
+
+    ListData *data = (ListData *)widget_data(list);
+    int max_scroll = list_get_max_scroll(list);
+    offset = offset < 0 ? 0 : offset > max_scroll ? max_scroll : offset;
+    if (offset == data->scroll_offset)
+        return;
+
+    data->scroll_offset = offset;
+    if (ensure_rows(list, data))
+        bind_visible_rows(list, data, false);
+    widget_mark_dirty(list);
+}
+
+void list_scroll_by(Widget *list, int delta)
+{
+    list_scroll_to(list, list_get_scroll_offset(list) + delta);
+}
+
+int list_get_scroll_offset(Widget *list)
+{
+    if (!list || list->type != WIDGET_TYPE_LIST)
+        return 0;
+
+    return ((ListData *)widget_data(list))->scroll_offset;
+}
+
+int list_get_max_scroll(Widget *list)
+{
+    if (!list || list->type != WIDGET_TYPE_LIST)
+        return 0;
+
+    ListData *data = (ListData *)widget_data(list);
+    int content_height = data->item_count * data->row_height;
+    return content_height > list->height ? content_height - list->height : 0;
+}
+
+int list_item_at(Widget *list, int x, int y)
+{
+    if (!list || list->type != WIDGET_TYPE_LIST || !widget_contains_point(list, x, y))
+        return -1;
+
+    ListData *data = (ListData *)widget_data(list);
+    int screen_x, screen_y;
+    widget_get_screen_position(list, &screen_x, &screen_y);
+
+    int index = (y - screen_y + data->scroll_offset) / data->row_height;
+    return index < data->item_count ? index : -1;
+}
+
+// The pool grows with the list's height, which a layout may change at any time
+static bool ensure_rows(Widget *list, ListData *data)
+{
+    int needed = list->height / data->row_height + 2;
+    if (data->row_count >= needed)
+        return true;
+
+    Widget **rows = (Widget **)gui_realloc(data->rows, sizeof(Widget *) * needed);
+    if (!rows)
+        return false;
+    data->rows = rows;
+
+    int *row_items = (int *)gui_realloc(data->row_items, sizeof(int) * needed);
+    if (!row_items)
+        return false;
+    data->row_items = row_items;
+
+    // Items map onto rows by index modulo the row count, so every row is bound afresh
+    for (int i = 0; i < data->row_count; i++)
+        data->row_items[i] = -1;
+
+    while (data->row_count < needed)
+    {
+        Widget *row = data->create_row(data->user_data);
+        if (!row)
+            return false;
+
+        row->parent = list;
+        data->rows[data->row_count] = row;
+        data->row_items[data->row_count] = -1;
+        data->row_count++;
+    }
+
+    return true;
+}
+
+static void bind_visible_rows(Widget *list, ListData *data, bool rebind)
+{
+    int first = data->scroll_offset / data->row_height;
+    int last = (data->scroll_offset + list->height - 1) / data->row_height;
+    if (last >= data->item_count)
+        last = data->item_count - 1;
+
+    for (int i = 0; i < data->row_count; i++)
+    {
+        int item = data->row_items[i];
+        if (item >= 0 && (item < first || item > last))
+            data->row_items[i] = -1;
+    }
+
+    for (int item = first; item <= last; item++)
+    {
+        int slot = item % data->row_count;
+        Widget *row = data->rows[slot];
+
+        if (rebind || data->row_items[slot] != item)
+        {
+            data->row_items[slot] = item;
+            data->bind_row(row, item, data->user_data);
+        }
+
+        row->x = 0;
+        row->y = item * data->row_height - data->scroll_offset;
+        row->width = list->width;
+        row->height = data->row_height;
+    }
+}
+
+// Clears the rows [top, bottom) of the list to the background and draws the rows that cross them, clipped
+static void draw_band(Widget *list, ListData *data, Framebuffer *framebuffer, int top, int bottom)
+{
+    if (top < 0)
+        top = 0;
+    if (bottom > list->height)
+        bottom = list->height;
+    if (bottom <= top)
+        return;
+
+    int x = framebuffer->origin_x + list->x;
+    int y = framebuffer->origin_y + list->y;
+    Framebuffer view = framebuffer_view(framebuffer, x, y + top, list->width, bottom - top);
+    if (!view.pixels)
+        return;
+
+    renderFilledRectangle(0, 0, view.width, view.height, view.background, &view);
+    view.origin_x += x;
+    view.origin_y += y;
+
+    for (int i = 0; i < data->row_count; i++)
+    {
+        Widget *row = data->rows[i];
+        if (data->row_items[i] < 0 || row->y >= bottom || row->y + row->height <= top)
+            continue;
+
+        if (row->visible && row->vtable && row->vtable->render)
+            row->vtable->render(row, &view);
+        row->dirty = false;
+    }
+}
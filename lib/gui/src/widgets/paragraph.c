@@ -0,0 +1,381 @@
+#include "widgets/paragraph.h"
+#include "framebuffer.h"
+#include "gui_arena.h"
+#include "primitives/text.h"
+#include <string.h>
+
+#define PARAGRAPH_MIN_LINES 4
+
+static void paragraph_render_callback(Widget *widget, Framebuffer *framebuffer);
+static void paragraph_dirty_callback(Widget *widget, Framebuffer *framebuffer);
+static void paragraph_expose_callback(Widget *widget);
+static void paragraph_destroy_callback(Widget *widget);
+static bool text_fits(const char *text);
+static void text_changed(Widget *paragraph, ParagraphData *data);
+static void ensure_lines(Widget *paragraph, ParagraphData *data);
+static void break_lines(ParagraphData *data, int width, int *changed_first, int *changed_end);
+static bool store_line(ParagraphData *data, int index, int start, int length, int width, int *changed_first,
+                       int *changed_end);
+static uint32_t hash_span(const char *text, int length);
+
+static const WidgetVTable paragraph_vtable = {
+    .render = paragraph_render_callback,
+    .on_dirty = paragraph_dirty_callback,
+    .on_expose = paragraph_expose_callback,
+    .destroy = paragraph_destroy_callback,
+};
+
+Widget *paragraph_create(int x, int y, int width, int height, const char *text, const bdf_font_t *font)
+{
+    Widget *paragraph = widget_create(WIDGET_TYPE_PARAGRAPH, &paragraph_vtable, sizeof(ParagraphData), x, y, width,
+                                      height);
+    if (!paragraph)
+        return NULL;
+
+    ParagraphData *data = (ParagraphData *)widget_data(paragraph);
+    widget_text_init(&data->text, NULL, 0);
+    widget_text_set(&data->text, text_fits(text) ? text : NULL);
+    data->text_color = COLOR_WHITE;
+    data->font = font;
+    data->line_height = getFontHeight(font);
+    data->wrap_width = -1;
+
+    return paragraph;
+}
+
+static void paragraph_dirty_callback(Widget *widget, Framebuffer *framebuffer)
+{
+    if (!widget || !framebuffer)
+        return;
+
+    ParagraphData *data = (ParagraphData *)widget_data(widget);
+
+    bool moved = framebuffer->origin_x + widget->x != widget->prev_x ||
+                 framebuffer->origin_y + widget->y != widget->prev_y || widget->width != widget->prev_width ||
+                 widget->height != widget->prev_height;
+
+    DirtyRect rect = {widget->prev_x, widget->prev_y, widget->prev_width, widget->prev_height};
+    if (widget->visible && !moved && data->partial_redraw)
+    {
+        int top = data->changed_first * data->line_height;
+        int bottom = data->changed_end * data->line_height;
+        if (bottom > widget->prev_height)
+            bottom = widget->prev_height;
+        if (bottom <= top)
+            return;
+
+        rect.y += top;
+        rect.height = bottom - top;
+    }
+    else
+    {
+        data->partial_redraw = false;
+    }
+
+    if (framebuffer->dirty_rect_count < MAX_DIRTY_RECTS)
+    {
+        framebuffer->dirty_rects[framebuffer->dirty_rect_count] = rect;
+        framebuffer->dirty_rect_count++;
+    }
+}
+
+static void paragraph_expose_callback(Widget *widget)
+{
+    ((ParagraphData *)widget_data(widget))->partial_redraw = false;
+}
+
+static void paragraph_render_callback(Widget *widget, Framebuffer *framebuffer)
+{
+    ParagraphData *data = (ParagraphData *)widget_data(widget);
+    ensure_lines(widget, data);
+
+    int first = data->partial_redraw ? data->changed_first : 0;
+    int end = data->partial_redraw ? data->changed_end : data->line_count;
+    data->partial_redraw = false;
+
+    if (!data->text.value || !data->font || data->line_height <= 0)
+        return;
+
+    // Drawing through a view clips lines that overflow the widget's height
+    int x = framebuffer->origin_x + widget->x;
+    int y = framebuffer->origin_y + widget->y;
+    Framebuffer view = framebuffer_view(framebuffer, x, y, widget->width, widget->height);
+    if (!view.pixels)
+        return;
+
+    if (end > data->line_count)
+        end = data->line_count;
+
+    for (int i = first; i < end; i++)
+    {
+        const ParagraphLine *line = &data->lines[i];
+        int line_y = y + i * data->line_height;
+        if (line_y - y >= widget->height)
+            break;
+
+        renderTextSpan(data->text.value + line->start, line->length, data->text_color, x + view.origin_x,
+                       line_y + view.origin_y, data->font, &view);
+    }
+}
+
+static void paragraph_destroy_callback(Widget *widget)
+{
+    ParagraphData *data = (ParagraphData *)widget_data(widget);
+    if (!data)
+        return;
+
+    widget_text_release(&data->text);
+    gui_free(data->lines);
+    data->lines = NULL;
+    data->line_count = 0;
+    data->line_capacity = 0;
+}
+
+void paragraph_set_text(Widget *paragraph, const char *text)
+{
+    if (!paragraph || paragraph->type != WIDGET_TYPE_PARAGRAPH)
+        return;
+
+    ParagraphData *data = (ParagraphData *)widget_data(paragraph);
+    if (text_fits(text) && widget_text_set(&data->text, text))
+        text_changed(paragraph, data);
+}
+
+void paragraph_set_static_text(Widget *paragraph, const char *text)
+{
+    if (!paragraph || paragraph->type != WIDGET_TYPE_PARAGRAPH)
+        return;
+
+    ParagraphData *data = (ParagraphData *)widget_data(paragraph);
+    if (text_fits(text) && widget_text_borrow(&data->text, text))
+        text_changed(paragraph, data);
+}
+
+void paragraph_set_color(Widget *paragraph, Color color)
+{
+    if (!paragraph || paragraph->type != WIDGET_TYPE_PARAGRAPH)
+        return;
+
+    ParagraphData *data = (ParagraphData *)widget_data(paragraph);
+    if (COLOR_COMPARE(data->text_color, color))
+        return;
+
+    data->text_color = color;
+    data->partial_redraw = false;
+    widget_mark_dirty(paragraph);
+}
+
+void paragraph_set_font(Widget *paragraph, const bdf_font_t *font)
+{
+    if (!paragraph || paragraph->type != WIDGET_TYPE_PARAGRAPH)
+        return;
+
+    ParagraphData *data = (ParagraphData *)widget_data(paragraph);
+    if (data->font == font)
+        return;
+
+    data->font = font;
+    data->line_height = getFontHeight(font);
+    data->wrap_width = -1;
+    data->partial_redraw = false;
+    widget_mark_dirty(paragraph);
+}
+
+void paragraph_fit_height(Widget *paragraph)
+{
+    if (!paragraph || paragraph->type != WIDGET_TYPE_PARAGRAPH)
+        return;
+
+    ParagraphData *data = (ParagraphData *)widget_data(paragraph);
+    ensure_lines(paragraph, data);
+    widget_set_size(paragraph, paragraph->width, data->line_count * data->line_height);
+}
+
+const char *paragraph_get_text(Widget *paragraph)
+{
+    if (!paragraph || paragraph->type != WIDGET_TYPE_PARAGRAPH)
+        return NULL;
+
+    return ((ParagraphData *)widget_data(paragraph))->text.value;
+}
+
+int paragraph_get_line_count(Widget *paragraph)
+{
+    if (!paragraph || paragraph->type != WIDGET_TYPE_PARAGRAPH)
+        return 0;
+
+    ParagraphData *data = (ParagraphData *)widget_data(paragraph);
+    ensure_lines(paragraph, data);
+    return data->line_count;
+}
+
+static bool text_fits(const char *text)
+{
+    return !text || strlen(text) <= PARAGRAPH_MAX_TEXT_LENGTH;
+}
+
+// Lines are compared by position: a line whose characters and width are unchanged still shows the right pixels
+static void text_changed(Widget *paragraph, ParagraphData *data)
+{
+    if (data->wrap_width != paragraph->width)
+    {
+        data->partial_redraw = false;
+        widget_mark_dirty(paragraph);
+        return;
+    }
+
+    int first, end;
+    break_lines(data, paragraph->width, &first, &end);
+    if (first >= end)
+        return;
+
+    // A repaint of the whole widget already pending, or one that will follow a show, covers these lines too
+    if (!paragraph->visible || (paragraph->dirty && !data->partial_redraw))
+    {
+        widget_mark_dirty(paragraph);
+        return;
+    }
+
+    if (data->partial_redraw)
+    {
+        if (data->changed_first < first)
+            first = data->changed_first;
+        if (data->changed_end > end)
+            end = data->changed_end;
+    }
+
+    data->changed_first = first;
+    data->changed_end = end;
+    data->partial_redraw = true;
+    widget_mark_dirty(paragraph);
+}
+
+static void ensure_lines(Widget *paragraph, ParagraphData *data)
+{
+    if (data->wrap_width == paragraph->width)
+        return;
+
+    int first, end;
+    break_lines(data, paragraph->width, &first, &end);
+}
+
+// Greedy word wrap: a line ends at the last space that fits, at a newline, or mid-word when a single word is
+// wider than the paragraph. A width of 0 or less only breaks at newlines.
+static void break_lines(ParagraphData *data, int width, int *changed_first, int *changed_end)
+{
+    int old_count = data->line_count;
+    *changed_first = old_count;
+    *changed_end = 0;
+
+    const char *text = data->text.value;
+    int count = 0;
+    int pos = 0;
+
+    while (text && data->font && text[pos] != '\0')
+    {
+        int start = pos;
+        int line_width = 0;
+        int break_at = -1;
+        int break_width = 0;
+        int end = pos;
+        int next;
+
+        while (text[end] != '\0' && text[end] != '\n')
+        {
+            int char_width = measureTextSpan(text + end, 1, data->font);
+            if (width > 0 && end > start && line_width + char_width > width)
+                break;
+
+            if (text[end] == ' ')
+            {
+                break_at = end;
+                break_width = line_width;
+            }
+            line_width += char_width;
+            end++;
+        }
+
+        if (text[end] == '\0' || text[end] == '\n')
+        {
+            next = text[end] == '\n' ? end + 1 : end;
+        }
+        else if (break_at > start)
+        {
+            end = break_at;
+            line_width = break_width;
+            next = break_at + 1;
+        }
+        else
+        {
+            next = end;
+        }
+
+        if (!store_line(data, count, start, end - start, line_width, changed_first, changed_end))
+            break;
+        count++;
+
+        // Spaces a wrap lands on are not carried to the start of the next line
+        pos = next;
+        if (text[end] != '\n')
+        {
+            while (text[pos] == ' ')
+                pos++;
+        }
+    }
+
+    data->line_count = count;
+    data->wrap_width = width;
+
+    if (old_count > count)
+    {
+        if (*changed_first > count)
+            *changed_first = count;
+        *changed_end = old_count;
+    }
+}
+
+static bool store_line(ParagraphData *data, int index, int start, int length, int width, int *changed_first,
+                       int *changed_end)
+{
+    if (index >= data->line_capacity)
+    {
+        int capacity = data->line_capacity > 0 ? data->line_capacity * 2 : PARAGRAPH_MIN_LINES;
+        ParagraphLine *lines = (ParagraphLine *)gui_realloc(data->lines, sizeof(ParagraphLine) * capacity);
+        if (!lines)
+            return false;
+
+        data->lines = lines;
+        data->line_capacity = capacity;
+    }
+
+    uint32_t hash = hash_span(data->text.value + start, length);
+    ParagraphLine *line = &data->lines[index];
+    bool changed = index >= data->line_count || line->hash != hash || line->width != width;
+
+    line->start = (uint16_t)start;
+    line->length = (uint16_t)length;
+    line->width = (int16_t)width;
+    line->hash = hash;
+
+    if (changed)
+    {
+        if (index < *changed_first)
+            *changed_first = index;
+        *changed_end = index + 1;
+    }
+
+    return true;
+}
+
+// FNV-1a
+static uint32_t hash_span(const char *text, int length)
+{
+    uint32_t hash = 2166136261u;
+    for (int i = 0; i < length; i++)
+    {
+        hash ^= (uint8_t)text[i];
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
@@ -1,9 +1,33 @@
 #include "widgets/widget.h"
 #include "framebuffer.h"
+#include "gui_arena.h"
+#include "render_cache.h"
 #include "widgets/container.h"
 #include <stdlib.h>
 #include <string.h>
 
+static void expose_covered_siblings(Widget *widget);
+static void mark_moved(Widget *widget);
+
+// One allocation holds the widget followed by its type data, which starts zeroed
+Widget *widget_create(WidgetType type, const WidgetVTable *vtable, size_t data_size, int x, int y, int width,
+                      int height)
+{
+    Widget *widget = (Widget *)gui_alloc(sizeof(Widget) + data_size);
+    if (!widget)
+        return NULL;
+
+    widget_init(widget, type, x, y, width, height);
+    widget->vtable = vtable;
+    if (data_size > 0)
+    {
+        memset(widget + 1, 0, data_size);
+        widget->has_data = true;
+    }
+
+    return widget;
+}
+
 void widget_init(Widget *widget, WidgetType type, int x, int y, int width, int height)
 {
     if (!widget)
@@ -16,16 +40,16 @@ void widget_init(Widget *widget, WidgetType type, int x, int y, int width, int h
     widget->y = y;
     widget->width = width;
     widget->height = height;
+    widget->layout.preferred_width = width;
+    widget->layout.preferred_height = height;
     widget->visible = true;
     widget->enabled = true;
     widget->parent = NULL;
     widget->on_click = NULL;
-    widget->render = NULL;
-    widget->destroy = NULL;
+    widget->vtable = NULL;
     widget->user_data = NULL;
-    widget->data = NULL;
     widget->dirty = true;
-    widget->on_dirty = NULL;
+    widget->needs_layout = true;
 }
 
 void widget_destroy(Widget *widget)
@@ -33,18 +57,23 @@ void widget_destroy(Widget *widget)
     if (!widget)
         return;
 
-    if (widget->destroy)
-    {
-        widget->destroy(widget);
-    }
+    if (widget->cached)
+        render_cache_forget(widget);
 
-    if (widget->data)
+    if (widget->vtable && widget->vtable->destroy)
     {
-        free(widget->data);
-        widget->data = NULL;
+        widget->vtable->destroy(widget);
     }
 }
 
+void *widget_data(Widget *widget)
+{
+    if (!widget || !widget->has_data)
+        return NULL;
+
+    return widget + 1;
+}
+
 void widget_render(Widget *widget, Framebuffer *framebuffer)
 {
     if (!widget || !framebuffer)
@@ -56,14 +85,15 @@ void widget_render(Widget *widget, Framebuffer *framebuffer)
         return;
     }
 
-    if (widget->render)
+    bool drawn = widget->cached && render_cache_draw(widget, framebuffer);
+    if (!drawn && widget->vtable && widget->vtable->render)
     {
-        widget->render(widget, framebuffer);
+        widget->vtable->render(widget, framebuffer);
     }
 
     widget->dirty = false;
-    widget->prev_x = widget->x;
-    widget->prev_y = widget->y;
+    widget->prev_x = framebuffer->origin_x + widget->x;
+    widget->prev_y = framebuffer->origin_y + widget->y;
     widget->prev_width = widget->width;
     widget->prev_height = widget->height;
 }
@@ -73,9 +103,9 @@ void widget_handle_dirty(Widget *widget, Framebuffer *framebuffer)
     if (!widget || !widget->dirty)
         return;
 
-    if (widget->on_dirty)
+    if (widget->vtable && widget->vtable->on_dirty)
     {
-        widget->on_dirty(widget, framebuffer);
+        widget->vtable->on_dirty(widget, framebuffer);
     }
     else
     {
@@ -93,9 +123,13 @@ void widget_set_position(Widget *widget, int x, int y)
     if (widget->x == x && widget->y == y)
         return;
 
+    expose_covered_siblings(widget);
+
+    // Children are placed relative to the widget, so a move leaves the subtree and its cached bounds untouched
     widget->x = x;
     widget->y = y;
-    widget_mark_dirty(widget);
+    widget_invalidate_bounds(widget->parent);
+    mark_moved(widget);
 }
 
 void widget_set_size(Widget *widget, int width, int height)
@@ -103,11 +137,21 @@ void widget_set_size(Widget *widget, int width, int height)
     if (!widget)
         return;
 
-    if (widget->width == width && widget->height == height)
+    if (widget->width == width && widget->height == height && widget->layout.preferred_width == width &&
+        widget->layout.preferred_height == height)
         return;
 
+    expose_covered_siblings(widget);
+
     widget->width = width;
     widget->height = height;
+    widget->layout.preferred_width = width;
+    widget->layout.preferred_height = height;
+    widget_invalidate_bounds(widget);
+    widget_invalidate_measure(widget);
+    if (widget->type == WIDGET_TYPE_CONTAINER)
+        widget_mark_layout_dirty(widget);
+    widget_mark_layout_dirty(widget->parent);
     widget_mark_dirty(widget);
 }
 
@@ -119,9 +163,12 @@ void widget_set_visible(Widget *widget, bool visible)
     if (widget->visible == visible)
         return;
 
+    if (!visible)
+        expose_covered_siblings(widget);
+
     if (widget->type == WIDGET_TYPE_CONTAINER)
     {
-        ContainerData *data = (ContainerData *)widget->data;
+        ContainerData *data = (ContainerData *)widget_data(widget);
         if (data)
         {
             for (int i = 0; i < data->child_count; i++)
@@ -135,7 +182,9 @@ void widget_set_visible(Widget *widget, bool visible)
     }
 
     widget->visible = visible;
-    widget_mark_dirty(widget);
+    widget_invalidate_measure(widget->parent);
+    widget_mark_layout_dirty(widget->parent);
+    mark_moved(widget);
 }
 
 void widget_set_enabled(Widget *widget, bool enabled)
@@ -145,51 +194,263 @@ void widget_set_enabled(Widget *widget, bool enabled)
     widget->enabled = enabled;
 }
 
+void widget_set_cached(Widget *widget, bool cached)
+{
+    if (!widget || widget->cached == cached)
+        return;
+
+    if (!cached)
+        render_cache_forget(widget);
+
+    widget->cached = cached;
+}
+
+void widget_set_opaque(Widget *widget, bool opaque)
+{
+    if (!widget || widget->opaque == opaque)
+        return;
+
+    if (!opaque)
+        expose_covered_siblings(widget);
+
+    widget->opaque = opaque;
+    widget_mark_dirty(widget);
+}
+
 void widget_mark_dirty(Widget *widget)
 {
     if (!widget)
         return;
 
+    if (widget->cached)
+        render_cache_invalidate(widget);
+
     if (widget->parent)
         widget_mark_dirty(widget->parent);
 
     widget->dirty = true;
 }
 
-bool widget_contains_point(Widget *widget, int x, int y)
+// Layout only has to rerun for the container whose children changed; its ancestors are merely repainted
+void widget_mark_layout_dirty(Widget *widget)
 {
     if (!widget)
-        return false;
+        return;
 
-    return (x >= widget->x && x < widget->x + widget->width && y >= widget->y && y < widget->y + widget->height);
+    widget->needs_layout = true;
+    widget_mark_dirty(widget);
 }
 
-void widget_handle_click(Widget *widget, int x, int y)
+void widget_set_flex(Widget *widget, int flex)
 {
     if (!widget)
         return;
-    if (!widget->visible || !widget->enabled)
+
+    widget->layout.flex = flex > 0 ? flex : 0;
+    widget_invalidate_measure(widget->parent);
+    widget_mark_layout_dirty(widget->parent);
+}
+
+void widget_set_size_limits(Widget *widget, int min_width, int min_height, int max_width, int max_height)
+{
+    if (!widget)
         return;
 
-    if (widget_contains_point(widget, x, y))
+    widget->layout.min_width = min_width > 0 ? min_width : 0;
+    widget->layout.min_height = min_height > 0 ? min_height : 0;
+    widget->layout.max_width = max_width > 0 ? max_width : 0;
+    widget->layout.max_height = max_height > 0 ? max_height : 0;
+    widget_invalidate_measure(widget);
+    widget_mark_layout_dirty(widget->parent);
+}
+
+// Intrinsic size, independent of whatever geometry a layout last assigned
+void widget_measure(Widget *widget, int *width, int *height)
+{
+    if (!widget || !width || !height)
+        return;
+
+    if (widget->type == WIDGET_TYPE_CONTAINER)
     {
-        if (widget->on_click)
-        {
-            widget->on_click(widget, widget->user_data);
-        }
+        container_measure(widget, width, height);
+        return;
+    }
+
+    *width = widget->layout.preferred_width;
+    *height = widget->layout.preferred_height;
+}
+
+void widget_invalidate_measure(Widget *widget)
+{
+    // Measuring a container measures its children, so an invalid container always has invalid ancestors
+    for (Widget *current = widget; current; current = current->parent)
+    {
+        if (current->type != WIDGET_TYPE_CONTAINER || !widget_data(current))
+            continue;
+
+        ContainerData *data = (ContainerData *)widget_data(current);
+        if (!data->measure_valid)
+            break;
+
+        data->measure_valid = false;
+    }
+}
+
+void widget_get_screen_position(Widget *widget, int *x, int *y)
+{
+    if (!widget || !x || !y)
+        return;
+
+    *x = 0;
+    *y = 0;
+    for (Widget *current = widget; current; current = current->parent)
+    {
+        *x += current->x;
+        *y += current->y;
     }
+}
+
+// Takes screen coordinates
+bool widget_contains_point(Widget *widget, int x, int y)
+{
+    if (!widget)
+        return false;
+
+    int screen_x, screen_y;
+    widget_get_screen_position(widget, &screen_x, &screen_y);
+
+    return (x >= screen_x && x < screen_x + widget->width && y >= screen_y && y < screen_y + widget->height);
+}
+
+// Children are drawn in order, so the last child is on top and is tested first. Subtrees whose cached bounds
+// miss the point are skipped, and the walk stops at the first widget that takes clicks. The point is relative
+// to the parent of the widget being tested.
+static Widget *hit_test_local(Widget *widget, int x, int y)
+{
+    if (!widget->visible || !widget->enabled)
+        return NULL;
+
     if (widget->type == WIDGET_TYPE_CONTAINER)
     {
-        ContainerData *data = (ContainerData *)widget->data;
+        ContainerData *data = (ContainerData *)widget_data(widget);
         if (data)
         {
-            for (int i = 0; i < data->child_count; i++)
+            int bounds_x, bounds_y, bounds_width, bounds_height;
+            container_get_bounds(widget, &bounds_x, &bounds_y, &bounds_width, &bounds_height);
+
+            if (x < bounds_x || x >= bounds_x + bounds_width || y < bounds_y || y >= bounds_y + bounds_height)
+                return NULL;
+
+            for (int i = data->child_count - 1; i >= 0; i--)
             {
-                if (data->children[i])
-                {
-                    widget_handle_click(data->children[i], x, y);
-                }
+                Widget *hit = hit_test_local(data->children[i], x - widget->x, y - widget->y);
+                if (hit)
+                    return hit;
             }
         }
     }
+
+    if (widget->on_click && x >= widget->x && x < widget->x + widget->width && y >= widget->y &&
+        y < widget->y + widget->height)
+        return widget;
+
+    return NULL;
+}
+
+// Takes screen coordinates
+Widget *widget_hit_test(Widget *widget, int x, int y)
+{
+    if (!widget)
+        return NULL;
+
+    int parent_x = 0;
+    int parent_y = 0;
+    widget_get_screen_position(widget->parent, &parent_x, &parent_y);
+
+    return hit_test_local(widget, x - parent_x, y - parent_y);
+}
+
+void widget_handle_click(Widget *widget, int x, int y)
+{
+    Widget *target = widget_hit_test(widget, x, y);
+    if (target)
+    {
+        target->on_click(target, target->user_data);
+    }
+}
+
+void widget_invalidate_bounds(Widget *widget)
+{
+    // An invalid container always has invalid ancestors, so the walk can stop at the first one
+    for (Widget *current = widget; current; current = current->parent)
+    {
+        if (current->type != WIDGET_TYPE_CONTAINER || !widget_data(current))
+            continue;
+
+        ContainerData *data = (ContainerData *)widget_data(current);
+        if (!data->bounds_valid)
+            break;
+
+        data->bounds_valid = false;
+    }
+}
+
+// Moving or showing a widget leaves its content as it was, so its cached surface stays valid
+static void mark_moved(Widget *widget)
+{
+    widget->dirty = true;
+    widget_mark_dirty(widget->parent);
+}
+
+void widget_mark_subtree_dirty(Widget *widget)
+{
+    if (!widget)
+        return;
+
+    widget->dirty = true;
+    if (widget->vtable && widget->vtable->on_expose)
+        widget->vtable->on_expose(widget);
+
+    if (widget->type != WIDGET_TYPE_CONTAINER || !widget_data(widget))
+        return;
+
+    ContainerData *data = (ContainerData *)widget_data(widget);
+    for (int i = 0; i < data->child_count; i++)
+    {
+        if (data->children[i])
+            widget_mark_subtree_dirty(data->children[i]);
+    }
+}
+
+// Siblings drawn before an opaque widget may have been culled beneath it or overdrawn by it. Once it moves,
+// resizes or disappears, the area it covered is cleared, so everything underneath has to be drawn again.
+static void expose_covered_siblings(Widget *widget)
+{
+    if (!widget->opaque || !widget->parent || widget->parent->type != WIDGET_TYPE_CONTAINER)
+        return;
+
+    ContainerData *data = (ContainerData *)widget_data(widget->parent);
+    if (!data)
+        return;
+
+    for (int i = 0; i < data->child_count && data->children[i] != widget; i++)
+    {
+        Widget *sibling = data->children[i];
+        if (!sibling || !sibling->visible)
+            continue;
+
+        int x = sibling->x;
+        int y = sibling->y;
+        int width = sibling->width;
+        int height = sibling->height;
+        if (sibling->type == WIDGET_TYPE_CONTAINER)
+            container_get_bounds(sibling, &x, &y, &width, &height);
+
+        if (x < widget->x + widget->width && widget->x < x + width && y < widget->y + widget->height &&
+            widget->y < y + height)
+        {
+            widget_mark_subtree_dirty(sibling);
+            widget_mark_dirty(widget->parent);
+        }
+    }
 }
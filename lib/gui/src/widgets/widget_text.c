@@ -0,0 +1,86 @@
+#include "widgets/widget_text.h"
+#include "gui_arena.h"
+#include <string.h>
+
+static bool text_equals(const char *a, const char *b)
+{
+    if (a == b)
+        return true;
+    if (!a || !b)
+        return false;
+    return strcmp(a, b) == 0;
+}
+
+void widget_text_init(WidgetText *text, char *buffer, int capacity)
+{
+    if (!text)
+        return;
+
+    text->value = NULL;
+    text->buffer = capacity > 0 ? buffer : NULL;
+    text->capacity = text->buffer ? (uint16_t)capacity : 0;
+    text->owned = false;
+}
+
+// Returns whether the visible text changed. A widget with a buffer copies into it, truncating if needed.
+bool widget_text_set(WidgetText *text, const char *value)
+{
+    if (!text || text_equals(text->value, value))
+        return false;
+
+    if (!value)
+    {
+        widget_text_release(text);
+        return true;
+    }
+
+    if (text->buffer)
+    {
+        size_t length = strlen(value);
+        if (length >= text->capacity)
+            length = text->capacity - 1;
+
+        // The old value may live in the buffer, so it is released only once the copy no longer needs it
+        memmove(text->buffer, value, length);
+        text->buffer[length] = '\0';
+        if (text->owned)
+            gui_free((char *)text->value);
+        text->value = text->buffer;
+        text->owned = false;
+        return true;
+    }
+
+    char *copy = gui_strdup(value);
+    widget_text_release(text);
+    text->value = copy;
+    text->owned = copy != NULL;
+    return true;
+}
+
+// Points at the caller's string without copying. Borrowing text equal to the current text drops a heap copy
+// but still reports no change, so nothing is repainted.
+bool widget_text_borrow(WidgetText *text, const char *value)
+{
+    if (!text)
+        return false;
+
+    bool changed = !text_equals(text->value, value);
+    if (text->value == value)
+        return false;
+
+    widget_text_release(text);
+    text->value = value;
+    return changed;
+}
+
+void widget_text_release(WidgetText *text)
+{
+    if (!text)
+        return;
+
+    if (text->owned)
+        gui_free((char *)text->value);
+
+    text->value = NULL;
+    text->owned = false;
+}
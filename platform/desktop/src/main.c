@@ -10,6 +10,7 @@
 #include "color.h"
 #include "framebuffer.h"
 #include "game.h"
+#include "inference_sim.h"
 
 static SDL_Window *window = NULL;
 static SDL_Renderer *renderer = NULL;
@@ -19,6 +20,17 @@ static SDL_Renderer *renderer = NULL;
 #define FRAMEBUFFER_SIZE (WINDOW_WIDTH * WINDOW_HEIGHT)
 
 static Framebuffer framebuffer;
+static CanvasTileBlock history_blocks[96];
+static uint8_t gui_arena_buffer[64 * 1024];
+static GuiArena gui_arena;
+static Color render_cache_buffer[8 * 1024];
+static RenderCache render_cache;
+static SnapshotRun menu_snapshot_runs[8 * 1024];
+static SnapshotRun game_snapshot_runs[8 * 1024];
+static PageSnapshot menu_snapshot;
+static PageSnapshot game_snapshot;
+static InferenceSim inference_sim;
+static InferenceBackend inference_backend;
 static Uint64 last_guess_time = 0;
 static Uint64 last_frame_time = 0;
 
@@ -26,9 +38,10 @@ static const char *DRAWING_PROMPTS[] = {"Cat",    "House", "Tree", "Car",   "Sun
                                         "Flower", "Star",  "Fish", "Heart", "Circle"};
 #define NUM_PROMPTS 10
 
-void on_guess_request(const uint8_t *canvas_28x28, void *user_data)
+// Stands in for the model until the accelerator is wired up
+static int classify_randomly(const uint8_t *canvas_28x28, void *user_data)
 {
-    game_send_guess(rand() % NUM_PROMPTS);
+    return rand() % NUM_PROMPTS;
 }
 
 SDL_AppResult SDL_AppInit(void **appstate, int argc, char *argv[])
@@ -57,6 +70,13 @@ SDL_AppResult SDL_AppInit(void **appstate, int argc, char *argv[])
     }
     framebuffer = (Framebuffer){pixels, WINDOW_WIDTH, WINDOW_HEIGHT};
 
+    gui_arena_init(&gui_arena, gui_arena_buffer, sizeof(gui_arena_buffer));
+    render_cache_init(&render_cache, render_cache_buffer, sizeof(render_cache_buffer));
+    page_snapshot_init(&menu_snapshot, menu_snapshot_runs, sizeof(menu_snapshot_runs));
+    page_snapshot_init(&game_snapshot, game_snapshot_runs, sizeof(game_snapshot_runs));
+    inference_sim_init(&inference_sim, 150, NUM_PROMPTS, classify_randomly, NULL);
+    inference_backend = inference_sim_backend(&inference_sim);
+
     GameConfig config = {
         .drawing_prompts = DRAWING_PROMPTS,
         .num_prompts = NUM_PROMPTS,
@@ -64,8 +84,16 @@ SDL_AppResult SDL_AppInit(void **appstate, int argc, char *argv[])
         .window_height = WINDOW_HEIGHT,
         .canvas_width = 0,
         .canvas_height = 0,
-        .guess_callback = on_guess_request,
+        .guess_callback = NULL,
         .callback_user_data = NULL,
+        .history_blocks = history_blocks,
+        .history_block_count = sizeof(history_blocks) / sizeof(history_blocks[0]),
+        .gui_arena = &gui_arena,
+        .render_cache = &render_cache,
+        .menu_snapshot = &menu_snapshot,
+        .game_snapshot = &game_snapshot,
+        .inference_backend = &inference_backend,
+        .inference_timeout_ms = 1000,
     };
 
     if (!game_init(&config))
@@ -90,22 +118,27 @@ SDL_AppResult SDL_AppEvent(void *appstate, SDL_Event *event)
 
     if (event->type == SDL_EVENT_KEY_UP)
     {
-        game_on_retry(NULL, NULL);
+        if (event->key.key == SDLK_Z)
+            game_undo();
+        else if (event->key.key == SDLK_Y)
+            game_redo();
+        else
+            game_on_retry(NULL, NULL);
     }
 
     if (event->type == SDL_EVENT_MOUSE_BUTTON_DOWN && event->button.button == SDL_BUTTON_LEFT)
     {
-        game_handle_mouse_down(event->button.x, event->button.y);
+        game_queue_input(INPUT_EVENT_POINTER_DOWN, event->button.x, event->button.y, SDL_GetTicks());
     }
 
     if (event->type == SDL_EVENT_MOUSE_BUTTON_UP && event->button.button == SDL_BUTTON_LEFT)
     {
-        game_handle_mouse_up(event->button.x, event->button.y);
+        game_queue_input(INPUT_EVENT_POINTER_UP, event->button.x, event->button.y, SDL_GetTicks());
     }
 
     if (event->type == SDL_EVENT_MOUSE_MOTION)
     {
-        game_handle_mouse_move(event->button.x, event->button.y);
+        game_queue_input(INPUT_EVENT_POINTER_MOVE, event->motion.x, event->motion.y, SDL_GetTicks());
     }
 
     return SDL_APP_CONTINUE;
@@ -115,14 +148,18 @@ SDL_AppResult SDL_AppIterate(void *appstate)
 {
     Uint64 current_time = SDL_GetTicks();
 
-    float delta_time = (current_time - last_frame_time) / 1000.0f;
+    int delta_ms = (int)(current_time - last_frame_time);
     last_frame_time = current_time;
 
-    game_update(delta_time);
+    inference_sim_advance(&inference_sim, delta_ms);
+    game_update(delta_ms);
 
     if (current_time - last_guess_time >= 1000)
     {
-        on_guess_request(NULL, NULL);
+        if (game_get_state() == GAME_STATE_PLAYING && game_canvas_changed())
+        {
+            game_on_guess(NULL, NULL);
+        }
         last_guess_time = current_time;
     }
 
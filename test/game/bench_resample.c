@@ -0,0 +1,110 @@
+#include "resample.h"
+#include "widgets/canvas.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define ITERATIONS 2000
+
+// The float box filter game_page_get_canvas_28x28 used before the integer resampler.
+static void legacy_downsample_28x28(const uint8_t *pixels, int canvas_width, int canvas_height, uint8_t *output)
+{
+    float x_scale = (float)canvas_width / 28.0f;
+    float y_scale = (float)canvas_height / 28.0f;
+
+    for (int out_y = 0; out_y < 28; out_y++)
+    {
+        for (int out_x = 0; out_x < 28; out_x++)
+        {
+            float center_x = (out_x + 0.5f) * x_scale;
+            float center_y = (out_y + 0.5f) * y_scale;
+
+            int start_x = (int)(center_x - x_scale * 0.5f);
+            int end_x = (int)(center_x + x_scale * 0.5f);
+            int start_y = (int)(center_y - y_scale * 0.5f);
+            int end_y = (int)(center_y + y_scale * 0.5f);
+
+            start_x = start_x < 0 ? 0 : start_x;
+            end_x = end_x >= canvas_width ? canvas_width - 1 : end_x;
+            start_y = start_y < 0 ? 0 : start_y;
+            end_y = end_y >= canvas_height ? canvas_height - 1 : end_y;
+
+            int sum = 0;
+            int count = 0;
+
+            for (int y = start_y; y <= end_y; y++)
+            {
+                for (int x = start_x; x <= end_x; x++)
+                {
+                    sum += pixels[y * canvas_width + x];
+                    count++;
+                }
+            }
+
+            output[out_y * 28 + out_x] = count > 0 ? (uint8_t)(sum / count) : 0;
+        }
+    }
+}
+
+static double elapsed_us(clock_t start)
+{
+    return (double)(clock() - start) * 1e6 / CLOCKS_PER_SEC / ITERATIONS;
+}
+
+static void bench_size(int width, int height)
+{
+    Widget *canvas = canvas_create(0, 0, width, height);
+    if (!canvas)
+        return;
+
+    canvas_set_brush_size(canvas, 7);
+    for (int i = 0; i < 400; i++)
+    {
+        canvas_draw_at(canvas, (i * 7919) % width, (i * 104729) % height);
+    }
+
+    CanvasData *data = (CanvasData *)widget_data(canvas);
+    uint8_t output[28 * 28];
+    volatile uint8_t sink = 0;
+
+    clock_t start = clock();
+    for (int i = 0; i < ITERATIONS; i++)
+    {
+        legacy_downsample_28x28(data->pixels, width, height, output);
+        sink ^= output[i % (28 * 28)];
+    }
+    double legacy = elapsed_us(start);
+
+    start = clock();
+    for (int i = 0; i < ITERATIONS; i++)
+    {
+        resample_area(data->pixels, width, height, width, output, 28, 28);
+        sink ^= output[i % (28 * 28)];
+    }
+    double area = elapsed_us(start);
+
+    start = clock();
+    for (int i = 0; i < ITERATIONS; i++)
+    {
+        canvas_get_downsample(canvas, output);
+        sink ^= output[i % (28 * 28)];
+    }
+    double incremental = elapsed_us(start);
+
+    printf("%4dx%-4d legacy float: %8.2f us  resample_area: %8.2f us  incremental: %8.2f us\n", width, height,
+           legacy, area, incremental);
+
+    (void)sink;
+    widget_destroy(canvas);
+    free(canvas);
+}
+
+int main(void)
+{
+    bench_size(224, 224);
+    bench_size(230, 230);
+    bench_size(272, 272);
+    bench_size(448, 448);
+
+    return 0;
+}
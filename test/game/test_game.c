@@ -1,5 +1,8 @@
 #include "game.h"
+#include "game_page.h"
+#include "inference_sim.h"
 #include "unity.h"
+#include "widgets/canvas.h"
 #include <stdlib.h>
 #include <string.h>
 
@@ -26,6 +29,17 @@ void setUp(void)
     test_config.callback_user_data = NULL;
     test_config.label_font = NULL;
     test_config.button_font = NULL;
+    test_config.stroke_log_buffer = NULL;
+    test_config.stroke_log_capacity = 0;
+    test_config.history_blocks = NULL;
+    test_config.history_block_count = 0;
+    test_config.touch_ring = NULL;
+    test_config.gui_arena = NULL;
+    test_config.render_cache = NULL;
+    test_config.menu_snapshot = NULL;
+    test_config.game_snapshot = NULL;
+    test_config.inference_backend = NULL;
+    test_config.inference_timeout_ms = 0;
     guess_callback_called = false;
     memset(last_canvas_data, 0, sizeof(last_canvas_data));
 }
@@ -101,13 +115,13 @@ void test_game_update(void)
 {
     TEST_ASSERT_TRUE(game_init(&test_config));
 
-    game_update(0.016f);
+    game_update(16);
     TEST_ASSERT_TRUE(game_is_initialized());
 }
 
 void test_game_update_when_uninitialized(void)
 {
-    game_update(0.016f);
+    game_update(16);
 }
 
 void test_game_send_guess(void)
@@ -254,6 +268,455 @@ void test_game_on_skip(void)
     TEST_ASSERT_EQUAL_INT(GAME_STATE_PLAYING, game_get_state());
 }
 
+void test_game_canvas_changed_after_drawing(void)
+{
+    TEST_ASSERT_TRUE(game_init(&test_config));
+    game_on_play(NULL, NULL);
+    TEST_ASSERT_FALSE(game_canvas_changed());
+
+    Widget *canvas = game_page_get_canvas();
+    game_handle_mouse_down(canvas->x + 20, canvas->y + 20);
+    game_handle_mouse_up(canvas->x + 20, canvas->y + 20);
+    TEST_ASSERT_TRUE(game_canvas_changed());
+
+    game_on_guess(NULL, NULL);
+    TEST_ASSERT_TRUE(guess_callback_called);
+    TEST_ASSERT_FALSE(game_canvas_changed());
+
+    bool has_ink = false;
+    for (int i = 0; i < 28 * 28; i++)
+    {
+        if (last_canvas_data[i] != 0)
+            has_ink = true;
+    }
+    TEST_ASSERT_TRUE(has_ink);
+}
+
+void test_game_records_stroke_log(void)
+{
+    uint8_t buffer[128];
+    test_config.stroke_log_buffer = buffer;
+    test_config.stroke_log_capacity = sizeof(buffer);
+    TEST_ASSERT_TRUE(game_init(&test_config));
+    game_on_play(NULL, NULL);
+
+    Widget *canvas = game_page_get_canvas();
+    game_handle_mouse_down(canvas->x + 20, canvas->y + 20);
+    game_handle_mouse_move(canvas->x + 25, canvas->y + 30);
+    game_handle_mouse_up(canvas->x + 25, canvas->y + 30);
+
+    const StrokeLog *log = game_get_stroke_log();
+    TEST_ASSERT_NOT_NULL(log);
+    TEST_ASSERT_GREATER_THAN(0, log->length);
+    TEST_ASSERT_FALSE(log->pen_down);
+}
+
+void test_game_without_stroke_log(void)
+{
+    TEST_ASSERT_TRUE(game_init(&test_config));
+    TEST_ASSERT_NULL(game_get_stroke_log());
+}
+
+void test_game_undo_redo_stroke(void)
+{
+    CanvasTileBlock blocks[32];
+    test_config.history_blocks = blocks;
+    test_config.history_block_count = 32;
+    TEST_ASSERT_TRUE(game_init(&test_config));
+    game_on_play(NULL, NULL);
+
+    Widget *canvas = game_page_get_canvas();
+    game_handle_mouse_down(canvas->x + 20, canvas->y + 20);
+    game_handle_mouse_up(canvas->x + 20, canvas->y + 20);
+    unsigned int drawn_version = game_page_get_canvas_version();
+
+    TEST_ASSERT_TRUE(game_undo());
+    TEST_ASSERT_EQUAL_UINT(0, ((CanvasData *)widget_data(canvas))->ink_count);
+    TEST_ASSERT_TRUE(game_canvas_changed());
+    TEST_ASSERT_FALSE(game_undo());
+
+    TEST_ASSERT_TRUE(game_redo());
+    TEST_ASSERT_GREATER_THAN(0, ((CanvasData *)widget_data(canvas))->ink_count);
+    TEST_ASSERT_TRUE(game_page_get_canvas_version() != drawn_version);
+}
+
+void test_game_undo_without_history(void)
+{
+    TEST_ASSERT_FALSE(game_undo());
+    TEST_ASSERT_TRUE(game_init(&test_config));
+    game_on_play(NULL, NULL);
+    TEST_ASSERT_FALSE(game_undo());
+    TEST_ASSERT_FALSE(game_redo());
+}
+
+void test_game_queued_input_draws_on_update(void)
+{
+    TEST_ASSERT_TRUE(game_init(&test_config));
+    game_on_play(NULL, NULL);
+
+    Widget *canvas = game_page_get_canvas();
+    CanvasData *data = (CanvasData *)widget_data(canvas);
+    int left = canvas->x + 20;
+    int top = canvas->y + 20;
+
+    TEST_ASSERT_TRUE(game_queue_input(INPUT_EVENT_POINTER_DOWN, left, top, 0));
+    for (int i = 1; i <= 40; i++)
+    {
+        game_queue_input(INPUT_EVENT_POINTER_MOVE, left + i * 4, top, (uint32_t)i);
+    }
+    game_queue_input(INPUT_EVENT_POINTER_UP, left + 160, top, 41);
+
+    TEST_ASSERT_EQUAL_UINT(0, data->ink_count);
+
+    game_update(16);
+
+    for (int x = 20; x <= 180; x++)
+    {
+        TEST_ASSERT_EQUAL_UINT8(255, data->pixels[20 * canvas->width + x]);
+    }
+}
+
+void test_game_queued_input_keeps_every_corner(void)
+{
+    TEST_ASSERT_TRUE(game_init(&test_config));
+    game_on_play(NULL, NULL);
+
+    Widget *canvas = game_page_get_canvas();
+    CanvasData *data = (CanvasData *)widget_data(canvas);
+    int left = canvas->x + 10;
+    int top = canvas->y + 20;
+
+    // A zigzag with more corners than the queue has slots
+    game_queue_input(INPUT_EVENT_POINTER_DOWN, left, top, 0);
+    for (int i = 1; i <= 2 * INPUT_QUEUE_CAPACITY; i++)
+    {
+        game_queue_input(INPUT_EVENT_POINTER_MOVE, left + i, top + (i % 2) * 100, (uint32_t)i);
+    }
+    game_queue_input(INPUT_EVENT_POINTER_UP, left + 2 * INPUT_QUEUE_CAPACITY, top, 1000);
+    game_update(16);
+
+    for (int i = 1; i <= 2 * INPUT_QUEUE_CAPACITY; i += 2)
+    {
+        TEST_ASSERT_EQUAL_UINT8(255, data->pixels[120 * canvas->width + 10 + i]);
+    }
+}
+
+void test_game_queue_input_before_init(void)
+{
+    TEST_ASSERT_FALSE(game_queue_input(INPUT_EVENT_POINTER_DOWN, 0, 0, 0));
+    game_process_input();
+}
+
+void test_game_drains_touch_ring(void)
+{
+    static TouchRing ring;
+    touch_ring_init(&ring);
+    test_config.touch_ring = &ring;
+    TEST_ASSERT_TRUE(game_init(&test_config));
+    game_on_play(NULL, NULL);
+
+    Widget *canvas = game_page_get_canvas();
+    CanvasData *data = (CanvasData *)widget_data(canvas);
+    int16_t left = (int16_t)(canvas->x + 30);
+    int16_t top = (int16_t)(canvas->y + 30);
+
+    TouchSample samples[] = {
+        {0, left, top, true},
+        {10, (int16_t)(left + 50), top, true},
+        {20, (int16_t)(left + 50), top, false},
+        {30, (int16_t)(left + 90), top, false},
+    };
+    for (unsigned int i = 0; i < sizeof(samples) / sizeof(samples[0]); i++)
+    {
+        touch_ring_push(&ring, &samples[i]);
+    }
+
+    game_update(16);
+
+    TEST_ASSERT_EQUAL_UINT(0, touch_ring_count(&ring));
+    TEST_ASSERT_EQUAL_UINT8(255, data->pixels[30 * canvas->width + 55]);
+    TEST_ASSERT_EQUAL_UINT8(0, data->pixels[30 * canvas->width + 110]);
+}
+
+void test_game_builds_ui_in_arena(void)
+{
+    static uint8_t buffer[96 * 1024];
+    static GuiArena arena;
+    gui_arena_init(&arena, buffer, sizeof(buffer));
+    test_config.gui_arena = &arena;
+
+    TEST_ASSERT_TRUE(game_init(&test_config));
+    TEST_ASSERT_EQUAL_PTR(&arena, gui_get_arena());
+    game_start_new_round();
+
+    GuiArenaStats stats;
+    gui_arena_get_stats(&arena, &stats);
+    TEST_ASSERT_EQUAL_INT(0, stats.failed_allocations);
+    TEST_ASSERT_TRUE(stats.live_blocks > 0);
+
+    game_cleanup();
+    gui_arena_get_stats(&arena, &stats);
+    TEST_ASSERT_EQUAL_INT(0, stats.used);
+    TEST_ASSERT_NULL(gui_get_arena());
+}
+
+void test_game_steady_state_does_not_allocate(void)
+{
+    static uint8_t buffer[96 * 1024];
+    static GuiArena arena;
+    gui_arena_init(&arena, buffer, sizeof(buffer));
+    test_config.gui_arena = &arena;
+
+    TEST_ASSERT_TRUE(game_init(&test_config));
+    game_start_new_round();
+    game_send_guess(0);
+    unsigned int allocations = arena.allocations;
+
+    for (int round = 0; round < 20; round++)
+    {
+        game_start_new_round();
+        game_send_guess(round % 5);
+        game_update(16);
+    }
+
+    TEST_ASSERT_EQUAL_UINT(allocations, arena.allocations);
+    game_cleanup();
+}
+
+void test_game_menu_title_floats_from_render_cache(void)
+{
+    static Color cache_buffer[8 * 1024];
+    static RenderCache cache;
+    static Color pixels[480 * 320];
+    static Framebuffer fb;
+    render_cache_init(&cache, cache_buffer, sizeof(cache_buffer));
+    fb = (Framebuffer){.pixels = pixels, .width = 480, .height = 320};
+    test_config.render_cache = &cache;
+
+    TEST_ASSERT_TRUE(game_init(&test_config));
+    game_render(&fb);
+    unsigned int captured = cache.misses;
+    TEST_ASSERT_TRUE(captured > 0);
+
+    for (int frame = 0; frame < 10; frame++)
+    {
+        game_update(16);
+        game_render(&fb);
+    }
+
+    TEST_ASSERT_EQUAL_INT(captured, cache.misses);
+    TEST_ASSERT_TRUE(cache.hits > 0);
+
+    game_cleanup();
+    TEST_ASSERT_NULL(render_cache_get_active());
+    TEST_ASSERT_EQUAL_INT(0, cache.entry_count);
+}
+
+void test_game_update_runs_result_feedback_to_completion(void)
+{
+    TEST_ASSERT_TRUE(game_init(&test_config));
+    game_start_new_round();
+    game_send_guess(0);
+
+    TEST_ASSERT_TRUE(timeline_is_running(game_get_timeline()));
+
+    for (int frame = 0; frame < 60; frame++)
+        game_update(16);
+
+    TEST_ASSERT_FALSE(timeline_is_running(game_get_timeline()));
+}
+
+void test_game_brush_cursor_moves_without_repainting_canvas(void)
+{
+    static Color pixels[480 * 320];
+    static Framebuffer fb;
+    fb = (Framebuffer){.pixels = pixels, .width = 480, .height = 320};
+
+    TEST_ASSERT_TRUE(game_init(&test_config));
+    game_on_play(NULL, NULL);
+    game_render(&fb);
+
+    Widget *canvas = game_page_get_canvas();
+    int canvas_x, canvas_y;
+    widget_get_screen_position(canvas, &canvas_x, &canvas_y);
+    Color under = pixels[(canvas_y + 50) * 480 + canvas_x + 50];
+
+    game_handle_mouse_move(canvas_x + 54, canvas_y + 54);
+    game_render(&fb);
+
+    const Overlay *cursor = game_get_brush_cursor();
+    TEST_ASSERT_TRUE(cursor->on_screen);
+    TEST_ASSERT_EQUAL_INT(canvas_x + 50, cursor->x);
+    TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_GRAY_50, pixels[(canvas_y + 50) * 480 + canvas_x + 50]));
+    TEST_ASSERT_FALSE(canvas->dirty);
+
+    game_handle_mouse_move(canvas_x + 100, canvas_y + 100);
+    TEST_ASSERT_FALSE(canvas->dirty);
+    game_render(&fb);
+
+    TEST_ASSERT_TRUE(COLOR_COMPARE(under, pixels[(canvas_y + 50) * 480 + canvas_x + 50]));
+
+    game_handle_mouse_move(0, 0);
+    game_render(&fb);
+
+    TEST_ASSERT_FALSE(cursor->on_screen);
+    TEST_ASSERT_TRUE(COLOR_COMPARE(under, pixels[(canvas_y + 100) * 480 + canvas_x + 96]));
+}
+
+void test_game_page_switch_restores_page_from_snapshot(void)
+{
+    static Color pixels[480 * 320];
+    static Color menu_pixels[480 * 320];
+    static SnapshotRun menu_runs[4096];
+    static SnapshotRun game_runs[4096];
+    static PageSnapshot menu_snapshot;
+    static PageSnapshot game_snapshot;
+    static Framebuffer fb;
+    fb = (Framebuffer){.pixels = pixels, .width = 480, .height = 320};
+    page_snapshot_init(&menu_snapshot, menu_runs, sizeof(menu_runs));
+    page_snapshot_init(&game_snapshot, game_runs, sizeof(game_runs));
+    test_config.menu_snapshot = &menu_snapshot;
+    test_config.game_snapshot = &game_snapshot;
+
+    TEST_ASSERT_TRUE(game_init(&test_config));
+    game_render(&fb);
+    memcpy(menu_pixels, pixels, sizeof(pixels));
+
+    game_on_play(NULL, NULL);
+    TEST_ASSERT_EQUAL_INT(GAME_STATE_PLAYING, game_get_state());
+    game_render(&fb);
+    TEST_ASSERT_TRUE(menu_snapshot.valid);
+    TEST_ASSERT_TRUE(memcmp(menu_pixels, pixels, sizeof(pixels)) != 0);
+
+    Widget *canvas = game_page_get_canvas();
+    int canvas_x, canvas_y;
+    widget_get_screen_position(canvas, &canvas_x, &canvas_y);
+    game_handle_mouse_down(canvas_x + 20, canvas_y + 20);
+    game_handle_mouse_move(canvas_x + 60, canvas_y + 20);
+    game_handle_mouse_up(canvas_x + 60, canvas_y + 20);
+    game_render(&fb);
+
+    game_on_menu(NULL, NULL);
+    game_render(&fb);
+
+    TEST_ASSERT_TRUE(game_snapshot.valid);
+    TEST_ASSERT_TRUE(memcmp(menu_pixels, pixels, sizeof(pixels)) == 0);
+    TEST_ASSERT_FALSE(canvas->dirty);
+}
+
+void test_game_guess_through_accelerator_does_not_block(void)
+{
+    static Color pixels[480 * 320];
+    static Framebuffer fb;
+    fb = (Framebuffer){.pixels = pixels, .width = 480, .height = 320};
+    InferenceSim sim;
+    inference_sim_init(&sim, 200, 5, NULL, NULL);
+    InferenceBackend backend = inference_sim_backend(&sim);
+    test_config.inference_backend = &backend;
+    test_config.inference_timeout_ms = 1000;
+
+    TEST_ASSERT_TRUE(game_init(&test_config));
+    game_on_play(NULL, NULL);
+    game_on_guess(NULL, NULL);
+
+    TEST_ASSERT_FALSE(guess_callback_called);
+    TEST_ASSERT_TRUE(game_is_guess_pending());
+    game_update(16);
+    game_render(&fb);
+    TEST_ASSERT_TRUE(sim.busy);
+    TEST_ASSERT_TRUE(game_get_overlays()->overlays[0]->on_screen);
+
+    // Drawing again makes the request in flight worthless
+    Widget *canvas = game_page_get_canvas();
+    int canvas_x, canvas_y;
+    widget_get_screen_position(canvas, &canvas_x, &canvas_y);
+    game_handle_mouse_down(canvas_x + 20, canvas_y + 20);
+    game_handle_mouse_up(canvas_x + 20, canvas_y + 20);
+    game_update(16);
+    TEST_ASSERT_FALSE(game_is_guess_pending());
+    TEST_ASSERT_EQUAL_INT(1, sim.cancelled);
+    TEST_ASSERT_TRUE(game_canvas_changed());
+
+    game_on_guess(NULL, NULL);
+    game_update(16);
+    inference_sim_advance(&sim, 200);
+    game_update(16);
+
+    TEST_ASSERT_FALSE(game_is_guess_pending());
+    TEST_ASSERT_FALSE(game_canvas_changed());
+    game_render(&fb);
+    TEST_ASSERT_FALSE(game_get_overlays()->overlays[0]->on_screen);
+}
+
+void test_game_guess_that_times_out_is_requested_again(void)
+{
+    InferenceSim sim;
+    inference_sim_init(&sim, 500, 5, NULL, NULL);
+    InferenceBackend backend = inference_sim_backend(&sim);
+    test_config.inference_backend = &backend;
+    test_config.inference_timeout_ms = 200;
+
+    TEST_ASSERT_TRUE(game_init(&test_config));
+    game_on_play(NULL, NULL);
+    game_on_guess(NULL, NULL);
+    TEST_ASSERT_FALSE(game_canvas_changed());
+
+    game_update(16);
+    inference_sim_advance(&sim, 200);
+    game_update(200);
+
+    TEST_ASSERT_FALSE(game_is_guess_pending());
+    TEST_ASSERT_EQUAL_INT(1, sim.cancelled);
+    TEST_ASSERT_TRUE(game_canvas_changed());
+
+    game_on_guess(NULL, NULL);
+    game_update(16);
+    TEST_ASSERT_TRUE(game_is_guess_pending());
+    TEST_ASSERT_EQUAL_INT(2, sim.submitted);
+    TEST_ASSERT_FALSE(game_canvas_changed());
+}
+
+void test_game_guess_stops_asking_a_hung_accelerator(void)
+{
+    InferenceSim sim;
+    inference_sim_init(&sim, 10000, 5, NULL, NULL);
+    InferenceBackend backend = inference_sim_backend(&sim);
+    test_config.inference_backend = &backend;
+    test_config.inference_timeout_ms = 200;
+
+    TEST_ASSERT_TRUE(game_init(&test_config));
+    game_on_play(NULL, NULL);
+    game_on_guess(NULL, NULL);
+
+    for (int i = 0; i < 10; i++)
+    {
+        game_update(16);
+        inference_sim_advance(&sim, 200);
+        game_update(200);
+        if (game_canvas_changed())
+            game_on_guess(NULL, NULL);
+    }
+
+    TEST_ASSERT_EQUAL_INT(3, sim.submitted);
+    TEST_ASSERT_FALSE(game_canvas_changed());
+
+    // A new stroke is a new drawing, which gets its own attempts
+    Widget *canvas = game_page_get_canvas();
+    int canvas_x, canvas_y;
+    widget_get_screen_position(canvas, &canvas_x, &canvas_y);
+    game_handle_mouse_down(canvas_x + 20, canvas_y + 20);
+    game_handle_mouse_up(canvas_x + 20, canvas_y + 20);
+    game_update(16);
+    TEST_ASSERT_TRUE(game_canvas_changed());
+    game_on_guess(NULL, NULL);
+    game_update(16);
+    inference_sim_advance(&sim, 200);
+    game_update(200);
+
+    TEST_ASSERT_EQUAL_INT(4, sim.submitted);
+    TEST_ASSERT_TRUE(game_canvas_changed());
+}
+
 int main(void)
 {
     UNITY_BEGIN();
@@ -285,6 +748,24 @@ int main(void)
     RUN_TEST(test_game_on_play);
     RUN_TEST(test_game_on_menu);
     RUN_TEST(test_game_on_skip);
+    RUN_TEST(test_game_canvas_changed_after_drawing);
+    RUN_TEST(test_game_records_stroke_log);
+    RUN_TEST(test_game_without_stroke_log);
+    RUN_TEST(test_game_undo_redo_stroke);
+    RUN_TEST(test_game_undo_without_history);
+    RUN_TEST(test_game_queued_input_draws_on_update);
+    RUN_TEST(test_game_queued_input_keeps_every_corner);
+    RUN_TEST(test_game_queue_input_before_init);
+    RUN_TEST(test_game_drains_touch_ring);
+    RUN_TEST(test_game_builds_ui_in_arena);
+    RUN_TEST(test_game_steady_state_does_not_allocate);
+    RUN_TEST(test_game_menu_title_floats_from_render_cache);
+    RUN_TEST(test_game_update_runs_result_feedback_to_completion);
+    RUN_TEST(test_game_brush_cursor_moves_without_repainting_canvas);
+    RUN_TEST(test_game_page_switch_restores_page_from_snapshot);
+    RUN_TEST(test_game_guess_through_accelerator_does_not_block);
+    RUN_TEST(test_game_guess_that_times_out_is_requested_again);
+    RUN_TEST(test_game_guess_stops_asking_a_hung_accelerator);
 
     return UNITY_END();
 }
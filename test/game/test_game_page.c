@@ -1,6 +1,7 @@
 #include "game.h"
 #include "game_page.h"
 #include "unity.h"
+#include "widgets/canvas.h"
 #include "widgets/widget.h"
 #include <stdlib.h>
 #include <string.h>
@@ -175,6 +176,82 @@ void test_game_page_with_default_canvas_size(void)
     TEST_ASSERT_NOT_NULL(canvas);
 }
 
+void test_game_page_get_canvas_28x28_non_multiple_size(void)
+{
+    test_config.canvas_width = 230;
+    test_config.canvas_height = 230;
+    Widget *page = game_page_init(&test_config);
+    TEST_ASSERT_NOT_NULL(page);
+
+    Widget *canvas = game_page_get_canvas();
+    canvas_set_brush_size(canvas, 9);
+    canvas_draw_at(canvas, canvas->x + 4, canvas->y + 4);
+
+    uint8_t output[28 * 28];
+    game_page_get_canvas_28x28(output);
+
+    TEST_ASSERT_EQUAL_UINT8(255, output[0]);
+    TEST_ASSERT_EQUAL_UINT8(0, output[27]);
+    TEST_ASSERT_EQUAL_UINT8(0, output[28 * 28 - 1]);
+}
+
+static Widget *init_wide_canvas_with_line(void)
+{
+    test_config.window_width = 640;
+    test_config.canvas_width = 600;
+    test_config.canvas_height = 100;
+    TEST_ASSERT_NOT_NULL(game_page_init(&test_config));
+
+    Widget *canvas = game_page_get_canvas();
+    TEST_ASSERT_EQUAL_INT(600, canvas->width);
+    canvas_set_brush_size(canvas, 9);
+    canvas_begin_stroke(canvas, canvas->x + 10, canvas->y + 50);
+    canvas_draw_at(canvas, canvas->x + 590, canvas->y + 50);
+    canvas_end_stroke(canvas);
+    return canvas;
+}
+
+void test_game_page_get_canvas_28x28_wider_than_resampler(void)
+{
+    Widget *canvas = init_wide_canvas_with_line();
+
+    uint8_t expected[28 * 28];
+    uint8_t output[28 * 28];
+    memset(output, 0xAA, sizeof(output));
+    canvas_get_downsample(canvas, expected);
+    game_page_get_canvas_28x28(output);
+
+    TEST_ASSERT_EQUAL_MEMORY(expected, output, sizeof(output));
+}
+
+void test_game_page_get_canvas_preprocessed_wider_than_resampler(void)
+{
+    init_wide_canvas_with_line();
+
+    uint8_t expected[28 * 28];
+    uint8_t output[28 * 28];
+    memset(output, 0xAA, sizeof(output));
+    game_page_get_canvas_28x28(expected);
+    game_page_get_canvas_preprocessed(output);
+
+    TEST_ASSERT_EQUAL_MEMORY(expected, output, sizeof(output));
+}
+
+void test_game_page_get_canvas_preprocessed_centers_drawing(void)
+{
+    Widget *page = game_page_init(&test_config);
+    TEST_ASSERT_NOT_NULL(page);
+
+    Widget *canvas = game_page_get_canvas();
+    canvas_draw_at(canvas, canvas->x + 10, canvas->y + 10);
+
+    uint8_t output[28 * 28];
+    game_page_get_canvas_preprocessed(output);
+
+    TEST_ASSERT_EQUAL_UINT8(0, output[0]);
+    TEST_ASSERT_EQUAL_UINT8(255, output[14 * 28 + 14]);
+}
+
 int main(void)
 {
     UNITY_BEGIN();
@@ -194,6 +271,10 @@ int main(void)
     RUN_TEST(test_game_page_multiple_rounds);
     RUN_TEST(test_game_page_reset_after_rounds);
     RUN_TEST(test_game_page_with_default_canvas_size);
+    RUN_TEST(test_game_page_get_canvas_28x28_non_multiple_size);
+    RUN_TEST(test_game_page_get_canvas_preprocessed_centers_drawing);
+    RUN_TEST(test_game_page_get_canvas_28x28_wider_than_resampler);
+    RUN_TEST(test_game_page_get_canvas_preprocessed_wider_than_resampler);
 
     return UNITY_END();
 }
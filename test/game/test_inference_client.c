@@ -0,0 +1,197 @@
+#include "inference_client.h"
+#include "inference_sim.h"
+#include "unity.h"
+#include <string.h>
+
+#define LATENCY_MS 100
+#define TIMEOUT_MS 250
+
+static InferenceSim sim;
+static InferenceBackend backend;
+static InferenceClient client;
+static uint8_t input[INFERENCE_INPUT_SIZE];
+
+// Advances the device and the client together, as the main loop does once per frame
+static bool step(int delta_ms, InferenceResult *result)
+{
+    inference_sim_advance(&sim, delta_ms);
+    return inference_client_update(&client, delta_ms, result);
+}
+
+static int classify_first_pixel(const uint8_t *pixels, void *user_data)
+{
+    (void)user_data;
+    return pixels[0];
+}
+
+void setUp(void)
+{
+    memset(input, 0, sizeof(input));
+    inference_sim_init(&sim, LATENCY_MS, 10, classify_first_pixel, NULL);
+    backend = inference_sim_backend(&sim);
+    inference_client_init(&client, &backend, TIMEOUT_MS);
+}
+
+void tearDown(void)
+{
+}
+
+void test_request_completes_after_device_latency(void)
+{
+    input[0] = 7;
+    uint32_t sequence = inference_client_submit(&client, input, 1);
+    InferenceResult result;
+
+    TEST_ASSERT_EQUAL_INT(1, (int)sequence);
+    TEST_ASSERT_FALSE(step(0, &result));
+    TEST_ASSERT_TRUE(sim.busy);
+    TEST_ASSERT_FALSE(step(LATENCY_MS - 1, &result));
+    TEST_ASSERT_TRUE(inference_client_is_pending(&client));
+
+    TEST_ASSERT_TRUE(step(1, &result));
+    TEST_ASSERT_EQUAL_INT((int)sequence, (int)result.sequence);
+    TEST_ASSERT_EQUAL_INT(7, result.guess_index);
+    TEST_ASSERT_FALSE(result.timed_out);
+    TEST_ASSERT_FALSE(inference_client_is_pending(&client));
+    TEST_ASSERT_EQUAL_INT(1, client.completed);
+}
+
+void test_input_is_copied_on_submit(void)
+{
+    input[0] = 3;
+    inference_client_submit(&client, input, 1);
+    input[0] = 9;
+    InferenceResult result;
+
+    step(0, &result);
+    TEST_ASSERT_TRUE(step(LATENCY_MS, &result));
+
+    TEST_ASSERT_EQUAL_INT(3, result.guess_index);
+}
+
+void test_requests_wait_while_device_is_busy(void)
+{
+    uint32_t first = inference_client_submit(&client, input, 1);
+    uint32_t second = inference_client_submit(&client, input, 1);
+    InferenceResult result;
+
+    TEST_ASSERT_TRUE(second > first);
+    step(0, &result);
+    TEST_ASSERT_FALSE(client.requests[1].in_flight);
+
+    TEST_ASSERT_TRUE(step(LATENCY_MS, &result));
+    TEST_ASSERT_EQUAL_INT((int)first, (int)result.sequence);
+
+    TEST_ASSERT_FALSE(step(0, &result));
+    TEST_ASSERT_TRUE(step(LATENCY_MS, &result));
+    TEST_ASSERT_EQUAL_INT((int)second, (int)result.sequence);
+    TEST_ASSERT_EQUAL_INT(2, sim.submitted);
+}
+
+void test_queue_is_bounded(void)
+{
+    for (int i = 0; i < INFERENCE_QUEUE_CAPACITY; i++)
+        TEST_ASSERT_TRUE(inference_client_submit(&client, input, 1) != 0);
+
+    TEST_ASSERT_EQUAL_INT(0, (int)inference_client_submit(&client, input, 1));
+}
+
+void test_cancel_stale_drops_requests_for_older_drawings(void)
+{
+    inference_client_submit(&client, input, 1);
+    inference_client_submit(&client, input, 2);
+    InferenceResult result;
+    step(0, &result);
+
+    inference_client_cancel_stale(&client, 2);
+
+    TEST_ASSERT_EQUAL_INT(1, client.count);
+    TEST_ASSERT_EQUAL_INT(1, client.cancelled);
+    TEST_ASSERT_EQUAL_INT(1, sim.cancelled);
+    TEST_ASSERT_FALSE(sim.busy);
+
+    // The device is free again, so the surviving request starts straight away
+    TEST_ASSERT_FALSE(step(0, &result));
+    TEST_ASSERT_TRUE(sim.busy);
+}
+
+void test_request_past_timeout_is_given_up(void)
+{
+    inference_sim_init(&sim, TIMEOUT_MS * 2, 10, NULL, NULL);
+    inference_client_submit(&client, input, 1);
+    InferenceResult result;
+    step(0, &result);
+
+    TEST_ASSERT_TRUE(step(TIMEOUT_MS, &result));
+
+    TEST_ASSERT_TRUE(result.timed_out);
+    TEST_ASSERT_EQUAL_INT(1, (int)result.sequence);
+    TEST_ASSERT_EQUAL_INT(1, (int)result.canvas_version);
+    TEST_ASSERT_FALSE(inference_client_is_pending(&client));
+    TEST_ASSERT_EQUAL_INT(1, client.timed_out);
+    TEST_ASSERT_EQUAL_INT(1, sim.cancelled);
+}
+
+static bool late_reported;
+
+static bool late_submit(void *context, uint32_t sequence, const uint8_t *pixels)
+{
+    (void)context;
+    (void)sequence;
+    (void)pixels;
+    return true;
+}
+
+// Answers sequence 1 no matter what was asked or cancelled, like a device that cannot abort
+static bool late_poll(void *context, uint32_t *sequence, int *guess_index)
+{
+    (void)context;
+    if (late_reported)
+        return false;
+
+    late_reported = true;
+    *sequence = 1;
+    *guess_index = 4;
+    return true;
+}
+
+void test_answer_to_a_cancelled_request_is_dropped(void)
+{
+    InferenceBackend late = {late_submit, late_poll, NULL, NULL};
+    inference_client_init(&client, &late, 0);
+    late_reported = false;
+
+    inference_client_submit(&client, input, 1);
+    inference_client_cancel_all(&client);
+    uint32_t current = inference_client_submit(&client, input, 2);
+    InferenceResult result;
+
+    TEST_ASSERT_FALSE(inference_client_update(&client, 10, &result));
+
+    TEST_ASSERT_EQUAL_INT(1, client.stale);
+    TEST_ASSERT_TRUE(inference_client_is_pending(&client));
+    TEST_ASSERT_EQUAL_INT(2, (int)current);
+}
+
+void test_client_without_backend_takes_no_requests(void)
+{
+    inference_client_init(&client, NULL, 0);
+
+    TEST_ASSERT_EQUAL_INT(0, (int)inference_client_submit(&client, input, 1));
+    TEST_ASSERT_FALSE(inference_client_update(&client, 10, NULL));
+    TEST_ASSERT_FALSE(inference_client_is_pending(NULL));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_request_completes_after_device_latency);
+    RUN_TEST(test_input_is_copied_on_submit);
+    RUN_TEST(test_requests_wait_while_device_is_busy);
+    RUN_TEST(test_queue_is_bounded);
+    RUN_TEST(test_cancel_stale_drops_requests_for_older_drawings);
+    RUN_TEST(test_request_past_timeout_is_given_up);
+    RUN_TEST(test_answer_to_a_cancelled_request_is_dropped);
+    RUN_TEST(test_client_without_backend_takes_no_requests);
+    return UNITY_END();
+}
@@ -0,0 +1,168 @@
+#include "input_queue.h"
+#include "unity.h"
+
+static InputQueue queue;
+
+void setUp(void)
+{
+    input_queue_init(&queue);
+}
+
+void tearDown(void)
+{
+}
+
+void test_input_queue_empty(void)
+{
+    InputEvent event;
+    TEST_ASSERT_FALSE(input_queue_pop(&queue, &event));
+    TEST_ASSERT_EQUAL_UINT(0, queue.count);
+}
+
+void test_input_queue_preserves_order_and_timestamps(void)
+{
+    input_queue_push(&queue, INPUT_EVENT_POINTER_DOWN, 1, 2, 100);
+    input_queue_push(&queue, INPUT_EVENT_POINTER_MOVE, 5, 9, 110);
+    input_queue_push(&queue, INPUT_EVENT_POINTER_UP, 5, 9, 120);
+
+    InputEvent event;
+    TEST_ASSERT_TRUE(input_queue_pop(&queue, &event));
+    TEST_ASSERT_EQUAL_INT(INPUT_EVENT_POINTER_DOWN, event.type);
+    TEST_ASSERT_EQUAL_INT(1, event.x);
+    TEST_ASSERT_EQUAL_INT(2, event.y);
+    TEST_ASSERT_EQUAL_UINT32(100, event.timestamp);
+
+    TEST_ASSERT_TRUE(input_queue_pop(&queue, &event));
+    TEST_ASSERT_EQUAL_INT(INPUT_EVENT_POINTER_MOVE, event.type);
+    TEST_ASSERT_EQUAL_UINT32(110, event.timestamp);
+
+    TEST_ASSERT_TRUE(input_queue_pop(&queue, &event));
+    TEST_ASSERT_EQUAL_INT(INPUT_EVENT_POINTER_UP, event.type);
+    TEST_ASSERT_FALSE(input_queue_pop(&queue, &event));
+}
+
+void test_input_queue_coalesces_repeated_point(void)
+{
+    input_queue_push(&queue, INPUT_EVENT_POINTER_DOWN, 0, 0, 0);
+    input_queue_push(&queue, INPUT_EVENT_POINTER_MOVE, 3, 4, 1);
+    input_queue_push(&queue, INPUT_EVENT_POINTER_MOVE, 3, 4, 2);
+
+    TEST_ASSERT_EQUAL_UINT(2, queue.count);
+    TEST_ASSERT_EQUAL_UINT(1, queue.coalesced);
+
+    InputEvent event;
+    input_queue_pop(&queue, &event);
+    input_queue_pop(&queue, &event);
+    TEST_ASSERT_EQUAL_UINT32(2, event.timestamp);
+}
+
+void test_input_queue_coalesces_straight_run(void)
+{
+    input_queue_push(&queue, INPUT_EVENT_POINTER_DOWN, 0, 0, 0);
+    for (int i = 1; i <= 10; i++)
+    {
+        input_queue_push(&queue, INPUT_EVENT_POINTER_MOVE, i * 2, i, (uint32_t)i);
+    }
+
+    TEST_ASSERT_EQUAL_UINT(2, queue.count);
+
+    InputEvent event;
+    input_queue_pop(&queue, &event);
+    input_queue_pop(&queue, &event);
+    TEST_ASSERT_EQUAL_INT(20, event.x);
+    TEST_ASSERT_EQUAL_INT(10, event.y);
+}
+
+void test_input_queue_keeps_corners(void)
+{
+    input_queue_push(&queue, INPUT_EVENT_POINTER_DOWN, 0, 0, 0);
+    input_queue_push(&queue, INPUT_EVENT_POINTER_MOVE, 5, 0, 1);
+    input_queue_push(&queue, INPUT_EVENT_POINTER_MOVE, 5, 5, 2);
+    input_queue_push(&queue, INPUT_EVENT_POINTER_MOVE, 0, 5, 3);
+    input_queue_push(&queue, INPUT_EVENT_POINTER_MOVE, 5, 5, 4);
+
+    TEST_ASSERT_EQUAL_UINT(5, queue.count);
+    TEST_ASSERT_EQUAL_UINT(0, queue.coalesced);
+}
+
+void test_input_queue_reserves_room_for_buttons(void)
+{
+    input_queue_push(&queue, INPUT_EVENT_POINTER_DOWN, 0, 0, 0);
+    for (int i = 0; i < INPUT_QUEUE_CAPACITY * 2; i++)
+    {
+        input_queue_push(&queue, INPUT_EVENT_POINTER_MOVE, i % 2 ? i : 0, i % 2 ? 0 : i, (uint32_t)i);
+    }
+
+    TEST_ASSERT_EQUAL_UINT(INPUT_QUEUE_CAPACITY - 2, queue.count);
+    TEST_ASSERT_TRUE(input_queue_push(&queue, INPUT_EVENT_POINTER_UP, 0, 0, 1000));
+    TEST_ASSERT_TRUE(input_queue_push(&queue, INPUT_EVENT_POINTER_DOWN, 0, 0, 1001));
+    TEST_ASSERT_FALSE(input_queue_push(&queue, INPUT_EVENT_POINTER_UP, 0, 0, 1002));
+    TEST_ASSERT_EQUAL_UINT(1, queue.dropped);
+
+    InputEvent event;
+    int popped = 0;
+    while (input_queue_pop(&queue, &event))
+        popped++;
+    TEST_ASSERT_EQUAL_INT(INPUT_QUEUE_CAPACITY, popped);
+    TEST_ASSERT_EQUAL_INT(INPUT_EVENT_POINTER_DOWN, event.type);
+}
+
+void test_input_queue_wraps_around(void)
+{
+    InputEvent event;
+    for (int round = 0; round < 3; round++)
+    {
+        for (int i = 0; i < INPUT_QUEUE_CAPACITY / 2; i++)
+        {
+            input_queue_push(&queue, INPUT_EVENT_POINTER_DOWN, i, round, 0);
+        }
+        for (int i = 0; i < INPUT_QUEUE_CAPACITY / 2; i++)
+        {
+            TEST_ASSERT_TRUE(input_queue_pop(&queue, &event));
+            TEST_ASSERT_EQUAL_INT(i, event.x);
+            TEST_ASSERT_EQUAL_INT(round, event.y);
+        }
+    }
+}
+
+void test_input_queue_with_null(void)
+{
+    InputEvent event;
+    input_queue_init(NULL);
+    TEST_ASSERT_FALSE(input_queue_push(NULL, INPUT_EVENT_POINTER_DOWN, 0, 0, 0));
+    TEST_ASSERT_FALSE(input_queue_pop(NULL, &event));
+    TEST_ASSERT_FALSE(input_queue_pop(&queue, NULL));
+}
+
+void test_input_queue_counts_corners_lost_when_full(void)
+{
+    input_queue_push(&queue, INPUT_EVENT_POINTER_DOWN, 0, 0, 0);
+    for (int i = 1; !input_queue_is_full(&queue); i++)
+        input_queue_push(&queue, INPUT_EVENT_POINTER_MOVE, i, i % 2, (uint32_t)i);
+
+    TEST_ASSERT_EQUAL_UINT(0, queue.coalesced);
+    TEST_ASSERT_TRUE(input_queue_push(&queue, INPUT_EVENT_POINTER_MOVE, 100, 50, 100));
+    TEST_ASSERT_TRUE(input_queue_push(&queue, INPUT_EVENT_POINTER_MOVE, 100, 50, 101));
+
+    TEST_ASSERT_EQUAL_UINT(INPUT_QUEUE_CAPACITY - 2, queue.count);
+    TEST_ASSERT_EQUAL_UINT(1, queue.replaced);
+    TEST_ASSERT_EQUAL_UINT(1, queue.coalesced);
+    TEST_ASSERT_FALSE(input_queue_is_full(NULL));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_input_queue_empty);
+    RUN_TEST(test_input_queue_preserves_order_and_timestamps);
+    RUN_TEST(test_input_queue_coalesces_repeated_point);
+    RUN_TEST(test_input_queue_coalesces_straight_run);
+    RUN_TEST(test_input_queue_keeps_corners);
+    RUN_TEST(test_input_queue_reserves_room_for_buttons);
+    RUN_TEST(test_input_queue_wraps_around);
+    RUN_TEST(test_input_queue_with_null);
+    RUN_TEST(test_input_queue_counts_corners_lost_when_full);
+
+    return UNITY_END();
+}
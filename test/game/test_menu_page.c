@@ -1,6 +1,9 @@
+#include "font_medium.h"
 #include "game.h"
+#include "gui_arena.h"
 #include "menu_page.h"
 #include "unity.h"
+#include "widgets/container.h"
 #include "widgets/widget.h"
 #include <stdlib.h>
 
@@ -52,9 +55,9 @@ void test_menu_page_update(void)
     Widget *menu = menu_page_init(&test_config);
     TEST_ASSERT_NOT_NULL(menu);
 
-    menu_page_update(0.016f);
-    menu_page_update(0.032f);
-    menu_page_update(0.1f);
+    menu_page_update(16);
+    menu_page_update(32);
+    menu_page_update(100);
 }
 
 void test_menu_page_update_with_zero_delta(void)
@@ -62,7 +65,7 @@ void test_menu_page_update_with_zero_delta(void)
     Widget *menu = menu_page_init(&test_config);
     TEST_ASSERT_NOT_NULL(menu);
 
-    menu_page_update(0.0f);
+    menu_page_update(0);
 }
 
 void test_menu_page_update_with_large_delta(void)
@@ -70,8 +73,8 @@ void test_menu_page_update_with_large_delta(void)
     Widget *menu = menu_page_init(&test_config);
     TEST_ASSERT_NOT_NULL(menu);
 
-    menu_page_update(1.0f);
-    menu_page_update(10.0f);
+    menu_page_update(1000);
+    menu_page_update(10000);
 }
 
 void test_menu_page_multiple_updates(void)
@@ -81,7 +84,7 @@ void test_menu_page_multiple_updates(void)
 
     for (int i = 0; i < 100; i++)
     {
-        menu_page_update(0.016f);
+        menu_page_update(16);
     }
 }
 
@@ -120,6 +123,83 @@ void test_menu_page_double_cleanup(void)
     menu_page_cleanup();
 }
 
+static int collect_geometry(Widget *widget, int *out, int count)
+{
+    out[count++] = widget->x;
+    out[count++] = widget->y;
+    out[count++] = widget->width;
+    out[count++] = widget->height;
+
+    for (int i = 0; i < container_get_child_count(widget); i++)
+        count = collect_geometry(container_get_child(widget, i), out, count);
+
+    return count;
+}
+
+// The window size the prebuilt menu in assets/menu_layout.json is laid out for
+static void use_prebuilt_size(void)
+{
+    test_config.window_width = 272;
+    test_config.window_height = 480;
+}
+
+void test_menu_page_boots_prebuilt_tree_without_allocating(void)
+{
+    use_prebuilt_size();
+    static uint8_t buffer[4096];
+    GuiArena arena;
+    gui_arena_init(&arena, buffer, sizeof(buffer));
+    gui_set_arena(&arena);
+
+    Widget *menu = menu_page_init(&test_config);
+    gui_set_arena(NULL);
+
+    TEST_ASSERT_NOT_NULL(menu);
+    TEST_ASSERT_TRUE(menu->preallocated);
+    TEST_ASSERT_FALSE(menu->needs_layout);
+    TEST_ASSERT_EQUAL_UINT(0, arena.allocations);
+}
+
+void test_menu_page_prebuilt_tree_matches_runtime_layout(void)
+{
+    static int prebuilt[64];
+    static int runtime[64];
+    use_prebuilt_size();
+
+    Widget *menu = menu_page_init(&test_config);
+    // Only the floating title is left to lay out, since its offsets follow the animation phase
+    container_update_layout(container_get_child(menu, 0));
+    int prebuilt_count = collect_geometry(menu, prebuilt, 0);
+    menu_page_cleanup();
+
+    test_config.button_font = &font_medium_font;
+    menu = menu_page_init(&test_config);
+    TEST_ASSERT_FALSE(menu->preallocated);
+    int runtime_count = collect_geometry(menu, runtime, 0);
+
+    TEST_ASSERT_EQUAL_INT(4 * 12, prebuilt_count);
+    TEST_ASSERT_EQUAL_INT(runtime_count, prebuilt_count);
+    for (int i = 0; i < runtime_count; i++)
+        TEST_ASSERT_EQUAL_INT(runtime[i], prebuilt[i]);
+}
+
+void test_menu_page_prebuilt_tree_resets_on_init(void)
+{
+    use_prebuilt_size();
+    Widget *menu = menu_page_init(&test_config);
+    Widget *play = container_get_child(menu, 1);
+    int play_y = play->y;
+    widget_set_position(play, 0, 0);
+    widget_destroy(menu);
+    menu_page_cleanup();
+
+    menu = menu_page_init(&test_config);
+
+    TEST_ASSERT_EQUAL_PTR(play, container_get_child(menu, 1));
+    TEST_ASSERT_EQUAL_INT(play_y, play->y);
+    TEST_ASSERT_TRUE(play->dirty);
+}
+
 int main(void)
 {
     UNITY_BEGIN();
@@ -134,6 +214,9 @@ int main(void)
     RUN_TEST(test_menu_page_with_custom_fonts);
     RUN_TEST(test_menu_page_init_with_different_window_sizes);
     RUN_TEST(test_menu_page_double_cleanup);
+    RUN_TEST(test_menu_page_boots_prebuilt_tree_without_allocating);
+    RUN_TEST(test_menu_page_prebuilt_tree_matches_runtime_layout);
+    RUN_TEST(test_menu_page_prebuilt_tree_resets_on_init);
 
     return UNITY_END();
 }
@@ -0,0 +1,193 @@
+#include "preprocess.h"
+#include "unity.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define CANVAS_SIZE 100
+
+static uint8_t canvas[CANVAS_SIZE * CANVAS_SIZE];
+static uint8_t output[PREPROCESS_OUTPUT_SIZE * PREPROCESS_OUTPUT_SIZE];
+
+void setUp(void)
+{
+    memset(canvas, 0, sizeof(canvas));
+    memset(output, 0xAA, sizeof(output));
+}
+
+void tearDown(void)
+{
+}
+
+static void fill_rect(int x, int y, int width, int height)
+{
+    for (int row = y; row < y + height; row++)
+    {
+        memset(canvas + row * CANVAS_SIZE + x, 255, width);
+    }
+}
+
+static bool preprocess_canvas(int stroke_width)
+{
+    PreprocessBounds bounds;
+    PreprocessOptions options = {.stroke_width = stroke_width};
+
+    if (!preprocess_find_ink_bounds(canvas, CANVAS_SIZE, CANVAS_SIZE, CANVAS_SIZE, &bounds))
+        return false;
+
+    return preprocess_drawing(canvas, CANVAS_SIZE, &bounds, &options, output);
+}
+
+static int ink_mass(void)
+{
+    int mass = 0;
+    for (int i = 0; i < PREPROCESS_OUTPUT_SIZE * PREPROCESS_OUTPUT_SIZE; i++)
+    {
+        mass += output[i];
+    }
+    return mass;
+}
+
+void test_preprocess_find_ink_bounds(void)
+{
+    fill_rect(30, 40, 5, 7);
+    fill_rect(60, 45, 2, 2);
+
+    PreprocessBounds bounds;
+    TEST_ASSERT_TRUE(preprocess_find_ink_bounds(canvas, CANVAS_SIZE, CANVAS_SIZE, CANVAS_SIZE, &bounds));
+
+    TEST_ASSERT_EQUAL_INT(30, bounds.x);
+    TEST_ASSERT_EQUAL_INT(40, bounds.y);
+    TEST_ASSERT_EQUAL_INT(32, bounds.width);
+    TEST_ASSERT_EQUAL_INT(7, bounds.height);
+}
+
+void test_preprocess_find_ink_bounds_empty(void)
+{
+    PreprocessBounds bounds;
+    TEST_ASSERT_FALSE(preprocess_find_ink_bounds(canvas, CANVAS_SIZE, CANVAS_SIZE, CANVAS_SIZE, &bounds));
+}
+
+void test_preprocess_empty_bounds_writes_blank_output(void)
+{
+    PreprocessBounds bounds = {0, 0, 0, 0};
+
+    TEST_ASSERT_FALSE(preprocess_drawing(canvas, CANVAS_SIZE, &bounds, NULL, output));
+
+    for (int i = 0; i < PREPROCESS_OUTPUT_SIZE * PREPROCESS_OUTPUT_SIZE; i++)
+    {
+        TEST_ASSERT_EQUAL_UINT8(0, output[i]);
+    }
+}
+
+void test_preprocess_scales_small_square_to_fit_box(void)
+{
+    fill_rect(5, 5, 10, 10);
+
+    TEST_ASSERT_TRUE(preprocess_canvas(0));
+
+    for (int y = 0; y < PREPROCESS_OUTPUT_SIZE; y++)
+    {
+        for (int x = 0; x < PREPROCESS_OUTPUT_SIZE; x++)
+        {
+            bool inside = x >= 4 && x < 24 && y >= 4 && y < 24;
+            TEST_ASSERT_EQUAL_UINT8(inside ? 255 : 0, output[y * PREPROCESS_OUTPUT_SIZE + x]);
+        }
+    }
+}
+
+void test_preprocess_keeps_aspect_ratio(void)
+{
+    fill_rect(10, 70, 80, 20);
+
+    TEST_ASSERT_TRUE(preprocess_canvas(0));
+
+    TEST_ASSERT_EQUAL_UINT8(0, output[11 * PREPROCESS_OUTPUT_SIZE + 14]);
+    TEST_ASSERT_EQUAL_UINT8(255, output[12 * PREPROCESS_OUTPUT_SIZE + 4]);
+    TEST_ASSERT_EQUAL_UINT8(255, output[16 * PREPROCESS_OUTPUT_SIZE + 23]);
+    TEST_ASSERT_EQUAL_UINT8(0, output[17 * PREPROCESS_OUTPUT_SIZE + 14]);
+    TEST_ASSERT_EQUAL_UINT8(0, output[14 * PREPROCESS_OUTPUT_SIZE + 3]);
+    TEST_ASSERT_EQUAL_UINT8(0, output[14 * PREPROCESS_OUTPUT_SIZE + 24]);
+}
+
+void test_preprocess_centers_by_mass(void)
+{
+    fill_rect(0, 0, 60, 60);
+    fill_rect(0, 0, 100, 4);
+
+    TEST_ASSERT_TRUE(preprocess_canvas(0));
+
+    uint32_t mass = 0;
+    uint32_t moment_x = 0;
+    uint32_t moment_y = 0;
+    for (int y = 0; y < PREPROCESS_OUTPUT_SIZE; y++)
+    {
+        for (int x = 0; x < PREPROCESS_OUTPUT_SIZE; x++)
+        {
+            uint32_t value = output[y * PREPROCESS_OUTPUT_SIZE + x];
+            mass += value;
+            moment_x += value * (2 * x + 1);
+            moment_y += value * (2 * y + 1);
+        }
+    }
+
+    TEST_ASSERT_INT_WITHIN(2, PREPROCESS_OUTPUT_SIZE, (int)(moment_x / mass));
+    TEST_ASSERT_INT_WITHIN(2, PREPROCESS_OUTPUT_SIZE, (int)(moment_y / mass));
+}
+
+void test_preprocess_thickens_thin_strokes(void)
+{
+    for (int i = 0; i < CANVAS_SIZE; i++)
+    {
+        canvas[i * CANVAS_SIZE + i] = 255;
+        canvas[i * CANVAS_SIZE + (CANVAS_SIZE - 1 - i)] = 255;
+    }
+
+    TEST_ASSERT_TRUE(preprocess_canvas(0));
+    int thin = ink_mass();
+
+    TEST_ASSERT_TRUE(preprocess_canvas(3));
+    int normalized = ink_mass();
+
+    TEST_ASSERT_GREATER_THAN(thin, normalized);
+}
+
+void test_preprocess_thins_thick_strokes_without_erasing(void)
+{
+    fill_rect(0, 0, 100, 100);
+
+    TEST_ASSERT_TRUE(preprocess_canvas(0));
+    int thick = ink_mass();
+
+    TEST_ASSERT_TRUE(preprocess_canvas(1));
+    int normalized = ink_mass();
+
+    TEST_ASSERT_LESS_THAN(thick, normalized);
+    TEST_ASSERT_GREATER_THAN(0, normalized);
+}
+
+void test_preprocess_with_null(void)
+{
+    PreprocessBounds bounds = {0, 0, 10, 10};
+
+    TEST_ASSERT_FALSE(preprocess_drawing(NULL, CANVAS_SIZE, &bounds, NULL, output));
+    TEST_ASSERT_FALSE(preprocess_drawing(canvas, CANVAS_SIZE, NULL, NULL, output));
+    TEST_ASSERT_FALSE(preprocess_drawing(canvas, CANVAS_SIZE, &bounds, NULL, NULL));
+    TEST_ASSERT_FALSE(preprocess_find_ink_bounds(canvas, CANVAS_SIZE, CANVAS_SIZE, CANVAS_SIZE, NULL));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_preprocess_find_ink_bounds);
+    RUN_TEST(test_preprocess_find_ink_bounds_empty);
+    RUN_TEST(test_preprocess_empty_bounds_writes_blank_output);
+    RUN_TEST(test_preprocess_scales_small_square_to_fit_box);
+    RUN_TEST(test_preprocess_keeps_aspect_ratio);
+    RUN_TEST(test_preprocess_centers_by_mass);
+    RUN_TEST(test_preprocess_thickens_thin_strokes);
+    RUN_TEST(test_preprocess_thins_thick_strokes_without_erasing);
+    RUN_TEST(test_preprocess_with_null);
+
+    return UNITY_END();
+}
@@ -0,0 +1,184 @@
+#include "resample.h"
+#include "unity.h"
+#include <stdlib.h>
+#include <string.h>
+
+static uint8_t source[300 * 300];
+static uint8_t output[RESAMPLE_MAX_OUTPUT_SIZE * RESAMPLE_MAX_OUTPUT_SIZE];
+
+void setUp(void)
+{
+    memset(source, 0, sizeof(source));
+    memset(output, 0xAA, sizeof(output));
+}
+
+void tearDown(void)
+{
+}
+
+static void fill_pattern(int width, int height)
+{
+    for (int i = 0; i < width * height; i++)
+    {
+        source[i] = (uint8_t)((i * 37 + (i / width) * 11) & 0xFF);
+    }
+}
+
+static uint8_t reference_pixel(const uint8_t *src, int src_width, int src_height, int dst_width, int dst_height,
+                               int ox, int oy)
+{
+    uint64_t sum = 0;
+
+    for (int sy = 0; sy < src_height; sy++)
+    {
+        long top = (long)oy * src_height > (long)sy * dst_height ? (long)oy * src_height : (long)sy * dst_height;
+        long bottom = (long)(oy + 1) * src_height < (long)(sy + 1) * dst_height ? (long)(oy + 1) * src_height
+                                                                                : (long)(sy + 1) * dst_height;
+        if (bottom <= top)
+            continue;
+
+        for (int sx = 0; sx < src_width; sx++)
+        {
+            long left = (long)ox * src_width > (long)sx * dst_width ? (long)ox * src_width : (long)sx * dst_width;
+            long right = (long)(ox + 1) * src_width < (long)(sx + 1) * dst_width ? (long)(ox + 1) * src_width
+                                                                                 : (long)(sx + 1) * dst_width;
+            if (right <= left)
+                continue;
+
+            sum += (uint64_t)src[sy * src_width + sx] * (uint64_t)((right - left) * (bottom - top));
+        }
+    }
+
+    uint64_t area = (uint64_t)src_width * src_height;
+    return (uint8_t)((sum + area / 2) / area);
+}
+
+static void assert_matches_reference(int src_width, int src_height, int dst_width, int dst_height)
+{
+    fill_pattern(src_width, src_height);
+
+    TEST_ASSERT_TRUE(resample_area(source, src_width, src_height, src_width, output, dst_width, dst_height));
+
+    for (int oy = 0; oy < dst_height; oy++)
+    {
+        for (int ox = 0; ox < dst_width; ox++)
+        {
+            TEST_ASSERT_EQUAL_UINT8(reference_pixel(source, src_width, src_height, dst_width, dst_height, ox, oy),
+                                    output[oy * dst_width + ox]);
+        }
+    }
+}
+
+void test_resample_identity_copies_source(void)
+{
+    fill_pattern(28, 28);
+
+    TEST_ASSERT_TRUE(resample_area(source, 28, 28, 28, output, 28, 28));
+    TEST_ASSERT_EQUAL_MEMORY(source, output, 28 * 28);
+}
+
+void test_resample_exact_multiple_averages_blocks(void)
+{
+    for (int y = 0; y < 224; y++)
+    {
+        for (int x = 0; x < 224; x++)
+        {
+            source[y * 224 + x] = (x < 8 && y < 8) ? 255 : ((x / 8 == 1 && x % 2 == 0 && y < 8) ? 255 : 0);
+        }
+    }
+
+    TEST_ASSERT_TRUE(resample_area(source, 224, 224, 224, output, 28, 28));
+
+    TEST_ASSERT_EQUAL_UINT8(255, output[0]);
+    TEST_ASSERT_EQUAL_UINT8(128, output[1]);
+    TEST_ASSERT_EQUAL_UINT8(0, output[2]);
+    TEST_ASSERT_EQUAL_UINT8(0, output[28]);
+}
+
+void test_resample_partial_pixel_weights(void)
+{
+    source[0] = 255;
+    source[1] = 0;
+    source[2] = 0;
+
+    TEST_ASSERT_TRUE(resample_area(source, 3, 1, 3, output, 2, 1));
+
+    TEST_ASSERT_EQUAL_UINT8(170, output[0]);
+    TEST_ASSERT_EQUAL_UINT8(0, output[1]);
+}
+
+void test_resample_non_multiple_matches_reference(void)
+{
+    assert_matches_reference(100, 80, 28, 28);
+    assert_matches_reference(230, 217, 28, 28);
+}
+
+void test_resample_exact_multiple_matches_reference(void)
+{
+    assert_matches_reference(224, 224, 28, 28);
+    assert_matches_reference(256, 64, 16, 8);
+}
+
+void test_resample_other_target_sizes(void)
+{
+    assert_matches_reference(224, 224, 32, 32);
+    assert_matches_reference(224, 224, 64, 48);
+}
+
+void test_resample_upscale(void)
+{
+    source[0] = 10;
+    source[1] = 200;
+
+    TEST_ASSERT_TRUE(resample_area(source, 2, 1, 2, output, 4, 2));
+
+    TEST_ASSERT_EQUAL_UINT8(10, output[0]);
+    TEST_ASSERT_EQUAL_UINT8(10, output[1]);
+    TEST_ASSERT_EQUAL_UINT8(200, output[2]);
+    TEST_ASSERT_EQUAL_UINT8(200, output[7]);
+}
+
+void test_resample_uses_stride(void)
+{
+    for (int y = 0; y < 16; y++)
+    {
+        for (int x = 0; x < 32; x++)
+        {
+            source[y * 32 + x] = x < 16 ? 255 : 0;
+        }
+    }
+
+    TEST_ASSERT_TRUE(resample_area(source + 8, 16, 16, 32, output, 2, 2));
+
+    TEST_ASSERT_EQUAL_UINT8(255, output[0]);
+    TEST_ASSERT_EQUAL_UINT8(0, output[1]);
+    TEST_ASSERT_EQUAL_UINT8(255, output[2]);
+    TEST_ASSERT_EQUAL_UINT8(0, output[3]);
+}
+
+void test_resample_rejects_invalid_arguments(void)
+{
+    TEST_ASSERT_FALSE(resample_area(NULL, 28, 28, 28, output, 28, 28));
+    TEST_ASSERT_FALSE(resample_area(source, 28, 28, 28, NULL, 28, 28));
+    TEST_ASSERT_FALSE(resample_area(source, 0, 28, 28, output, 28, 28));
+    TEST_ASSERT_FALSE(resample_area(source, 28, 28, 27, output, 28, 28));
+    TEST_ASSERT_FALSE(resample_area(source, 28, 28, 28, output, 0, 28));
+    TEST_ASSERT_FALSE(resample_area(source, 28, 28, 28, output, RESAMPLE_MAX_OUTPUT_SIZE + 1, 1));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_resample_identity_copies_source);
+    RUN_TEST(test_resample_exact_multiple_averages_blocks);
+    RUN_TEST(test_resample_partial_pixel_weights);
+    RUN_TEST(test_resample_non_multiple_matches_reference);
+    RUN_TEST(test_resample_exact_multiple_matches_reference);
+    RUN_TEST(test_resample_other_target_sizes);
+    RUN_TEST(test_resample_upscale);
+    RUN_TEST(test_resample_uses_stride);
+    RUN_TEST(test_resample_rejects_invalid_arguments);
+
+    return UNITY_END();
+}
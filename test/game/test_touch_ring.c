@@ -0,0 +1,164 @@
+#include "touch_ring.h"
+#include "unity.h"
+#include <pthread.h>
+
+#define STRESS_SAMPLES 2000000u
+
+static TouchRing ring;
+static atomic_bool producer_done;
+
+void setUp(void)
+{
+    touch_ring_init(&ring);
+}
+
+void tearDown(void)
+{
+}
+
+static TouchSample make_sample(uint32_t sequence)
+{
+    TouchSample sample;
+    sample.timestamp = sequence;
+    sample.x = (int16_t)(sequence & 0x7FFF);
+    sample.y = (int16_t)((sequence >> 15) & 0x7FFF);
+    sample.pressed = (sequence & 1) != 0;
+    return sample;
+}
+
+void test_touch_ring_empty(void)
+{
+    TouchSample sample;
+    TEST_ASSERT_FALSE(touch_ring_pop(&ring, &sample));
+    TEST_ASSERT_EQUAL_UINT(0, touch_ring_count(&ring));
+    TEST_ASSERT_EQUAL_UINT(0, touch_ring_overflow_count(&ring));
+}
+
+void test_touch_ring_fifo_order(void)
+{
+    for (uint32_t i = 0; i < 10; i++)
+    {
+        TouchSample sample = make_sample(i);
+        TEST_ASSERT_TRUE(touch_ring_push(&ring, &sample));
+    }
+    TEST_ASSERT_EQUAL_UINT(10, touch_ring_count(&ring));
+
+    TouchSample sample;
+    for (uint32_t i = 0; i < 10; i++)
+    {
+        TEST_ASSERT_TRUE(touch_ring_pop(&ring, &sample));
+        TEST_ASSERT_EQUAL_UINT32(i, sample.timestamp);
+        TEST_ASSERT_EQUAL_INT(i, sample.x);
+    }
+    TEST_ASSERT_FALSE(touch_ring_pop(&ring, &sample));
+}
+
+void test_touch_ring_counts_overflow(void)
+{
+    for (uint32_t i = 0; i < TOUCH_RING_SIZE + 5; i++)
+    {
+        TouchSample sample = make_sample(i);
+        touch_ring_push(&ring, &sample);
+    }
+
+    TEST_ASSERT_EQUAL_UINT(TOUCH_RING_SIZE, touch_ring_count(&ring));
+    TEST_ASSERT_EQUAL_UINT(5, touch_ring_overflow_count(&ring));
+
+    TouchSample sample;
+    TEST_ASSERT_TRUE(touch_ring_pop(&ring, &sample));
+    TEST_ASSERT_EQUAL_UINT32(0, sample.timestamp);
+
+    TouchSample extra = make_sample(1000);
+    TEST_ASSERT_TRUE(touch_ring_push(&ring, &extra));
+}
+
+void test_touch_ring_index_wraparound(void)
+{
+    atomic_store(&ring.head, 0xFFFFFFF0u);
+    atomic_store(&ring.tail, 0xFFFFFFF0u);
+
+    for (uint32_t i = 0; i < 40; i++)
+    {
+        TouchSample sample = make_sample(i);
+        TEST_ASSERT_TRUE(touch_ring_push(&ring, &sample));
+        TEST_ASSERT_TRUE(touch_ring_pop(&ring, &sample));
+        TEST_ASSERT_EQUAL_UINT32(i, sample.timestamp);
+    }
+    TEST_ASSERT_EQUAL_UINT(0, touch_ring_count(&ring));
+}
+
+static void *producer_thread(void *arg)
+{
+    (void)arg;
+
+    for (uint32_t i = 0; i < STRESS_SAMPLES; i++)
+    {
+        TouchSample sample = make_sample(i);
+        touch_ring_push(&ring, &sample);
+    }
+
+    atomic_store(&producer_done, true);
+    return NULL;
+}
+
+void test_touch_ring_concurrent_producer(void)
+{
+    pthread_t producer;
+    atomic_store(&producer_done, false);
+    TEST_ASSERT_EQUAL_INT(0, pthread_create(&producer, NULL, producer_thread, NULL));
+
+    uint32_t received = 0;
+    int64_t previous = -1;
+    bool ordered = true;
+    bool intact = true;
+    TouchSample sample;
+
+    for (;;)
+    {
+        // Read the flag first so samples pushed just before it was set are still drained below
+        bool done = atomic_load(&producer_done);
+
+        while (touch_ring_pop(&ring, &sample))
+        {
+            TouchSample expected = make_sample(sample.timestamp);
+            intact = intact && sample.x == expected.x && sample.y == expected.y && sample.pressed == expected.pressed;
+            ordered = ordered && (int64_t)sample.timestamp > previous;
+            previous = sample.timestamp;
+            received++;
+        }
+
+        if (done)
+            break;
+    }
+
+    pthread_join(producer, NULL);
+
+    TEST_ASSERT_TRUE(ordered);
+    TEST_ASSERT_TRUE(intact);
+    TEST_ASSERT_EQUAL_UINT32(STRESS_SAMPLES, received + touch_ring_overflow_count(&ring));
+}
+
+void test_touch_ring_with_null(void)
+{
+    TouchSample sample = make_sample(0);
+    touch_ring_init(NULL);
+    TEST_ASSERT_FALSE(touch_ring_push(NULL, &sample));
+    TEST_ASSERT_FALSE(touch_ring_push(&ring, NULL));
+    TEST_ASSERT_FALSE(touch_ring_pop(NULL, &sample));
+    TEST_ASSERT_EQUAL_UINT(0, touch_ring_count(NULL));
+    TEST_ASSERT_EQUAL_UINT(0, touch_ring_overflow_count(NULL));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_touch_ring_empty);
+    RUN_TEST(test_touch_ring_fifo_order);
+    RUN_TEST(test_touch_ring_counts_overflow);
+    RUN_TEST(test_touch_ring_index_wraparound);
+    RUN_TEST(test_touch_ring_concurrent_producer);
+    RUN_TEST(test_touch_ring_with_null);
+
+    return UNITY_END();
+}
@@ -32,7 +32,7 @@ void test_button_creation(void)
     TEST_ASSERT_EQUAL_INT(50, button->height);
     TEST_ASSERT_TRUE(button->visible);
     TEST_ASSERT_TRUE(button->enabled);
-    TEST_ASSERT_NOT_NULL(button->data);
+    TEST_ASSERT_NOT_NULL(widget_data(button));
 }
 
 void test_button_creation_with_null_text(void)
@@ -85,13 +85,13 @@ void test_button_set_padding(void)
 {
     button_set_padding(button, 16);
 
-    ButtonData *data = (ButtonData *)button->data;
+    ButtonData *data = (ButtonData *)widget_data(button);
     TEST_ASSERT_EQUAL_INT(16, data->padding);
 }
 
 void test_button_default_padding(void)
 {
-    ButtonData *data = (ButtonData *)button->data;
+    ButtonData *data = (ButtonData *)widget_data(button);
     TEST_ASSERT_EQUAL_INT(8, data->padding);
 }
 
@@ -99,13 +99,13 @@ void test_button_set_background_color(void)
 {
     button_set_background_color(button, COLOR_WHITE);
 
-    ButtonData *data = (ButtonData *)button->data;
+    ButtonData *data = (ButtonData *)widget_data(button);
     TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_WHITE, data->background_color));
 }
 
 void test_button_default_background_color(void)
 {
-    ButtonData *data = (ButtonData *)button->data;
+    ButtonData *data = (ButtonData *)widget_data(button);
     TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_GRAY_75, data->background_color));
 }
 
@@ -113,13 +113,13 @@ void test_button_set_text_color(void)
 {
     button_set_text_color(button, COLOR_WHITE);
 
-    ButtonData *data = (ButtonData *)button->data;
+    ButtonData *data = (ButtonData *)widget_data(button);
     TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_WHITE, data->text_color));
 }
 
 void test_button_default_text_color(void)
 {
-    ButtonData *data = (ButtonData *)button->data;
+    ButtonData *data = (ButtonData *)widget_data(button);
     TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_BLACK, data->text_color));
 }
 
@@ -127,14 +127,14 @@ void test_button_set_border(void)
 {
     button_set_border(button, COLOR_GRAY_50, 3);
 
-    ButtonData *data = (ButtonData *)button->data;
+    ButtonData *data = (ButtonData *)widget_data(button);
     TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_GRAY_50, data->border_color));
     TEST_ASSERT_EQUAL_INT(3, data->border_thickness);
 }
 
 void test_button_default_border(void)
 {
-    ButtonData *data = (ButtonData *)button->data;
+    ButtonData *data = (ButtonData *)widget_data(button);
     TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_BLACK, data->border_color));
     TEST_ASSERT_EQUAL_INT(1, data->border_thickness);
 }
@@ -143,7 +143,7 @@ void test_button_set_border_no_border(void)
 {
     button_set_border(button, COLOR_BLACK, 0);
 
-    ButtonData *data = (ButtonData *)button->data;
+    ButtonData *data = (ButtonData *)widget_data(button);
     TEST_ASSERT_EQUAL_INT(0, data->border_thickness);
 }
 
@@ -153,13 +153,13 @@ void test_button_set_font(void)
 
     button_set_font(button, mock_font);
 
-    ButtonData *data = (ButtonData *)button->data;
+    ButtonData *data = (ButtonData *)widget_data(button);
     TEST_ASSERT_EQUAL_PTR(mock_font, data->font);
 }
 
 void test_button_default_font(void)
 {
-    ButtonData *data = (ButtonData *)button->data;
+    ButtonData *data = (ButtonData *)widget_data(button);
     TEST_ASSERT_NULL(data->font);
 }
 
@@ -220,12 +220,12 @@ void test_button_set_padding_with_null_button(void)
 
 void test_button_has_render_callback(void)
 {
-    TEST_ASSERT_NOT_NULL(button->render);
+    TEST_ASSERT_NOT_NULL(button->vtable->render);
 }
 
 void test_button_has_destroy_callback(void)
 {
-    TEST_ASSERT_NOT_NULL(button->destroy);
+    TEST_ASSERT_NOT_NULL(button->vtable->destroy);
 }
 
 int main(void)
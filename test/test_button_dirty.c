@@ -35,13 +35,13 @@ void test_button_set_text_marks_dirty(void)
     TEST_ASSERT_TRUE(button->dirty);
 }
 
-void test_button_set_text_same_text_marks_dirty(void)
+void test_button_set_text_same_text_is_noop(void)
 {
     button->dirty = false;
 
     button_set_text(button, "Test");
 
-    TEST_ASSERT_TRUE(button->dirty);
+    TEST_ASSERT_FALSE(button->dirty);
 }
 
 void test_button_set_text_null_marks_dirty(void)
@@ -64,7 +64,7 @@ void test_button_set_padding_marks_dirty(void)
 
 void test_button_set_padding_same_value_does_not_mark_dirty(void)
 {
-    ButtonData *data = (ButtonData *)button->data;
+    ButtonData *data = (ButtonData *)widget_data(button);
     int current_padding = data->padding;
 
     button->dirty = false;
@@ -202,7 +202,7 @@ int main(void)
 
     RUN_TEST(test_button_dirty_on_creation);
     RUN_TEST(test_button_set_text_marks_dirty);
-    RUN_TEST(test_button_set_text_same_text_marks_dirty);
+    RUN_TEST(test_button_set_text_same_text_is_noop);
     RUN_TEST(test_button_set_text_null_marks_dirty);
     RUN_TEST(test_button_set_padding_marks_dirty);
     RUN_TEST(test_button_set_padding_same_value_does_not_mark_dirty);
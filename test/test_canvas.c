@@ -4,6 +4,7 @@
 #include "widgets/canvas.h"
 #include "widgets/widget.h"
 #include <stdlib.h>
+#include <string.h>
 
 static Widget *canvas;
 
@@ -32,18 +33,18 @@ void test_canvas_creation(void)
     TEST_ASSERT_EQUAL_INT(80, canvas->height);
     TEST_ASSERT_TRUE(canvas->visible);
     TEST_ASSERT_TRUE(canvas->enabled);
-    TEST_ASSERT_NOT_NULL(canvas->data);
+    TEST_ASSERT_NOT_NULL(widget_data(canvas));
 }
 
 void test_canvas_has_pixels(void)
 {
-    CanvasData *data = (CanvasData *)canvas->data;
+    CanvasData *data = (CanvasData *)widget_data(canvas);
     TEST_ASSERT_NOT_NULL(data->pixels);
 }
 
 void test_canvas_pixels_initialized_to_zero(void)
 {
-    CanvasData *data = (CanvasData *)canvas->data;
+    CanvasData *data = (CanvasData *)widget_data(canvas);
     int pixel_count = canvas->width * canvas->height;
 
     for (int i = 0; i < pixel_count; i++)
@@ -54,13 +55,13 @@ void test_canvas_pixels_initialized_to_zero(void)
 
 void test_canvas_default_brush_size(void)
 {
-    CanvasData *data = (CanvasData *)canvas->data;
+    CanvasData *data = (CanvasData *)widget_data(canvas);
     TEST_ASSERT_EQUAL_INT(3, data->brush_size);
 }
 
 void test_canvas_default_background_color(void)
 {
-    CanvasData *data = (CanvasData *)canvas->data;
+    CanvasData *data = (CanvasData *)widget_data(canvas);
     TEST_ASSERT_EQUAL_UINT8(COLOR_WHITE.a, data->background_color.a);
     TEST_ASSERT_EQUAL_UINT8(COLOR_WHITE.r, data->background_color.r);
     TEST_ASSERT_EQUAL_UINT8(COLOR_WHITE.g, data->background_color.g);
@@ -69,7 +70,7 @@ void test_canvas_default_background_color(void)
 
 void test_canvas_default_brush_color(void)
 {
-    CanvasData *data = (CanvasData *)canvas->data;
+    CanvasData *data = (CanvasData *)widget_data(canvas);
     TEST_ASSERT_EQUAL_UINT8(COLOR_BLACK.a, data->brush_color.a);
     TEST_ASSERT_EQUAL_UINT8(COLOR_BLACK.r, data->brush_color.r);
     TEST_ASSERT_EQUAL_UINT8(COLOR_BLACK.g, data->brush_color.g);
@@ -78,14 +79,14 @@ void test_canvas_default_brush_color(void)
 
 void test_canvas_default_border(void)
 {
-    CanvasData *data = (CanvasData *)canvas->data;
+    CanvasData *data = (CanvasData *)widget_data(canvas);
     TEST_ASSERT_EQUAL_UINT8(COLOR_BLACK.a, data->border_color.a);
     TEST_ASSERT_EQUAL_INT(2, data->border_thickness);
 }
 
 void test_canvas_no_dirty_rect_initially(void)
 {
-    CanvasData *data = (CanvasData *)canvas->data;
+    CanvasData *data = (CanvasData *)widget_data(canvas);
     TEST_ASSERT_EQUAL_INT(0, data->has_dirty_rect);
 }
 
@@ -93,7 +94,7 @@ void test_canvas_set_brush_size(void)
 {
     canvas_set_brush_size(canvas, 5);
 
-    CanvasData *data = (CanvasData *)canvas->data;
+    CanvasData *data = (CanvasData *)widget_data(canvas);
     TEST_ASSERT_EQUAL_INT(5, data->brush_size);
 }
 
@@ -101,7 +102,7 @@ void test_canvas_set_brush_size_zero_sets_to_one(void)
 {
     canvas_set_brush_size(canvas, 0);
 
-    CanvasData *data = (CanvasData *)canvas->data;
+    CanvasData *data = (CanvasData *)widget_data(canvas);
     TEST_ASSERT_EQUAL_INT(1, data->brush_size);
 }
 
@@ -109,7 +110,7 @@ void test_canvas_set_brush_size_negative_sets_to_one(void)
 {
     canvas_set_brush_size(canvas, -5);
 
-    CanvasData *data = (CanvasData *)canvas->data;
+    CanvasData *data = (CanvasData *)widget_data(canvas);
     TEST_ASSERT_EQUAL_INT(1, data->brush_size);
 }
 
@@ -117,7 +118,7 @@ void test_canvas_set_brush_color(void)
 {
     canvas_set_brush_color(canvas, COLOR_RED);
 
-    CanvasData *data = (CanvasData *)canvas->data;
+    CanvasData *data = (CanvasData *)widget_data(canvas);
     TEST_ASSERT_EQUAL_UINT8(COLOR_RED.a, data->brush_color.a);
     TEST_ASSERT_EQUAL_UINT8(COLOR_RED.r, data->brush_color.r);
     TEST_ASSERT_EQUAL_UINT8(COLOR_RED.g, data->brush_color.g);
@@ -128,7 +129,7 @@ void test_canvas_set_background_color(void)
 {
     canvas_set_background_color(canvas, COLOR_BLUE);
 
-    CanvasData *data = (CanvasData *)canvas->data;
+    CanvasData *data = (CanvasData *)widget_data(canvas);
     TEST_ASSERT_EQUAL_UINT8(COLOR_BLUE.a, data->background_color.a);
     TEST_ASSERT_EQUAL_UINT8(COLOR_BLUE.r, data->background_color.r);
     TEST_ASSERT_EQUAL_UINT8(COLOR_BLUE.g, data->background_color.g);
@@ -139,7 +140,7 @@ void test_canvas_set_border(void)
 {
     canvas_set_border(canvas, COLOR_GREEN, 4);
 
-    CanvasData *data = (CanvasData *)canvas->data;
+    CanvasData *data = (CanvasData *)widget_data(canvas);
     TEST_ASSERT_EQUAL_UINT8(COLOR_GREEN.a, data->border_color.a);
     TEST_ASSERT_EQUAL_INT(4, data->border_thickness);
 }
@@ -155,7 +156,7 @@ void test_canvas_draw_at_center_marks_dirty(void)
 
 void test_canvas_draw_at_sets_pixels(void)
 {
-    CanvasData *data = (CanvasData *)canvas->data;
+    CanvasData *data = (CanvasData *)widget_data(canvas);
 
     canvas_draw_at(canvas, 60, 60);
 
@@ -168,7 +169,7 @@ void test_canvas_draw_at_sets_pixels(void)
 
 void test_canvas_draw_at_creates_dirty_rect(void)
 {
-    CanvasData *data = (CanvasData *)canvas->data;
+    CanvasData *data = (CanvasData *)widget_data(canvas);
 
     canvas_draw_at(canvas, 60, 60);
 
@@ -206,7 +207,7 @@ void test_canvas_clear_marks_dirty(void)
 
 void test_canvas_clear_resets_all_pixels(void)
 {
-    CanvasData *data = (CanvasData *)canvas->data;
+    CanvasData *data = (CanvasData *)widget_data(canvas);
 
     canvas_draw_at(canvas, 60, 60);
     canvas_draw_at(canvas, 70, 70);
@@ -222,7 +223,7 @@ void test_canvas_clear_resets_all_pixels(void)
 
 void test_canvas_clear_creates_full_dirty_rect(void)
 {
-    CanvasData *data = (CanvasData *)canvas->data;
+    CanvasData *data = (CanvasData *)widget_data(canvas);
 
     canvas_clear(canvas);
 
@@ -235,7 +236,7 @@ void test_canvas_clear_creates_full_dirty_rect(void)
 
 void test_canvas_multiple_draws_expand_dirty_rect(void)
 {
-    CanvasData *data = (CanvasData *)canvas->data;
+    CanvasData *data = (CanvasData *)widget_data(canvas);
 
     canvas_draw_at(canvas, 30, 30);
     int first_width = data->dirty_width;
@@ -266,17 +267,17 @@ void test_canvas_dirty_propagates_to_parent(void)
 
 void test_canvas_has_render_callback(void)
 {
-    TEST_ASSERT_NOT_NULL(canvas->render);
+    TEST_ASSERT_NOT_NULL(canvas->vtable->render);
 }
 
 void test_canvas_has_destroy_callback(void)
 {
-    TEST_ASSERT_NOT_NULL(canvas->destroy);
+    TEST_ASSERT_NOT_NULL(canvas->vtable->destroy);
 }
 
 void test_canvas_has_dirty_callback(void)
 {
-    TEST_ASSERT_NOT_NULL(canvas->on_dirty);
+    TEST_ASSERT_NOT_NULL(canvas->vtable->on_dirty);
 }
 
 void test_canvas_dirty_flag_on_creation(void)
@@ -314,6 +315,460 @@ void test_canvas_clear_with_null(void)
     canvas_clear(NULL);
 }
 
+void test_canvas_downsample_empty_is_zero(void)
+{
+    uint8_t output[CANVAS_DOWNSAMPLE_SIZE * CANVAS_DOWNSAMPLE_SIZE];
+    memset(output, 0xFF, sizeof(output));
+
+    canvas_get_downsample(canvas, output);
+
+    for (int i = 0; i < CANVAS_DOWNSAMPLE_SIZE * CANVAS_DOWNSAMPLE_SIZE; i++)
+    {
+        TEST_ASSERT_EQUAL_UINT8(0, output[i]);
+    }
+}
+
+void test_canvas_downsample_tracks_cell_coverage(void)
+{
+    Widget *small = canvas_create(0, 0, 56, 56);
+    uint8_t output[CANVAS_DOWNSAMPLE_SIZE * CANVAS_DOWNSAMPLE_SIZE];
+
+    canvas_draw_at(small, 1, 1);
+    canvas_get_downsample(small, output);
+
+    TEST_ASSERT_EQUAL_UINT8(255, output[0]);
+    TEST_ASSERT_EQUAL_UINT8(128, output[1]);
+    TEST_ASSERT_EQUAL_UINT8(128, output[CANVAS_DOWNSAMPLE_SIZE]);
+    TEST_ASSERT_EQUAL_UINT8(64, output[CANVAS_DOWNSAMPLE_SIZE + 1]);
+    TEST_ASSERT_EQUAL_UINT8(0, output[2]);
+
+    widget_destroy(small);
+    free(small);
+}
+
+void test_canvas_downsample_counts_each_pixel_once(void)
+{
+    CanvasData *data = (CanvasData *)widget_data(canvas);
+
+    canvas_draw_at(canvas, 60, 60);
+    canvas_draw_at(canvas, 60, 60);
+    canvas_draw_at(canvas, 61, 60);
+
+    unsigned int total = 0;
+    for (int i = 0; i < CANVAS_DOWNSAMPLE_SIZE * CANVAS_DOWNSAMPLE_SIZE; i++)
+    {
+        total += data->cell_ink[i];
+    }
+
+    TEST_ASSERT_EQUAL_INT(12, total);
+    TEST_ASSERT_EQUAL_INT(12, data->ink_count);
+}
+
+void test_canvas_clear_resets_downsample(void)
+{
+    uint8_t output[CANVAS_DOWNSAMPLE_SIZE * CANVAS_DOWNSAMPLE_SIZE];
+
+    canvas_draw_at(canvas, 60, 60);
+    canvas_clear(canvas);
+    canvas_get_downsample(canvas, output);
+
+    for (int i = 0; i < CANVAS_DOWNSAMPLE_SIZE * CANVAS_DOWNSAMPLE_SIZE; i++)
+    {
+        TEST_ASSERT_EQUAL_UINT8(0, output[i]);
+    }
+}
+
+void test_canvas_version_changes_only_with_content(void)
+{
+    unsigned int initial = canvas_get_version(canvas);
+
+    canvas_clear(canvas);
+    TEST_ASSERT_EQUAL_INT(initial, canvas_get_version(canvas));
+
+    canvas_draw_at(canvas, 60, 60);
+    unsigned int drawn = canvas_get_version(canvas);
+    TEST_ASSERT_TRUE(drawn != initial);
+
+    canvas_draw_at(canvas, 60, 60);
+    TEST_ASSERT_EQUAL_INT(drawn, canvas_get_version(canvas));
+
+    canvas_clear(canvas);
+    TEST_ASSERT_TRUE(canvas_get_version(canvas) != drawn);
+}
+
+void test_canvas_downsample_with_null(void)
+{
+    uint8_t output[CANVAS_DOWNSAMPLE_SIZE * CANVAS_DOWNSAMPLE_SIZE];
+
+    canvas_get_downsample(NULL, output);
+    canvas_get_downsample(canvas, NULL);
+    TEST_ASSERT_EQUAL_INT(0, canvas_get_version(NULL));
+}
+
+void test_canvas_ink_bounds_track_strokes(void)
+{
+    int x, y, width, height;
+
+    TEST_ASSERT_FALSE(canvas_get_ink_bounds(canvas, &x, &y, &width, &height));
+
+    canvas_draw_at(canvas, 30, 40);
+    canvas_draw_at(canvas, 60, 70);
+
+    TEST_ASSERT_TRUE(canvas_get_ink_bounds(canvas, &x, &y, &width, &height));
+    TEST_ASSERT_EQUAL_INT(19, x);
+    TEST_ASSERT_EQUAL_INT(19, y);
+    TEST_ASSERT_EQUAL_INT(33, width);
+    TEST_ASSERT_EQUAL_INT(33, height);
+
+    canvas_clear(canvas);
+    TEST_ASSERT_FALSE(canvas_get_ink_bounds(canvas, &x, &y, &width, &height));
+}
+
+void test_canvas_records_strokes_in_log(void)
+{
+    uint8_t buffer[32];
+    StrokeLog log;
+    stroke_log_init(&log, buffer, sizeof(buffer), canvas->width, canvas->height);
+    canvas_set_stroke_log(canvas, &log);
+
+    canvas_begin_stroke(canvas, 30, 40);
+    canvas_draw_at(canvas, 35, 42);
+    canvas_draw_at(canvas, 0, 0);
+    canvas_end_stroke(canvas);
+
+    StrokeLogReader reader;
+    stroke_log_reader_init(&reader, log.buffer, log.length);
+
+    StrokeOp op;
+    int x, y;
+    TEST_ASSERT_TRUE(stroke_log_read(&reader, &op, &x, &y));
+    TEST_ASSERT_EQUAL_INT(STROKE_OP_PEN_DOWN, op);
+    TEST_ASSERT_EQUAL_INT(20, x);
+    TEST_ASSERT_EQUAL_INT(20, y);
+    TEST_ASSERT_TRUE(stroke_log_read(&reader, &op, &x, &y));
+    TEST_ASSERT_EQUAL_INT(STROKE_OP_MOVE, op);
+    TEST_ASSERT_EQUAL_INT(25, x);
+    TEST_ASSERT_EQUAL_INT(22, y);
+    TEST_ASSERT_TRUE(stroke_log_read(&reader, &op, &x, &y));
+    TEST_ASSERT_EQUAL_INT(STROKE_OP_PEN_UP, op);
+    TEST_ASSERT_FALSE(stroke_log_read(&reader, &op, &x, &y));
+
+    canvas_clear(canvas);
+    TEST_ASSERT_EQUAL_INT(0, log.length);
+}
+
+void test_canvas_replay_stroke_log_same_size(void)
+{
+    uint8_t buffer[64];
+    StrokeLog log;
+    stroke_log_init(&log, buffer, sizeof(buffer), canvas->width, canvas->height);
+    canvas_set_stroke_log(canvas, &log);
+
+    canvas_begin_stroke(canvas, 30, 40);
+    canvas_draw_at(canvas, 50, 60);
+    canvas_end_stroke(canvas);
+
+    Widget *copy = canvas_create(0, 0, canvas->width, canvas->height);
+    canvas_replay_stroke_log(copy, &log);
+
+    CanvasData *data = (CanvasData *)widget_data(canvas);
+    CanvasData *copy_data = (CanvasData *)widget_data(copy);
+    TEST_ASSERT_EQUAL_MEMORY(data->pixels, copy_data->pixels, canvas->width * canvas->height);
+
+    widget_destroy(copy);
+    free(copy);
+}
+
+void test_canvas_replay_stroke_log_scales_to_canvas(void)
+{
+    uint8_t buffer[16];
+    StrokeLog log;
+    stroke_log_init(&log, buffer, sizeof(buffer), canvas->width, canvas->height);
+    canvas_set_stroke_log(canvas, &log);
+
+    canvas_begin_stroke(canvas, 60, 60);
+    canvas_end_stroke(canvas);
+
+    Widget *scaled = canvas_create(0, 0, canvas->width * 2, canvas->height * 2);
+    canvas_replay_stroke_log(scaled, &log);
+
+    CanvasData *data = (CanvasData *)widget_data(scaled);
+    TEST_ASSERT_EQUAL_UINT8(255, data->pixels[80 * scaled->width + 100]);
+    TEST_ASSERT_EQUAL_UINT8(0, data->pixels[40 * scaled->width + 50]);
+
+    widget_destroy(scaled);
+    free(scaled);
+}
+
+void test_canvas_undo_redo_restores_pixels(void)
+{
+    CanvasTileBlock blocks[16];
+    CanvasHistory history;
+    canvas_history_init(&history, blocks, 16);
+    TEST_ASSERT_TRUE(canvas_set_history(canvas, &history));
+
+    CanvasData *data = (CanvasData *)widget_data(canvas);
+    int pixel_count = canvas->width * canvas->height;
+    uint8_t *first = (uint8_t *)malloc(pixel_count);
+    uint8_t *second = (uint8_t *)malloc(pixel_count);
+
+    canvas_begin_stroke(canvas, 30, 40);
+    canvas_draw_at(canvas, 31, 40);
+    canvas_end_stroke(canvas);
+    memcpy(first, data->pixels, pixel_count);
+    unsigned int first_ink = data->ink_count;
+
+    canvas_begin_stroke(canvas, 32, 41);
+    canvas_draw_at(canvas, 80, 90);
+    canvas_end_stroke(canvas);
+    memcpy(second, data->pixels, pixel_count);
+
+    uint8_t downsample[CANVAS_DOWNSAMPLE_SIZE * CANVAS_DOWNSAMPLE_SIZE];
+    uint8_t expected[CANVAS_DOWNSAMPLE_SIZE * CANVAS_DOWNSAMPLE_SIZE];
+    canvas_get_downsample(canvas, expected);
+
+    unsigned int version = canvas_get_version(canvas);
+    TEST_ASSERT_TRUE(canvas_undo(canvas));
+    TEST_ASSERT_EQUAL_MEMORY(first, data->pixels, pixel_count);
+    TEST_ASSERT_EQUAL_UINT(first_ink, data->ink_count);
+    TEST_ASSERT_TRUE(version != canvas_get_version(canvas));
+
+    TEST_ASSERT_TRUE(canvas_undo(canvas));
+    TEST_ASSERT_EQUAL_UINT(0, data->ink_count);
+    TEST_ASSERT_FALSE(canvas_undo(canvas));
+
+    TEST_ASSERT_TRUE(canvas_redo(canvas));
+    TEST_ASSERT_EQUAL_MEMORY(first, data->pixels, pixel_count);
+    TEST_ASSERT_TRUE(canvas_redo(canvas));
+    TEST_ASSERT_EQUAL_MEMORY(second, data->pixels, pixel_count);
+    TEST_ASSERT_FALSE(canvas_redo(canvas));
+
+    canvas_get_downsample(canvas, downsample);
+    TEST_ASSERT_EQUAL_MEMORY(expected, downsample, sizeof(downsample));
+
+    free(first);
+    free(second);
+}
+
+void test_canvas_undo_marks_only_stroke_tiles_dirty(void)
+{
+    CanvasTileBlock blocks[16];
+    CanvasHistory history;
+    canvas_history_init(&history, blocks, 16);
+    canvas_set_history(canvas, &history);
+
+    canvas_begin_stroke(canvas, 10 + 40, 20 + 40);
+    canvas_end_stroke(canvas);
+
+    static Color pixels[200 * 200];
+    Framebuffer framebuffer = {.pixels = pixels, .width = 200, .height = 200};
+    widget_render(canvas, &framebuffer);
+
+    CanvasData *data = (CanvasData *)widget_data(canvas);
+    TEST_ASSERT_TRUE(canvas_undo(canvas));
+    TEST_ASSERT_TRUE(canvas->dirty);
+    TEST_ASSERT_EQUAL_INT(1, data->has_dirty_rect);
+    TEST_ASSERT_EQUAL_INT(32, data->dirty_x);
+    TEST_ASSERT_EQUAL_INT(32, data->dirty_y);
+    TEST_ASSERT_EQUAL_INT(CANVAS_TILE_SIZE, data->dirty_width);
+    TEST_ASSERT_EQUAL_INT(CANVAS_TILE_SIZE, data->dirty_height);
+}
+
+void test_canvas_undo_tightens_ink_bounds(void)
+{
+    CanvasTileBlock blocks[16];
+    CanvasHistory history;
+    canvas_history_init(&history, blocks, 16);
+    canvas_set_history(canvas, &history);
+
+    canvas_begin_stroke(canvas, 30, 40);
+    canvas_end_stroke(canvas);
+    canvas_begin_stroke(canvas, 90, 80);
+    canvas_end_stroke(canvas);
+    canvas_undo(canvas);
+
+    int x, y, width, height;
+    TEST_ASSERT_TRUE(canvas_get_ink_bounds(canvas, &x, &y, &width, &height));
+    TEST_ASSERT_EQUAL_INT(19, x);
+    TEST_ASSERT_EQUAL_INT(19, y);
+    TEST_ASSERT_EQUAL_INT(3, width);
+    TEST_ASSERT_EQUAL_INT(3, height);
+
+    canvas_undo(canvas);
+    TEST_ASSERT_FALSE(canvas_get_ink_bounds(canvas, &x, &y, &width, &height));
+
+    canvas_redo(canvas);
+    canvas_redo(canvas);
+    TEST_ASSERT_TRUE(canvas_get_ink_bounds(canvas, &x, &y, &width, &height));
+    TEST_ASSERT_EQUAL_INT(19, x);
+    TEST_ASSERT_EQUAL_INT(63, width);
+}
+
+void test_canvas_undo_truncates_stroke_log(void)
+{
+    uint8_t buffer[64];
+    StrokeLog log;
+    stroke_log_init(&log, buffer, sizeof(buffer), canvas->width, canvas->height);
+    canvas_set_stroke_log(canvas, &log);
+
+    CanvasTileBlock blocks[16];
+    CanvasHistory history;
+    canvas_history_init(&history, blocks, 16);
+    canvas_set_history(canvas, &history);
+
+    canvas_begin_stroke(canvas, 30, 40);
+    canvas_end_stroke(canvas);
+    int first_length = log.length;
+
+    canvas_begin_stroke(canvas, 60, 70);
+    canvas_draw_at(canvas, 65, 70);
+    canvas_end_stroke(canvas);
+    int second_length = log.length;
+
+    canvas_undo(canvas);
+    TEST_ASSERT_EQUAL_INT(first_length, log.length);
+
+    canvas_redo(canvas);
+    TEST_ASSERT_EQUAL_INT(second_length, log.length);
+
+    canvas_undo(canvas);
+    canvas_begin_stroke(canvas, 90, 90);
+    canvas_end_stroke(canvas);
+
+    Widget *copy = canvas_create(0, 0, canvas->width, canvas->height);
+    canvas_replay_stroke_log(copy, &log);
+    TEST_ASSERT_EQUAL_MEMORY(((CanvasData *)widget_data(canvas))->pixels, ((CanvasData *)widget_data(copy))->pixels,
+                             canvas->width * canvas->height);
+
+    widget_destroy(copy);
+    free(copy);
+}
+
+void test_canvas_clear_resets_history(void)
+{
+    CanvasTileBlock blocks[16];
+    CanvasHistory history;
+    canvas_history_init(&history, blocks, 16);
+    canvas_set_history(canvas, &history);
+
+    canvas_begin_stroke(canvas, 30, 40);
+    canvas_end_stroke(canvas);
+    canvas_clear(canvas);
+
+    TEST_ASSERT_FALSE(canvas_undo(canvas));
+}
+
+void test_canvas_undo_without_history(void)
+{
+    canvas_draw_at(canvas, 30, 40);
+    TEST_ASSERT_FALSE(canvas_undo(canvas));
+    TEST_ASSERT_FALSE(canvas_redo(canvas));
+    TEST_ASSERT_FALSE(canvas_undo(NULL));
+    TEST_ASSERT_FALSE(canvas_set_history(NULL, NULL));
+}
+
+void test_canvas_partial_render_after_stroke(void)
+{
+    static Color pixels[200 * 200];
+    Framebuffer framebuffer = {.pixels = pixels, .width = 200, .height = 200};
+    widget_render(canvas, &framebuffer);
+
+    Color marker = COLOR_RED;
+    FRAMEBUFFER_SET_PIXEL(&framebuffer, 60, 60, marker);
+
+    canvas_draw_at(canvas, 30, 40);
+    widget_render(canvas, &framebuffer);
+
+    Color black = COLOR_BLACK;
+    Color white = COLOR_WHITE;
+    TEST_ASSERT_TRUE(COLOR_COMPARE(black, pixels[40 * 200 + 30]));
+    TEST_ASSERT_TRUE(COLOR_COMPARE(marker, pixels[60 * 200 + 60]));
+
+    widget_set_position(canvas, 12, 20);
+    widget_render(canvas, &framebuffer);
+    TEST_ASSERT_TRUE(COLOR_COMPARE(white, pixels[60 * 200 + 60]));
+}
+
+void test_canvas_stroke_joins_distant_points(void)
+{
+    canvas_set_brush_size(canvas, 1);
+    canvas_begin_stroke(canvas, 10 + 10, 20 + 10);
+    canvas_draw_at(canvas, 10 + 50, 20 + 10);
+    canvas_end_stroke(canvas);
+
+    CanvasData *data = (CanvasData *)widget_data(canvas);
+    for (int x = 10; x <= 50; x++)
+    {
+        TEST_ASSERT_EQUAL_UINT8(255, data->pixels[10 * canvas->width + x]);
+    }
+    TEST_ASSERT_EQUAL_UINT(41, data->ink_count);
+
+    canvas_draw_at(canvas, 10 + 70, 20 + 10);
+    TEST_ASSERT_EQUAL_UINT8(0, data->pixels[10 * canvas->width + 60]);
+}
+
+void test_canvas_draw_line_diagonal(void)
+{
+    canvas_set_brush_size(canvas, 1);
+    canvas_draw_line(canvas, 10, 20, 10 + 30, 20 + 30);
+
+    CanvasData *data = (CanvasData *)widget_data(canvas);
+    for (int i = 0; i <= 30; i++)
+    {
+        TEST_ASSERT_EQUAL_UINT8(255, data->pixels[i * canvas->width + i]);
+    }
+    TEST_ASSERT_EQUAL_UINT(31, data->ink_count);
+    TEST_ASSERT_TRUE(canvas->dirty);
+}
+
+void test_canvas_draw_line_clips_to_canvas(void)
+{
+    canvas_set_brush_size(canvas, 1);
+    canvas_draw_line(canvas, 0, 20 + 5, 10 + 20, 20 + 5);
+
+    CanvasData *data = (CanvasData *)widget_data(canvas);
+    TEST_ASSERT_EQUAL_UINT(21, data->ink_count);
+    TEST_ASSERT_EQUAL_UINT8(255, data->pixels[5 * canvas->width]);
+
+    canvas_draw_line(NULL, 0, 0, 1, 1);
+}
+
+void test_canvas_stroke_leaving_and_reentering_does_not_join(void)
+{
+    uint8_t buffer[64];
+    StrokeLog log;
+    stroke_log_init(&log, buffer, sizeof(buffer), canvas->width, canvas->height);
+    canvas_set_stroke_log(canvas, &log);
+    canvas_set_brush_size(canvas, 1);
+
+    canvas_begin_stroke(canvas, 10 + 10, 20 + 10);
+    canvas_draw_at(canvas, 10 + 50, 20 + 10);
+    canvas_draw_at(canvas, 0, 0);
+    canvas_draw_at(canvas, 10 + 50, 20 + 50);
+    canvas_draw_at(canvas, 10 + 10, 20 + 50);
+    canvas_end_stroke(canvas);
+
+    CanvasData *data = (CanvasData *)widget_data(canvas);
+    for (int y = 11; y < 50; y++)
+    {
+        TEST_ASSERT_EQUAL_UINT8(0, data->pixels[y * canvas->width + 50]);
+    }
+    for (int x = 10; x <= 50; x++)
+    {
+        TEST_ASSERT_EQUAL_UINT8(255, data->pixels[50 * canvas->width + x]);
+    }
+
+    // The log lifts the pen at the exit too, so a replay leaves the same gap
+    Widget *copy = canvas_create(0, 0, canvas->width, canvas->height);
+    canvas_set_brush_size(copy, 1);
+    canvas_replay_stroke_log(copy, &log);
+    CanvasData *copy_data = (CanvasData *)widget_data(copy);
+    TEST_ASSERT_EQUAL_MEMORY(data->pixels, copy_data->pixels, canvas->width * canvas->height);
+
+    widget_destroy(copy);
+    free(copy);
+}
+
 int main(void)
 {
     UNITY_BEGIN();
@@ -352,6 +807,27 @@ int main(void)
     RUN_TEST(test_canvas_set_border_with_null);
     RUN_TEST(test_canvas_draw_at_with_null);
     RUN_TEST(test_canvas_clear_with_null);
+    RUN_TEST(test_canvas_downsample_empty_is_zero);
+    RUN_TEST(test_canvas_downsample_tracks_cell_coverage);
+    RUN_TEST(test_canvas_downsample_counts_each_pixel_once);
+    RUN_TEST(test_canvas_clear_resets_downsample);
+    RUN_TEST(test_canvas_version_changes_only_with_content);
+    RUN_TEST(test_canvas_downsample_with_null);
+    RUN_TEST(test_canvas_ink_bounds_track_strokes);
+    RUN_TEST(test_canvas_records_strokes_in_log);
+    RUN_TEST(test_canvas_replay_stroke_log_same_size);
+    RUN_TEST(test_canvas_replay_stroke_log_scales_to_canvas);
+    RUN_TEST(test_canvas_undo_redo_restores_pixels);
+    RUN_TEST(test_canvas_undo_marks_only_stroke_tiles_dirty);
+    RUN_TEST(test_canvas_undo_tightens_ink_bounds);
+    RUN_TEST(test_canvas_undo_truncates_stroke_log);
+    RUN_TEST(test_canvas_clear_resets_history);
+    RUN_TEST(test_canvas_undo_without_history);
+    RUN_TEST(test_canvas_partial_render_after_stroke);
+    RUN_TEST(test_canvas_stroke_joins_distant_points);
+    RUN_TEST(test_canvas_draw_line_diagonal);
+    RUN_TEST(test_canvas_draw_line_clips_to_canvas);
+    RUN_TEST(test_canvas_stroke_leaving_and_reentering_does_not_join);
 
     return UNITY_END();
 }
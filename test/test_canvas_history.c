@@ -0,0 +1,168 @@
+#include "canvas_history.h"
+#include "unity.h"
+#include <stddef.h>
+
+#define BLOCK_COUNT 4
+
+static CanvasTileBlock blocks[BLOCK_COUNT];
+static CanvasHistory history;
+
+void setUp(void)
+{
+    canvas_history_init(&history, blocks, BLOCK_COUNT);
+}
+
+void tearDown(void)
+{
+}
+
+static void record_stroke(int first_tile, int tile_count)
+{
+    canvas_history_begin_stroke(&history, 0, 0, 0);
+    for (int i = 0; i < tile_count; i++)
+    {
+        canvas_history_save_tile(&history, first_tile + i);
+    }
+    canvas_history_end_stroke(&history, 0, 0, 0);
+}
+
+void test_canvas_history_empty(void)
+{
+    TEST_ASSERT_FALSE(canvas_history_can_undo(&history));
+    TEST_ASSERT_FALSE(canvas_history_can_redo(&history));
+    TEST_ASSERT_NULL(canvas_history_undo(&history));
+    TEST_ASSERT_NULL(canvas_history_redo(&history));
+}
+
+void test_canvas_history_saves_each_tile_once_per_stroke(void)
+{
+    canvas_history_begin_stroke(&history, 0, 0, 0);
+    TEST_ASSERT_NOT_NULL(canvas_history_save_tile(&history, 7));
+    TEST_ASSERT_NULL(canvas_history_save_tile(&history, 7));
+    TEST_ASSERT_NOT_NULL(canvas_history_save_tile(&history, 8));
+    canvas_history_end_stroke(&history, 0, 0, 0);
+
+    CanvasHistoryEntry *entry = canvas_history_undo(&history);
+    TEST_ASSERT_NOT_NULL(entry);
+    TEST_ASSERT_EQUAL_INT(2, entry->block_count);
+    TEST_ASSERT_EQUAL_UINT16(7, canvas_history_block(&history, entry, 0)->tile);
+    TEST_ASSERT_EQUAL_UINT16(8, canvas_history_block(&history, entry, 1)->tile);
+}
+
+void test_canvas_history_ignores_saves_outside_stroke(void)
+{
+    TEST_ASSERT_NULL(canvas_history_save_tile(&history, 1));
+}
+
+void test_canvas_history_empty_stroke_is_not_recorded(void)
+{
+    canvas_history_begin_stroke(&history, 0, 0, 0);
+    canvas_history_end_stroke(&history, 0, 0, 0);
+
+    TEST_ASSERT_FALSE(canvas_history_can_undo(&history));
+}
+
+void test_canvas_history_undo_then_redo(void)
+{
+    record_stroke(0, 1);
+    record_stroke(1, 1);
+
+    TEST_ASSERT_EQUAL_UINT16(1, canvas_history_block(&history, canvas_history_undo(&history), 0)->tile);
+    TEST_ASSERT_EQUAL_UINT16(0, canvas_history_block(&history, canvas_history_undo(&history), 0)->tile);
+    TEST_ASSERT_FALSE(canvas_history_can_undo(&history));
+
+    TEST_ASSERT_EQUAL_UINT16(0, canvas_history_block(&history, canvas_history_redo(&history), 0)->tile);
+    TEST_ASSERT_TRUE(canvas_history_can_redo(&history));
+}
+
+void test_canvas_history_new_stroke_discards_redo(void)
+{
+    record_stroke(0, 2);
+    record_stroke(2, 2);
+    canvas_history_undo(&history);
+
+    record_stroke(5, 2);
+
+    TEST_ASSERT_FALSE(canvas_history_can_redo(&history));
+    TEST_ASSERT_EQUAL_INT(4, history.block_used);
+    TEST_ASSERT_EQUAL_UINT16(5, canvas_history_block(&history, canvas_history_undo(&history), 0)->tile);
+    TEST_ASSERT_EQUAL_UINT16(0, canvas_history_block(&history, canvas_history_undo(&history), 0)->tile);
+}
+
+void test_canvas_history_evicts_oldest_when_full(void)
+{
+    record_stroke(0, 2);
+    record_stroke(2, 2);
+    record_stroke(4, 1);
+
+    TEST_ASSERT_EQUAL_INT(2, history.entry_count);
+    TEST_ASSERT_EQUAL_UINT16(4, canvas_history_block(&history, canvas_history_undo(&history), 0)->tile);
+
+    CanvasHistoryEntry *entry = canvas_history_undo(&history);
+    TEST_ASSERT_EQUAL_UINT16(2, canvas_history_block(&history, entry, 0)->tile);
+    TEST_ASSERT_EQUAL_UINT16(3, canvas_history_block(&history, entry, 1)->tile);
+    TEST_ASSERT_FALSE(canvas_history_can_undo(&history));
+}
+
+void test_canvas_history_stroke_larger_than_ring_clears_history(void)
+{
+    record_stroke(0, 1);
+    record_stroke(1, BLOCK_COUNT + 1);
+
+    TEST_ASSERT_FALSE(canvas_history_can_undo(&history));
+    TEST_ASSERT_FALSE(canvas_history_can_redo(&history));
+
+    record_stroke(9, 1);
+    TEST_ASSERT_TRUE(canvas_history_can_undo(&history));
+}
+
+void test_canvas_history_limits_stroke_count(void)
+{
+    CanvasTileBlock many_blocks[CANVAS_HISTORY_MAX_STROKES + 8];
+    canvas_history_init(&history, many_blocks, CANVAS_HISTORY_MAX_STROKES + 8);
+
+    for (int i = 0; i < CANVAS_HISTORY_MAX_STROKES + 3; i++)
+    {
+        record_stroke(i, 1);
+    }
+
+    int undone = 0;
+    CanvasHistoryEntry *entry = NULL;
+    while (canvas_history_can_undo(&history))
+    {
+        entry = canvas_history_undo(&history);
+        undone++;
+    }
+
+    TEST_ASSERT_EQUAL_INT(CANVAS_HISTORY_MAX_STROKES, undone);
+    TEST_ASSERT_EQUAL_UINT16(3, canvas_history_block(&history, entry, 0)->tile);
+}
+
+void test_canvas_history_with_null(void)
+{
+    canvas_history_init(NULL, blocks, BLOCK_COUNT);
+    canvas_history_begin_stroke(NULL, 0, 0, 0);
+    canvas_history_end_stroke(NULL, 0, 0, 0);
+    TEST_ASSERT_NULL(canvas_history_save_tile(NULL, 0));
+    TEST_ASSERT_NULL(canvas_history_undo(NULL));
+    TEST_ASSERT_NULL(canvas_history_redo(NULL));
+    TEST_ASSERT_FALSE(canvas_history_can_undo(NULL));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_canvas_history_empty);
+    RUN_TEST(test_canvas_history_saves_each_tile_once_per_stroke);
+    RUN_TEST(test_canvas_history_ignores_saves_outside_stroke);
+    RUN_TEST(test_canvas_history_empty_stroke_is_not_recorded);
+    RUN_TEST(test_canvas_history_undo_then_redo);
+    RUN_TEST(test_canvas_history_new_stroke_discards_redo);
+    RUN_TEST(test_canvas_history_evicts_oldest_when_full);
+    RUN_TEST(test_canvas_history_stroke_larger_than_ring_clears_history);
+    RUN_TEST(test_canvas_history_limits_stroke_count);
+    RUN_TEST(test_canvas_history_with_null);
+
+    return UNITY_END();
+}
@@ -1,3 +1,4 @@
+#include "gui_arena.h"
 #include "unity.h"
 #include "widgets/button.h"
 #include "widgets/container.h"
@@ -32,7 +33,7 @@ void test_container_creation(void)
     TEST_ASSERT_EQUAL_INT(150, container->height);
     TEST_ASSERT_TRUE(container->visible);
     TEST_ASSERT_TRUE(container->enabled);
-    TEST_ASSERT_NOT_NULL(container->data);
+    TEST_ASSERT_NOT_NULL(widget_data(container));
 }
 
 void test_container_initial_child_count(void)
@@ -42,37 +43,37 @@ void test_container_initial_child_count(void)
 
 void test_container_default_layout_type(void)
 {
-    ContainerData *data = (ContainerData *)container->data;
+    ContainerData *data = (ContainerData *)widget_data(container);
     TEST_ASSERT_EQUAL_INT(LAYOUT_TYPE_VBOX, data->layout_type);
 }
 
 void test_container_default_spacing(void)
 {
-    ContainerData *data = (ContainerData *)container->data;
+    ContainerData *data = (ContainerData *)widget_data(container);
     TEST_ASSERT_EQUAL_INT(0, data->spacing);
 }
 
 void test_container_default_padding(void)
 {
-    ContainerData *data = (ContainerData *)container->data;
+    ContainerData *data = (ContainerData *)widget_data(container);
     TEST_ASSERT_EQUAL_INT(0, data->padding);
 }
 
 void test_container_default_alignment(void)
 {
-    ContainerData *data = (ContainerData *)container->data;
+    ContainerData *data = (ContainerData *)widget_data(container);
     TEST_ASSERT_EQUAL_INT(ALIGN_START, data->alignment);
 }
 
 void test_container_default_justify(void)
 {
-    ContainerData *data = (ContainerData *)container->data;
+    ContainerData *data = (ContainerData *)widget_data(container);
     TEST_ASSERT_EQUAL_INT(ALIGN_START, data->justify);
 }
 
 void test_container_default_grid_columns(void)
 {
-    ContainerData *data = (ContainerData *)container->data;
+    ContainerData *data = (ContainerData *)widget_data(container);
     TEST_ASSERT_EQUAL_INT(2, data->grid_columns);
 }
 
@@ -185,7 +186,7 @@ void test_container_set_spacing(void)
 {
     container_set_spacing(container, 10);
 
-    ContainerData *data = (ContainerData *)container->data;
+    ContainerData *data = (ContainerData *)widget_data(container);
     TEST_ASSERT_EQUAL_INT(10, data->spacing);
 }
 
@@ -198,7 +199,7 @@ void test_container_set_padding(void)
 {
     container_set_padding(container, 15);
 
-    ContainerData *data = (ContainerData *)container->data;
+    ContainerData *data = (ContainerData *)widget_data(container);
     TEST_ASSERT_EQUAL_INT(15, data->padding);
 }
 
@@ -211,7 +212,7 @@ void test_container_set_alignment(void)
 {
     container_set_alignment(container, ALIGN_CENTER);
 
-    ContainerData *data = (ContainerData *)container->data;
+    ContainerData *data = (ContainerData *)widget_data(container);
     TEST_ASSERT_EQUAL_INT(ALIGN_CENTER, data->alignment);
 }
 
@@ -224,7 +225,7 @@ void test_container_set_justify(void)
 {
     container_set_justify(container, ALIGN_END);
 
-    ContainerData *data = (ContainerData *)container->data;
+    ContainerData *data = (ContainerData *)widget_data(container);
     TEST_ASSERT_EQUAL_INT(ALIGN_END, data->justify);
 }
 
@@ -237,7 +238,7 @@ void test_container_set_grid_columns(void)
 {
     container_set_grid_columns(container, 3);
 
-    ContainerData *data = (ContainerData *)container->data;
+    ContainerData *data = (ContainerData *)widget_data(container);
     TEST_ASSERT_EQUAL_INT(3, data->grid_columns);
 }
 
@@ -245,7 +246,7 @@ void test_container_set_grid_columns_zero_sets_to_one(void)
 {
     container_set_grid_columns(container, 0);
 
-    ContainerData *data = (ContainerData *)container->data;
+    ContainerData *data = (ContainerData *)widget_data(container);
     TEST_ASSERT_EQUAL_INT(1, data->grid_columns);
 }
 
@@ -253,7 +254,7 @@ void test_container_set_grid_columns_negative_sets_to_one(void)
 {
     container_set_grid_columns(container, -5);
 
-    ContainerData *data = (ContainerData *)container->data;
+    ContainerData *data = (ContainerData *)widget_data(container);
     TEST_ASSERT_EQUAL_INT(1, data->grid_columns);
 }
 
@@ -289,17 +290,17 @@ void test_container_get_child_with_valid_index(void)
 
 void test_container_has_render_callback(void)
 {
-    TEST_ASSERT_NOT_NULL(container->render);
+    TEST_ASSERT_NOT_NULL(container->vtable->render);
 }
 
 void test_container_has_destroy_callback(void)
 {
-    TEST_ASSERT_NOT_NULL(container->destroy);
+    TEST_ASSERT_NOT_NULL(container->vtable->destroy);
 }
 
 void test_container_has_dirty_callback(void)
 {
-    TEST_ASSERT_NOT_NULL(container->on_dirty);
+    TEST_ASSERT_NOT_NULL(container->vtable->on_dirty);
 }
 
 void test_container_dirty_flag_on_creation(void)
@@ -412,6 +413,539 @@ void test_container_vbox_with_padding(void)
     free(vbox);
 }
 
+static Widget *last_clicked;
+static int click_count;
+
+static void record_click(Widget *widget, void *user_data)
+{
+    (void)user_data;
+    last_clicked = widget;
+    click_count++;
+}
+
+static Widget *create_clickable(int x, int y, int width, int height)
+{
+    Widget *widget = (Widget *)malloc(sizeof(Widget));
+    widget_init(widget, WIDGET_TYPE_LABEL, x, y, width, height);
+    widget->on_click = record_click;
+    return widget;
+}
+
+void test_container_click_reaches_only_topmost_child(void)
+{
+    Widget *free_container = container_create(0, 0, 100, 100, LAYOUT_TYPE_NONE);
+    Widget *below = create_clickable(10, 10, 50, 50);
+    Widget *above = create_clickable(30, 30, 50, 50);
+    container_add_child(free_container, below);
+    container_add_child(free_container, above);
+    free_container->on_click = record_click;
+
+    last_clicked = NULL;
+    click_count = 0;
+    widget_handle_click(free_container, 40, 40);
+    TEST_ASSERT_EQUAL_PTR(above, last_clicked);
+    TEST_ASSERT_EQUAL_INT(1, click_count);
+
+    widget_handle_click(free_container, 15, 15);
+    TEST_ASSERT_EQUAL_PTR(below, last_clicked);
+
+    widget_handle_click(free_container, 90, 5);
+    TEST_ASSERT_EQUAL_PTR(free_container, last_clicked);
+    TEST_ASSERT_EQUAL_INT(3, click_count);
+
+    widget_destroy(free_container);
+    free(free_container);
+}
+
+void test_container_click_skips_disabled_child(void)
+{
+    Widget *free_container = container_create(0, 0, 100, 100, LAYOUT_TYPE_NONE);
+    Widget *below = create_clickable(10, 10, 50, 50);
+    Widget *above = create_clickable(10, 10, 50, 50);
+    container_add_child(free_container, below);
+    container_add_child(free_container, above);
+    widget_set_enabled(above, false);
+
+    last_clicked = NULL;
+    TEST_ASSERT_EQUAL_PTR(below, widget_hit_test(free_container, 20, 20));
+    widget_handle_click(free_container, 20, 20);
+    TEST_ASSERT_EQUAL_PTR(below, last_clicked);
+
+    widget_destroy(free_container);
+    free(free_container);
+}
+
+void test_container_hit_test_reaches_child_outside_parent(void)
+{
+    Widget *outer = container_create(0, 0, 200, 200, LAYOUT_TYPE_NONE);
+    Widget *inner = container_create(0, 0, 50, 50, LAYOUT_TYPE_NONE);
+    Widget *child = create_clickable(0, 0, 10, 10);
+    container_add_child(inner, child);
+    container_add_child(outer, inner);
+
+    TEST_ASSERT_NULL(widget_hit_test(outer, 120, 120));
+
+    widget_set_position(child, 115, 115);
+    TEST_ASSERT_EQUAL_PTR(child, widget_hit_test(outer, 120, 120));
+
+    int x, y, width, height;
+    container_get_bounds(inner, &x, &y, &width, &height);
+    TEST_ASSERT_EQUAL_INT(0, x);
+    TEST_ASSERT_EQUAL_INT(125, width);
+
+    widget_set_position(child, 0, 0);
+    TEST_ASSERT_NULL(widget_hit_test(outer, 120, 120));
+    TEST_ASSERT_EQUAL_PTR(child, widget_hit_test(outer, 5, 5));
+
+    widget_destroy(outer);
+    free(outer);
+}
+
+void test_container_bounds_follow_children(void)
+{
+    Widget *free_container = container_create(10, 10, 20, 20, LAYOUT_TYPE_NONE);
+
+    int x, y, width, height;
+    container_get_bounds(free_container, &x, &y, &width, &height);
+    TEST_ASSERT_EQUAL_INT(10, x);
+    TEST_ASSERT_EQUAL_INT(20, width);
+
+    container_add_child(free_container, create_clickable(-10, 5, 5, 40));
+    container_get_bounds(free_container, &x, &y, &width, &height);
+    TEST_ASSERT_EQUAL_INT(0, x);
+    TEST_ASSERT_EQUAL_INT(10, y);
+    TEST_ASSERT_EQUAL_INT(30, width);
+    TEST_ASSERT_EQUAL_INT(45, height);
+
+    container_clear_children(free_container);
+    container_get_bounds(free_container, &x, &y, &width, &height);
+    TEST_ASSERT_EQUAL_INT(10, x);
+    TEST_ASSERT_EQUAL_INT(20, height);
+
+    widget_destroy(free_container);
+    free(free_container);
+}
+
+void test_container_hit_test_in_layout(void)
+{
+    Widget *first = create_clickable(0, 0, 50, 30);
+    Widget *second = create_clickable(0, 0, 50, 30);
+    container_add_child(container, first);
+    container_add_child(container, second);
+
+    TEST_ASSERT_EQUAL_PTR(second, widget_hit_test(container, container->x + 1, container->y + second->y + 1));
+    TEST_ASSERT_EQUAL_PTR(first, widget_hit_test(container, container->x + 1, container->y + first->y + 1));
+    TEST_ASSERT_NULL(widget_hit_test(container, 0, 0));
+    TEST_ASSERT_NULL(widget_hit_test(NULL, 0, 0));
+}
+
+void test_container_paint_change_skips_layout(void)
+{
+    Widget *child = create_clickable(0, 0, 50, 30);
+    container_add_child(container, child);
+
+    Framebuffer framebuffer = {0};
+    widget_handle_dirty(container, &framebuffer);
+    container->dirty = false;
+    child->dirty = false;
+    TEST_ASSERT_FALSE(container->needs_layout);
+
+    child->x = 99;
+    widget_mark_dirty(child);
+    TEST_ASSERT_TRUE(container->dirty);
+    TEST_ASSERT_FALSE(container->needs_layout);
+
+    widget_handle_dirty(container, &framebuffer);
+    TEST_ASSERT_EQUAL_INT(99, child->x);
+}
+
+void test_container_child_resize_requests_layout(void)
+{
+    Widget *first = create_clickable(0, 0, 50, 30);
+    Widget *second = create_clickable(0, 0, 50, 30);
+    container_add_child(container, first);
+    container_add_child(container, second);
+    int second_y = second->y;
+
+    Framebuffer framebuffer = {0};
+    widget_handle_dirty(container, &framebuffer);
+    TEST_ASSERT_FALSE(container->needs_layout);
+
+    widget_set_size(first, 50, 60);
+    TEST_ASSERT_TRUE(container->needs_layout);
+    TEST_ASSERT_EQUAL_INT(second_y, second->y);
+
+    widget_handle_dirty(container, &framebuffer);
+    TEST_ASSERT_EQUAL_INT(second_y + 30, second->y);
+    TEST_ASSERT_FALSE(container->needs_layout);
+}
+
+void test_container_visibility_change_requests_layout(void)
+{
+    Widget *first = create_clickable(0, 0, 50, 30);
+    Widget *second = create_clickable(0, 0, 50, 30);
+    container_add_child(container, first);
+    container_add_child(container, second);
+    container_update_layout(container);
+
+    widget_set_visible(first, false);
+    TEST_ASSERT_TRUE(container->needs_layout);
+
+    Framebuffer framebuffer = {0};
+    widget_handle_dirty(container, &framebuffer);
+    TEST_ASSERT_EQUAL_INT(0, second->y);
+}
+
+void test_container_nested_layout_stays_local(void)
+{
+    Widget *inner = container_create(0, 0, 100, 60, LAYOUT_TYPE_VBOX);
+    container_add_child(container, inner);
+    Widget *child = create_clickable(0, 0, 50, 20);
+    container_add_child(inner, child);
+
+    Framebuffer framebuffer = {0};
+    widget_handle_dirty(container, &framebuffer);
+    TEST_ASSERT_FALSE(container->needs_layout);
+    TEST_ASSERT_FALSE(inner->needs_layout);
+
+    widget_set_size(child, 50, 25);
+    TEST_ASSERT_TRUE(inner->needs_layout);
+    TEST_ASSERT_FALSE(container->needs_layout);
+    TEST_ASSERT_TRUE(container->dirty);
+}
+
+void test_container_batched_update_defers_layout(void)
+{
+    Widget *first = create_clickable(0, 0, 50, 30);
+    Widget *second = create_clickable(0, 0, 50, 30);
+
+    container_begin_update(container);
+    container_add_child(container, first);
+    container_add_child(container, second);
+    container_set_padding(container, 5);
+    container_set_spacing(container, 10);
+
+    TEST_ASSERT_EQUAL_INT(0, second->y);
+    TEST_ASSERT_TRUE(container->needs_layout);
+
+    container_end_update(container);
+
+    TEST_ASSERT_FALSE(container->needs_layout);
+    TEST_ASSERT_EQUAL_INT(5, first->y);
+    TEST_ASSERT_EQUAL_INT(5 + 30 + 10, second->y);
+}
+
+void test_container_batched_update_nests(void)
+{
+    Widget *child = create_clickable(0, 0, 50, 30);
+
+    container_begin_update(container);
+    container_begin_update(container);
+    container_add_child(container, child);
+    container_end_update(container);
+    TEST_ASSERT_TRUE(container->needs_layout);
+
+    container_end_update(container);
+    TEST_ASSERT_FALSE(container->needs_layout);
+    TEST_ASSERT_EQUAL_INT(0, child->y);
+
+    container_end_update(container);
+    TEST_ASSERT_EQUAL_INT(0, ((ContainerData *)widget_data(container))->update_depth);
+}
+
+void test_container_batched_update_covers_descendants(void)
+{
+    Widget *inner = container_create(0, 0, 100, 60, LAYOUT_TYPE_HBOX);
+    container_add_child(container, inner);
+
+    container_begin_update(container);
+    Widget *left = create_clickable(0, 0, 20, 20);
+    Widget *right = create_clickable(0, 0, 20, 20);
+    container_add_child(inner, left);
+    container_add_child(inner, right);
+    container_set_spacing(inner, 4);
+    TEST_ASSERT_TRUE(inner->needs_layout);
+    TEST_ASSERT_EQUAL_INT(0, right->x);
+
+    container_end_update(container);
+    TEST_ASSERT_FALSE(inner->needs_layout);
+    TEST_ASSERT_EQUAL_INT(left->x + 20 + 4, right->x);
+}
+
+void test_container_update_with_null(void)
+{
+    container_begin_update(NULL);
+    container_end_update(NULL);
+}
+
+void test_container_flex_weights_share_free_space(void)
+{
+    Widget *hbox = container_create(0, 0, 300, 40, LAYOUT_TYPE_HBOX);
+    container_begin_update(hbox);
+    Widget *fixed = create_clickable(0, 0, 60, 40);
+    Widget *narrow = create_clickable(0, 0, 0, 0);
+    Widget *wide = create_clickable(0, 0, 0, 0);
+    widget_set_flex(wide, 3);
+    container_add_child(hbox, fixed);
+    container_add_child(hbox, narrow);
+    container_add_child(hbox, wide);
+    container_end_update(hbox);
+
+    TEST_ASSERT_EQUAL_INT(60, fixed->width);
+    TEST_ASSERT_EQUAL_INT(60, narrow->width);
+    TEST_ASSERT_EQUAL_INT(180, wide->width);
+    TEST_ASSERT_EQUAL_INT(120, wide->x);
+
+    widget_destroy(hbox);
+    free(hbox);
+}
+
+void test_container_flex_share_is_exact(void)
+{
+    Widget *hbox = container_create(0, 0, 100, 40, LAYOUT_TYPE_HBOX);
+    container_begin_update(hbox);
+    Widget *children[3];
+    for (int i = 0; i < 3; i++)
+    {
+        children[i] = create_clickable(0, 0, 0, 0);
+        container_add_child(hbox, children[i]);
+    }
+    container_end_update(hbox);
+
+    TEST_ASSERT_EQUAL_INT(100, children[0]->width + children[1]->width + children[2]->width);
+    TEST_ASSERT_EQUAL_INT(100, children[2]->x + children[2]->width);
+
+    widget_destroy(hbox);
+    free(hbox);
+}
+
+void test_container_max_clamps_and_redistributes(void)
+{
+    Widget *hbox = container_create(0, 0, 300, 40, LAYOUT_TYPE_HBOX);
+    container_begin_update(hbox);
+    Widget *capped = create_clickable(0, 0, 0, 0);
+    Widget *other = create_clickable(0, 0, 0, 0);
+    widget_set_size_limits(capped, 0, 0, 50, 0);
+    container_add_child(hbox, capped);
+    container_add_child(hbox, other);
+    container_end_update(hbox);
+
+    TEST_ASSERT_EQUAL_INT(50, capped->width);
+    TEST_ASSERT_EQUAL_INT(250, other->width);
+
+    widget_destroy(hbox);
+    free(hbox);
+}
+
+void test_container_min_holds_against_small_share(void)
+{
+    Widget *vbox = container_create(0, 0, 100, 100, LAYOUT_TYPE_VBOX);
+    container_begin_update(vbox);
+    Widget *header = create_clickable(0, 0, 100, 80);
+    Widget *body = create_clickable(0, 0, 0, 0);
+    widget_set_size_limits(body, 0, 30, 0, 0);
+    container_add_child(vbox, header);
+    container_add_child(vbox, body);
+    container_end_update(vbox);
+
+    TEST_ASSERT_EQUAL_INT(30, body->height);
+    TEST_ASSERT_EQUAL_INT(80, body->y);
+
+    widget_destroy(vbox);
+    free(vbox);
+}
+
+void test_container_repeated_layout_is_stable(void)
+{
+    Widget *hbox = container_create(0, 0, 200, 40, LAYOUT_TYPE_HBOX);
+    container_begin_update(hbox);
+    Widget *fill = create_clickable(0, 0, 0, 0);
+    Widget *fixed = create_clickable(0, 0, 50, 40);
+    container_add_child(hbox, fill);
+    container_add_child(hbox, fixed);
+    container_end_update(hbox);
+    TEST_ASSERT_EQUAL_INT(150, fill->width);
+
+    widget_set_size(hbox, 300, 40);
+    container_update_layout(hbox);
+    TEST_ASSERT_EQUAL_INT(250, fill->width);
+
+    widget_set_size(hbox, 200, 40);
+    container_update_layout(hbox);
+    container_update_layout(hbox);
+    TEST_ASSERT_EQUAL_INT(150, fill->width);
+    TEST_ASSERT_EQUAL_INT(0, fill->layout.preferred_width);
+
+    widget_destroy(hbox);
+    free(hbox);
+}
+
+void test_container_nested_layout_settles_in_one_pass(void)
+{
+    Widget *outer = container_create(0, 0, 200, 100, LAYOUT_TYPE_HBOX);
+    container_begin_update(outer);
+    Widget *inner = container_create(0, 0, 0, 0, LAYOUT_TYPE_VBOX);
+    Widget *leaf = create_clickable(0, 0, 0, 0);
+    container_add_child(inner, leaf);
+    container_add_child(outer, inner);
+    container_end_update(outer);
+
+    TEST_ASSERT_EQUAL_INT(200, inner->width);
+    TEST_ASSERT_EQUAL_INT(200, leaf->width);
+    TEST_ASSERT_EQUAL_INT(100, leaf->height);
+    TEST_ASSERT_FALSE(inner->needs_layout);
+
+    widget_set_size(outer, 120, 100);
+    container_update_layout(outer);
+    TEST_ASSERT_EQUAL_INT(120, leaf->width);
+    TEST_ASSERT_FALSE(inner->needs_layout);
+
+    widget_destroy(outer);
+    free(outer);
+}
+
+void test_container_measure_is_cached_until_content_changes(void)
+{
+    Widget *hbox = container_create(0, 0, 0, 0, LAYOUT_TYPE_HBOX);
+    container_begin_update(hbox);
+    container_set_spacing(hbox, 4);
+    container_set_padding(hbox, 2);
+    container_add_child(hbox, create_clickable(0, 0, 30, 10));
+    Widget *tall = create_clickable(0, 0, 20, 25);
+    container_add_child(hbox, tall);
+    container_end_update(hbox);
+
+    int width, height;
+    widget_measure(hbox, &width, &height);
+    TEST_ASSERT_EQUAL_INT(58, width);
+    TEST_ASSERT_EQUAL_INT(29, height);
+
+    ContainerData *data = (ContainerData *)widget_data(hbox);
+    TEST_ASSERT_TRUE(data->measure_valid);
+    container_update_layout(hbox);
+    TEST_ASSERT_TRUE(data->measure_valid);
+
+    widget_set_size(tall, 40, 25);
+    TEST_ASSERT_FALSE(data->measure_valid);
+    widget_measure(hbox, &width, &height);
+    TEST_ASSERT_EQUAL_INT(78, width);
+
+    widget_destroy(hbox);
+    free(hbox);
+}
+
+void test_container_move_keeps_children_relative(void)
+{
+    Widget *panel = container_create(10, 20, 100, 100, LAYOUT_TYPE_VBOX);
+    Widget *child = create_clickable(0, 0, 50, 30);
+    container_add_child(panel, child);
+    container_add_child(container, panel);
+    Framebuffer framebuffer = {0};
+    widget_handle_dirty(container, &framebuffer);
+
+    int x, y, width, height;
+    container_get_bounds(panel, &x, &y, &width, &height);
+    int child_x = child->x;
+    int child_y = child->y;
+    widget_set_position(panel, 60, 70);
+
+    TEST_ASSERT_FALSE(panel->needs_layout);
+    TEST_ASSERT_EQUAL_INT(child_x, child->x);
+    TEST_ASSERT_EQUAL_INT(child_y, child->y);
+    TEST_ASSERT_TRUE(((ContainerData *)widget_data(panel))->bounds_valid);
+
+    widget_get_screen_position(child, &x, &y);
+    TEST_ASSERT_EQUAL_INT(container->x + 60 + child->x, x);
+    TEST_ASSERT_EQUAL_INT(container->y + 70 + child->y, y);
+    TEST_ASSERT_EQUAL_PTR(child, widget_hit_test(container, x + 1, y + 1));
+}
+
+void test_container_render_resolves_screen_position(void)
+{
+    static Color pixels[200 * 200];
+    Framebuffer framebuffer = {.pixels = pixels, .width = 200, .height = 200};
+    framebuffer_clear(&framebuffer, COLOR_WHITE);
+
+    Widget *panel = container_create(10, 20, 100, 100, LAYOUT_TYPE_NONE);
+    Widget *button = button_create(5, 5, 10, 10, NULL);
+    button_set_background_color(button, COLOR_RED);
+    container_add_child(panel, button);
+
+    widget_handle_dirty(panel, &framebuffer);
+    widget_render(panel, &framebuffer);
+    TEST_ASSERT_EQUAL_UINT8(0x00, pixels[25 * 200 + 15].g);
+
+    widget_set_position(panel, 50, 20);
+    widget_handle_dirty(panel, &framebuffer);
+    framebuffer_clear_dirty_rects(&framebuffer, COLOR_WHITE);
+    widget_render(panel, &framebuffer);
+
+    TEST_ASSERT_EQUAL_UINT8(0xFF, pixels[25 * 200 + 15].g);
+    TEST_ASSERT_EQUAL_UINT8(0x00, pixels[25 * 200 + 55].g);
+    TEST_ASSERT_EQUAL_INT(0, framebuffer.origin_x);
+    TEST_ASSERT_EQUAL_INT(0, framebuffer.origin_y);
+
+    widget_destroy(panel);
+    free(panel);
+}
+
+void test_container_floating_animation_skips_layout(void)
+{
+    Widget *hbox = container_create(0, 0, 200, 100, LAYOUT_TYPE_HBOX);
+    container_set_alignment(hbox, ALIGN_CENTER);
+    Widget *child = create_clickable(0, 0, 20, 20);
+    container_add_child(hbox, child);
+    container_set_animation(hbox, ANIMATION_FLOATING);
+    Framebuffer framebuffer = {0};
+    widget_handle_dirty(hbox, &framebuffer);
+
+    int rest_y = child->y;
+    container_update_animation(hbox, 90000);
+
+    TEST_ASSERT_FALSE(hbox->needs_layout);
+    TEST_ASSERT_EQUAL_INT(rest_y + 10, child->y);
+
+    container_update_layout(hbox);
+    TEST_ASSERT_EQUAL_INT(rest_y + 10, child->y);
+
+    widget_destroy(hbox);
+    free(hbox);
+}
+
+void test_container_add_child_keeps_arrays_when_growing_fails(void)
+{
+    static uint8_t buffer[4096];
+    GuiArena arena;
+    gui_arena_init(&arena, buffer, sizeof(buffer));
+    gui_set_arena(&arena);
+
+    Widget *panel = container_create(0, 0, 100, 100, LAYOUT_TYPE_NONE);
+    Widget *children[9];
+    for (int i = 0; i < 9; i++)
+        children[i] = label_create(0, 0, "x");
+    for (int i = 0; i < 8; i++)
+        container_add_child(panel, children[i]);
+
+    // Room for the larger children array but not the sizes that go with it
+    ContainerData *data = (ContainerData *)widget_data(panel);
+    Widget **before = data->children;
+    arena.capacity = arena.used + 8 + sizeof(Widget *) * 16;
+    container_add_child(panel, children[8]);
+
+    TEST_ASSERT_EQUAL_INT(8, container_get_child_count(panel));
+    TEST_ASSERT_EQUAL_INT(8, data->child_capacity);
+    TEST_ASSERT_EQUAL_PTR(before, data->children);
+
+    arena.capacity = sizeof(buffer);
+    container_add_child(panel, children[8]);
+
+    TEST_ASSERT_EQUAL_INT(9, container_get_child_count(panel));
+    TEST_ASSERT_EQUAL_INT(16, data->child_capacity);
+    TEST_ASSERT_EQUAL_PTR(children[7], container_get_child(panel, 7));
+
+    gui_set_arena(NULL);
+}
+
 int main(void)
 {
     UNITY_BEGIN();
@@ -460,6 +994,30 @@ int main(void)
     RUN_TEST(test_container_vbox_layout);
     RUN_TEST(test_container_hbox_with_spacing);
     RUN_TEST(test_container_vbox_with_padding);
+    RUN_TEST(test_container_click_reaches_only_topmost_child);
+    RUN_TEST(test_container_click_skips_disabled_child);
+    RUN_TEST(test_container_hit_test_reaches_child_outside_parent);
+    RUN_TEST(test_container_bounds_follow_children);
+    RUN_TEST(test_container_hit_test_in_layout);
+    RUN_TEST(test_container_paint_change_skips_layout);
+    RUN_TEST(test_container_child_resize_requests_layout);
+    RUN_TEST(test_container_visibility_change_requests_layout);
+    RUN_TEST(test_container_nested_layout_stays_local);
+    RUN_TEST(test_container_batched_update_defers_layout);
+    RUN_TEST(test_container_batched_update_nests);
+    RUN_TEST(test_container_batched_update_covers_descendants);
+    RUN_TEST(test_container_update_with_null);
+    RUN_TEST(test_container_flex_weights_share_free_space);
+    RUN_TEST(test_container_flex_share_is_exact);
+    RUN_TEST(test_container_max_clamps_and_redistributes);
+    RUN_TEST(test_container_min_holds_against_small_share);
+    RUN_TEST(test_container_repeated_layout_is_stable);
+    RUN_TEST(test_container_nested_layout_settles_in_one_pass);
+    RUN_TEST(test_container_measure_is_cached_until_content_changes);
+    RUN_TEST(test_container_move_keeps_children_relative);
+    RUN_TEST(test_container_render_resolves_screen_position);
+    RUN_TEST(test_container_floating_animation_skips_layout);
+    RUN_TEST(test_container_add_child_keeps_arrays_when_growing_fails);
 
     return UNITY_END();
 }
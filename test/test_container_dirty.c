@@ -1,4 +1,5 @@
 #include "unity.h"
+#include "widgets/button.h"
 #include "widgets/container.h"
 #include "widgets/label.h"
 #include "widgets/widget.h"
@@ -300,7 +301,7 @@ void test_container_has_dirty_callback(void)
 {
     container = container_create(0, 0, 200, 200, LAYOUT_TYPE_VBOX);
 
-    TEST_ASSERT_NOT_NULL(container->on_dirty);
+    TEST_ASSERT_NOT_NULL(container->vtable->on_dirty);
 }
 
 void test_sibling_dirty_does_not_affect_each_other(void)
@@ -346,6 +347,152 @@ void test_multiple_dirty_marks_stay_dirty(void)
     TEST_ASSERT_TRUE(container->dirty);
 }
 
+static int render_count;
+
+static void count_render(Widget *widget, Framebuffer *framebuffer)
+{
+    (void)widget;
+    (void)framebuffer;
+    render_count++;
+}
+
+static const WidgetVTable counting_vtable = {.render = count_render};
+
+static Widget *counting_widget_create(int x, int y, int width, int height)
+{
+    return widget_create(WIDGET_TYPE_LABEL, &counting_vtable, 0, x, y, width, height);
+}
+
+void test_widget_under_opaque_sibling_is_not_rendered(void)
+{
+    static Color pixels[200 * 200];
+    Framebuffer fb = {.pixels = pixels, .width = 200, .height = 200};
+    container = container_create(0, 0, 200, 200, LAYOUT_TYPE_NONE);
+    Widget *hidden = counting_widget_create(20, 20, 40, 40);
+    Widget *cover = button_create(10, 10, 80, 80, "Cover");
+    container_add_child(container, hidden);
+    container_add_child(container, cover);
+    render_count = 0;
+
+    widget_render(container, &fb);
+
+    TEST_ASSERT_EQUAL(0, render_count);
+    TEST_ASSERT_FALSE(hidden->dirty);
+    TEST_ASSERT_EQUAL(20, hidden->prev_x);
+    TEST_ASSERT_EQUAL(0, fb.occluder_count);
+}
+
+void test_partially_covered_widget_is_rendered(void)
+{
+    Framebuffer fb = {0};
+    container = container_create(0, 0, 200, 200, LAYOUT_TYPE_NONE);
+    container_add_child(container, counting_widget_create(5, 20, 40, 40));
+    container_add_child(container, button_create(10, 10, 80, 80, "Cover"));
+    render_count = 0;
+
+    widget_render(container, &fb);
+
+    TEST_ASSERT_EQUAL(1, render_count);
+}
+
+void test_widget_above_opaque_sibling_is_rendered(void)
+{
+    Framebuffer fb = {0};
+    container = container_create(0, 0, 200, 200, LAYOUT_TYPE_NONE);
+    container_add_child(container, button_create(10, 10, 80, 80, "Cover"));
+    container_add_child(container, counting_widget_create(20, 20, 40, 40));
+    render_count = 0;
+
+    widget_render(container, &fb);
+
+    TEST_ASSERT_EQUAL(1, render_count);
+}
+
+void test_clean_opaque_sibling_does_not_occlude(void)
+{
+    Framebuffer fb = {0};
+    container = container_create(0, 0, 200, 200, LAYOUT_TYPE_NONE);
+    Widget *below = counting_widget_create(20, 20, 40, 40);
+    container_add_child(container, below);
+    container_add_child(container, button_create(10, 10, 80, 80, "Cover"));
+    widget_render(container, &fb);
+    render_count = 0;
+
+    // The button is not redrawn this frame, so whatever is cleared beneath it would show through
+    below->dirty = true;
+    container->dirty = true;
+    widget_render(container, &fb);
+
+    TEST_ASSERT_EQUAL(1, render_count);
+}
+
+void test_occluders_apply_to_nested_containers(void)
+{
+    Framebuffer fb = {0};
+    container = container_create(0, 0, 200, 200, LAYOUT_TYPE_NONE);
+    Widget *page = container_create(0, 0, 200, 200, LAYOUT_TYPE_NONE);
+    Widget *inner = container_create(50, 50, 20, 20, LAYOUT_TYPE_NONE);
+    container_add_child(inner, counting_widget_create(0, 0, 10, 10));
+    container_add_child(page, inner);
+    container_add_child(page, counting_widget_create(0, 0, 10, 10));
+    container_add_child(container, page);
+    container_add_child(container, button_create(40, 40, 40, 40, "Cover"));
+    render_count = 0;
+
+    widget_render(container, &fb);
+
+    // The inner container lies under the button, the other widget does not
+    TEST_ASSERT_EQUAL(1, render_count);
+}
+
+void test_moving_opaque_widget_exposes_covered_sibling(void)
+{
+    Framebuffer fb = {0};
+    container = container_create(0, 0, 200, 200, LAYOUT_TYPE_NONE);
+    Widget *hidden = counting_widget_create(20, 20, 40, 40);
+    Widget *cover = button_create(10, 10, 80, 80, "Cover");
+    container_add_child(container, hidden);
+    container_add_child(container, cover);
+    widget_render(container, &fb);
+    render_count = 0;
+
+    widget_set_position(cover, 100, 100);
+    widget_render(container, &fb);
+
+    TEST_ASSERT_EQUAL(1, render_count);
+}
+
+void test_hiding_opaque_widget_exposes_covered_sibling(void)
+{
+    Framebuffer fb = {0};
+    container = container_create(0, 0, 200, 200, LAYOUT_TYPE_NONE);
+    container_add_child(container, counting_widget_create(20, 20, 40, 40));
+    Widget *cover = button_create(10, 10, 80, 80, "Cover");
+    container_add_child(container, cover);
+    widget_render(container, &fb);
+    render_count = 0;
+
+    widget_set_visible(cover, false);
+    widget_render(container, &fb);
+
+    TEST_ASSERT_EQUAL(1, render_count);
+}
+
+void test_transparent_widget_does_not_occlude(void)
+{
+    Framebuffer fb = {0};
+    container = container_create(0, 0, 200, 200, LAYOUT_TYPE_NONE);
+    container_add_child(container, counting_widget_create(20, 20, 40, 40));
+    Widget *cover = button_create(10, 10, 80, 80, "Cover");
+    widget_set_opaque(cover, false);
+    container_add_child(container, cover);
+    render_count = 0;
+
+    widget_render(container, &fb);
+
+    TEST_ASSERT_EQUAL(1, render_count);
+}
+
 int main(void)
 {
     UNITY_BEGIN();
@@ -372,6 +519,14 @@ int main(void)
     RUN_TEST(test_sibling_dirty_does_not_affect_each_other);
     RUN_TEST(test_widget_mark_dirty_on_null_widget);
     RUN_TEST(test_multiple_dirty_marks_stay_dirty);
+    RUN_TEST(test_widget_under_opaque_sibling_is_not_rendered);
+    RUN_TEST(test_partially_covered_widget_is_rendered);
+    RUN_TEST(test_widget_above_opaque_sibling_is_rendered);
+    RUN_TEST(test_clean_opaque_sibling_does_not_occlude);
+    RUN_TEST(test_occluders_apply_to_nested_containers);
+    RUN_TEST(test_moving_opaque_widget_exposes_covered_sibling);
+    RUN_TEST(test_hiding_opaque_widget_exposes_covered_sibling);
+    RUN_TEST(test_transparent_widget_does_not_occlude);
 
     return UNITY_END();
 }
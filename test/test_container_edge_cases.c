@@ -83,8 +83,12 @@ void test_container_with_negative_position(void)
 
     container_add_child(container, child);
 
-    TEST_ASSERT_EQUAL_INT(-100, child->x);
-    TEST_ASSERT_EQUAL_INT(-100, child->y);
+    TEST_ASSERT_EQUAL_INT(0, child->x);
+
+    int x, y;
+    widget_get_screen_position(child, &x, &y);
+    TEST_ASSERT_EQUAL_INT(-100, x);
+    TEST_ASSERT_EQUAL_INT(-100, y);
 }
 
 void test_very_large_spacing(void)
@@ -192,7 +196,7 @@ void test_rapidly_changing_layout_type(void)
     widget_set_size(child, 50, 50);
     container_add_child(container, child);
 
-    ContainerData *data = (ContainerData *)container->data;
+    ContainerData *data = (ContainerData *)widget_data(container);
 
     data->layout_type = LAYOUT_TYPE_HBOX;
     container_update_layout(container);
@@ -213,7 +217,7 @@ void test_child_capacity_expansion(void)
 {
     container = container_create(0, 0, 1000, 1000, LAYOUT_TYPE_VBOX);
 
-    ContainerData *data = (ContainerData *)container->data;
+    ContainerData *data = (ContainerData *)widget_data(container);
     int initial_capacity = data->child_capacity;
 
     for (int i = 0; i < initial_capacity + 5; i++)
@@ -128,7 +128,7 @@ void test_hbox_layout_center_justify(void)
 
     container_add_child(container, child);
 
-    TEST_ASSERT_EQUAL_INT(225, child->x);
+    TEST_ASSERT_EQUAL_INT(125, child->x);
 }
 
 void test_hbox_layout_end_justify(void)
@@ -141,7 +141,7 @@ void test_hbox_layout_end_justify(void)
 
     container_add_child(container, child);
 
-    TEST_ASSERT_EQUAL_INT(350, child->x);
+    TEST_ASSERT_EQUAL_INT(250, child->x);
 }
 
 void test_vbox_layout_basic_positioning(void)
@@ -251,7 +251,7 @@ void test_vbox_layout_center_justify(void)
 
     container_add_child(container, child);
 
-    TEST_ASSERT_EQUAL_INT(225, child->y);
+    TEST_ASSERT_EQUAL_INT(125, child->y);
 }
 
 void test_vbox_layout_end_justify(void)
@@ -264,7 +264,7 @@ void test_vbox_layout_end_justify(void)
 
     container_add_child(container, child);
 
-    TEST_ASSERT_EQUAL_INT(350, child->y);
+    TEST_ASSERT_EQUAL_INT(250, child->y);
 }
 
 void test_hbox_layout_with_invisible_children(void)
@@ -422,10 +422,14 @@ void test_container_position_offset_applies_to_children(void)
     container_add_child(container, child1);
     container_add_child(container, child2);
 
-    TEST_ASSERT_EQUAL_INT(100, child1->x);
-    TEST_ASSERT_EQUAL_INT(50, child1->y);
-    TEST_ASSERT_EQUAL_INT(150, child2->x);
-    TEST_ASSERT_EQUAL_INT(50, child2->y);
+    TEST_ASSERT_EQUAL_INT(0, child1->x);
+    TEST_ASSERT_EQUAL_INT(0, child1->y);
+    TEST_ASSERT_EQUAL_INT(50, child2->x);
+
+    int x, y;
+    widget_get_screen_position(child2, &x, &y);
+    TEST_ASSERT_EQUAL_INT(150, x);
+    TEST_ASSERT_EQUAL_INT(50, y);
 }
 
 void test_layout_none_does_not_modify_children(void)
@@ -0,0 +1,78 @@
+#include "fixed.h"
+#include "unity.h"
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_q16_conversions_round_half_away_from_zero(void)
+{
+    TEST_ASSERT_EQUAL_INT(Q16_ONE * 3, Q16_FROM_INT(3));
+    TEST_ASSERT_EQUAL_INT(2, Q16_ROUND(Q16_ONE + Q16_ONE / 2));
+    TEST_ASSERT_EQUAL_INT(-2, Q16_ROUND(-Q16_ONE - Q16_ONE / 2));
+    TEST_ASSERT_EQUAL_INT(1, Q16_ROUND(Q16_ONE + Q16_ONE / 2 - 1));
+}
+
+void test_q16_mul_and_div(void)
+{
+    TEST_ASSERT_EQUAL_INT(Q16_FROM_INT(6), q16_mul(Q16_FROM_INT(2), Q16_FROM_INT(3)));
+    TEST_ASSERT_EQUAL_INT(-Q16_ONE / 4, q16_mul(Q16_ONE / 2, -Q16_ONE / 2));
+    TEST_ASSERT_EQUAL_INT(Q16_ONE / 4, q16_div(Q16_ONE, Q16_FROM_INT(4)));
+    TEST_ASSERT_EQUAL_INT(Q16_FROM_INT(-3), q16_div(Q16_FROM_INT(6), Q16_FROM_INT(-2)));
+    TEST_ASSERT_EQUAL_INT(INT32_MAX, q16_div(Q16_ONE, 0));
+    TEST_ASSERT_EQUAL_INT(INT32_MIN, q16_div(-Q16_ONE, 0));
+}
+
+void test_q16_lerp(void)
+{
+    TEST_ASSERT_EQUAL_INT(Q16_FROM_INT(15), q16_lerp(Q16_FROM_INT(10), Q16_FROM_INT(20), Q16_ONE / 2));
+    TEST_ASSERT_EQUAL_INT(Q16_FROM_INT(20), q16_lerp(Q16_FROM_INT(10), Q16_FROM_INT(20), Q16_ONE));
+    TEST_ASSERT_EQUAL_INT(Q16_FROM_INT(5), q16_lerp(Q16_FROM_INT(10), Q16_FROM_INT(0), Q16_ONE / 2));
+}
+
+void test_q16_sqrt(void)
+{
+    TEST_ASSERT_EQUAL_INT(Q16_FROM_INT(3), q16_sqrt(Q16_FROM_INT(9)));
+    TEST_ASSERT_EQUAL_INT(Q16_ONE / 2, q16_sqrt(Q16_ONE / 4));
+    TEST_ASSERT_INT_WITHIN(1, 92682, q16_sqrt(Q16_FROM_INT(2)));
+    TEST_ASSERT_EQUAL_INT(Q16_FROM_INT(181), q16_sqrt(Q16_FROM_INT(181 * 181)));
+    TEST_ASSERT_EQUAL_INT(0, q16_sqrt(-Q16_ONE));
+}
+
+void test_q15_sin_and_cos(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, q15_sin(0));
+    TEST_ASSERT_EQUAL_INT(Q15_ONE, q15_sin(ANGLE_FROM_DEGREES(90)));
+    TEST_ASSERT_EQUAL_INT(0, q15_sin(ANGLE_FROM_DEGREES(180)));
+    TEST_ASSERT_EQUAL_INT(-Q15_ONE, q15_sin(ANGLE_FROM_DEGREES(270)));
+    TEST_ASSERT_INT_WITHIN(8, 16384, q15_sin(ANGLE_FROM_DEGREES(30)));
+    TEST_ASSERT_INT_WITHIN(8, -16384, q15_sin(ANGLE_FROM_DEGREES(210)));
+    TEST_ASSERT_EQUAL_INT(Q15_ONE, q15_cos(0));
+    TEST_ASSERT_INT_WITHIN(8, 16384, q15_cos(ANGLE_FROM_DEGREES(60)));
+    TEST_ASSERT_INT_WITHIN(2, -Q16_ONE, q16_cos(ANGLE_FROM_DEGREES(180)));
+}
+
+void test_q15_mul(void)
+{
+    TEST_ASSERT_EQUAL_INT(8192, q15_mul(16384, 16384));
+    TEST_ASSERT_EQUAL_INT(-8192, q15_mul(-16384, 16384));
+    TEST_ASSERT_INT_WITHIN(1, Q15_ONE, q15_mul(Q15_ONE, Q15_ONE));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_q16_conversions_round_half_away_from_zero);
+    RUN_TEST(test_q16_mul_and_div);
+    RUN_TEST(test_q16_lerp);
+    RUN_TEST(test_q16_sqrt);
+    RUN_TEST(test_q15_sin_and_cos);
+    RUN_TEST(test_q15_mul);
+
+    return UNITY_END();
+}
@@ -216,7 +216,7 @@ void test_grid_layout_default_columns(void)
 {
     container = container_create(0, 0, 200, 200, LAYOUT_TYPE_GRID);
 
-    ContainerData *data = (ContainerData *)container->data;
+    ContainerData *data = (ContainerData *)widget_data(container);
     TEST_ASSERT_EQUAL_INT(2, data->grid_columns);
 
     Widget *child1 = label_create(0, 0, "1");
@@ -240,10 +240,14 @@ void test_grid_layout_position_offset(void)
     container_add_child(container, child1);
     container_add_child(container, child2);
 
-    TEST_ASSERT_EQUAL_INT(100, child1->x);
-    TEST_ASSERT_EQUAL_INT(50, child1->y);
-    TEST_ASSERT_EQUAL_INT(200, child2->x);
-    TEST_ASSERT_EQUAL_INT(50, child2->y);
+    TEST_ASSERT_EQUAL_INT(0, child1->x);
+    TEST_ASSERT_EQUAL_INT(0, child1->y);
+    TEST_ASSERT_EQUAL_INT(100, child2->x);
+
+    int x, y;
+    widget_get_screen_position(child2, &x, &y);
+    TEST_ASSERT_EQUAL_INT(200, x);
+    TEST_ASSERT_EQUAL_INT(50, y);
 }
 
 void test_grid_layout_cell_sizes_uniform(void)
@@ -0,0 +1,158 @@
+#include "gui_arena.h"
+#include "unity.h"
+#include "widgets/button.h"
+#include "widgets/container.h"
+#include "widgets/label.h"
+#include <string.h>
+
+static uint8_t buffer[16 * 1024];
+static GuiArena arena;
+
+void setUp(void)
+{
+    gui_arena_init(&arena, buffer, sizeof(buffer));
+}
+
+void tearDown(void)
+{
+    gui_set_arena(NULL);
+}
+
+void test_gui_arena_alloc_is_aligned_and_owned(void)
+{
+    void *a = gui_arena_alloc(&arena, 3);
+    void *b = gui_arena_alloc(&arena, 100);
+
+    TEST_ASSERT_NOT_NULL(a);
+    TEST_ASSERT_NOT_NULL(b);
+    TEST_ASSERT_EQUAL_INT(0, (uintptr_t)a % GUI_ARENA_ALIGN);
+    TEST_ASSERT_EQUAL_INT(0, (uintptr_t)b % GUI_ARENA_ALIGN);
+    TEST_ASSERT_TRUE(gui_arena_owns(&arena, a));
+    TEST_ASSERT_FALSE(gui_arena_owns(&arena, &arena));
+    TEST_ASSERT_NULL(gui_arena_alloc(&arena, 0));
+}
+
+void test_gui_arena_reuses_freed_block_of_same_class(void)
+{
+    void *first = gui_arena_alloc(&arena, 40);
+    size_t used = arena.used;
+    gui_arena_free(&arena, first);
+
+    void *second = gui_arena_alloc(&arena, 33);
+    TEST_ASSERT_EQUAL_PTR(first, second);
+    TEST_ASSERT_EQUAL_INT(used, arena.used);
+
+    void *other = gui_arena_alloc(&arena, 200);
+    TEST_ASSERT_TRUE(other != first);
+    TEST_ASSERT_EQUAL_INT(2, arena.pool_count);
+}
+
+void test_gui_arena_fails_when_full(void)
+{
+    uint8_t small[64];
+    GuiArena tiny;
+    gui_arena_init(&tiny, small, sizeof(small));
+
+    TEST_ASSERT_NOT_NULL(gui_arena_alloc(&tiny, 16));
+    TEST_ASSERT_NULL(gui_arena_alloc(&tiny, 64));
+
+    GuiArenaStats stats;
+    gui_arena_get_stats(&tiny, &stats);
+    TEST_ASSERT_EQUAL_INT(1, stats.failed_allocations);
+    TEST_ASSERT_EQUAL_INT(1, stats.live_blocks);
+}
+
+void test_gui_arena_stats_track_peak_and_fragmentation(void)
+{
+    void *blocks[4];
+    for (int i = 0; i < 4; i++)
+        blocks[i] = gui_arena_alloc(&arena, 128);
+
+    gui_arena_free(&arena, blocks[1]);
+    gui_arena_free(&arena, blocks[2]);
+
+    GuiArenaStats stats;
+    gui_arena_get_stats(&arena, &stats);
+    TEST_ASSERT_EQUAL_INT(256, stats.live_bytes);
+    TEST_ASSERT_EQUAL_INT(512, stats.peak_live_bytes);
+    TEST_ASSERT_EQUAL_INT(2, stats.live_blocks);
+    TEST_ASSERT_EQUAL_INT(2 * (128 + 8), stats.free_bytes);
+    TEST_ASSERT_EQUAL_INT(4 * (128 + 8), stats.used);
+    TEST_ASSERT_EQUAL_INT((4 * 136 - 256) * 100 / (4 * 136), stats.fragmentation_percent);
+}
+
+void test_gui_arena_reset_releases_everything(void)
+{
+    gui_arena_alloc(&arena, 500);
+    gui_arena_alloc(&arena, 20);
+    gui_arena_reset(&arena);
+
+    GuiArenaStats stats;
+    gui_arena_get_stats(&arena, &stats);
+    TEST_ASSERT_EQUAL_INT(0, stats.used);
+    TEST_ASSERT_EQUAL_INT(0, stats.live_blocks);
+    TEST_ASSERT_EQUAL_INT(0, stats.pool_count);
+    TEST_ASSERT_TRUE(stats.peak_used > 0);
+}
+
+void test_gui_realloc_keeps_contents(void)
+{
+    gui_set_arena(&arena);
+    int *values = (int *)gui_alloc(4 * sizeof(int));
+    for (int i = 0; i < 4; i++)
+        values[i] = i + 1;
+
+    values = (int *)gui_realloc(values, 8 * sizeof(int));
+    TEST_ASSERT_TRUE(gui_arena_owns(&arena, values));
+    TEST_ASSERT_EQUAL_INT(4, values[3]);
+
+    char *text = gui_strdup("hello");
+    TEST_ASSERT_EQUAL_STRING("hello", text);
+    gui_free(text);
+    gui_free(values);
+    TEST_ASSERT_EQUAL_INT(0, arena.live_bytes);
+}
+
+void test_gui_arena_holds_widget_tree(void)
+{
+    gui_set_arena(&arena);
+
+    Widget *root = container_create(0, 0, 200, 200, LAYOUT_TYPE_VBOX);
+    for (int i = 0; i < 12; i++)
+        container_add_child(root, label_create(0, 0, "label"));
+    container_add_child(root, button_create(0, 0, 50, 20, "ok"));
+    label_set_text(container_get_child(root, 0), "a longer label text");
+
+    TEST_ASSERT_TRUE(gui_arena_owns(&arena, root));
+    TEST_ASSERT_TRUE(gui_arena_owns(&arena, widget_data(root)));
+    TEST_ASSERT_EQUAL_INT(13, container_get_child_count(root));
+
+    GuiArenaStats stats;
+    gui_arena_get_stats(&arena, &stats);
+    TEST_ASSERT_EQUAL_INT(0, stats.failed_allocations);
+    TEST_ASSERT_TRUE(stats.pool_count <= GUI_ARENA_MAX_POOLS);
+
+    widget_destroy(root);
+    gui_free(root);
+    TEST_ASSERT_EQUAL_INT(0, arena.live_bytes);
+
+    size_t used = arena.used;
+    root = container_create(0, 0, 200, 200, LAYOUT_TYPE_VBOX);
+    container_add_child(root, label_create(0, 0, "label"));
+    TEST_ASSERT_EQUAL_INT(used, arena.used);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_gui_arena_alloc_is_aligned_and_owned);
+    RUN_TEST(test_gui_arena_reuses_freed_block_of_same_class);
+    RUN_TEST(test_gui_arena_fails_when_full);
+    RUN_TEST(test_gui_arena_stats_track_peak_and_fragmentation);
+    RUN_TEST(test_gui_arena_reset_releases_everything);
+    RUN_TEST(test_gui_realloc_keeps_contents);
+    RUN_TEST(test_gui_arena_holds_widget_tree);
+
+    return UNITY_END();
+}
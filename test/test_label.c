@@ -1,4 +1,5 @@
 #include "color.h"
+#include "gui_arena.h"
 #include "unity.h"
 #include "widgets/label.h"
 #include "widgets/widget.h"
@@ -41,7 +42,7 @@ void test_label_creation(void)
     TEST_ASSERT_EQUAL_INT(0, label->height);
     TEST_ASSERT_TRUE(label->visible);
     TEST_ASSERT_TRUE(label->enabled);
-    TEST_ASSERT_NOT_NULL(label->data);
+    TEST_ASSERT_NOT_NULL(widget_data(label));
 }
 
 void test_label_creation_with_null_text(void)
@@ -101,7 +102,7 @@ void test_label_set_text_marks_dirty(void)
 
 void test_label_default_text_color(void)
 {
-    LabelData *data = (LabelData *)label->data;
+    LabelData *data = (LabelData *)widget_data(label);
     TEST_ASSERT_EQUAL_COLOR(COLOR_WHITE, data->text_color);
 }
 
@@ -109,7 +110,7 @@ void test_label_set_color(void)
 {
     label_set_color(label, COLOR_BLACK);
 
-    LabelData *data = (LabelData *)label->data;
+    LabelData *data = (LabelData *)widget_data(label);
     TEST_ASSERT_EQUAL_COLOR(COLOR_BLACK, data->text_color);
 }
 
@@ -128,7 +129,7 @@ void test_label_set_font(void)
 
     label_set_font(label, mock_font);
 
-    LabelData *data = (LabelData *)label->data;
+    LabelData *data = (LabelData *)widget_data(label);
     TEST_ASSERT_EQUAL_PTR(mock_font, data->font);
 }
 
@@ -144,7 +145,7 @@ void test_label_set_font_marks_dirty(void)
 
 void test_label_default_font(void)
 {
-    LabelData *data = (LabelData *)label->data;
+    LabelData *data = (LabelData *)widget_data(label);
     TEST_ASSERT_NULL(data->font);
 }
 
@@ -181,12 +182,12 @@ void test_label_set_font_with_null_label(void)
 
 void test_label_has_render_callback(void)
 {
-    TEST_ASSERT_NOT_NULL(label->render);
+    TEST_ASSERT_NOT_NULL(label->vtable->render);
 }
 
 void test_label_has_destroy_callback(void)
 {
-    TEST_ASSERT_NOT_NULL(label->destroy);
+    TEST_ASSERT_NOT_NULL(label->vtable->destroy);
 }
 
 void test_label_dirty_flag_on_creation(void)
@@ -194,6 +195,70 @@ void test_label_dirty_flag_on_creation(void)
     TEST_ASSERT_TRUE(label->dirty);
 }
 
+void test_label_set_same_text_is_noop(void)
+{
+    label->dirty = false;
+
+    label_set_text(label, "Test Label");
+
+    TEST_ASSERT_FALSE(label->dirty);
+}
+
+void test_label_buffered_text_is_copied_inline(void)
+{
+    Widget *buffered = label_create_buffered(0, 0, "Round 1", 8);
+    const char *stored = label_get_text(buffered);
+    TEST_ASSERT_EQUAL_PTR((char *)widget_data(buffered) + sizeof(LabelData), stored);
+
+    label_set_text(buffered, "Round 12");
+    TEST_ASSERT_EQUAL_STRING("Round 1", label_get_text(buffered));
+    TEST_ASSERT_EQUAL_PTR(stored, label_get_text(buffered));
+
+    label_set_text(buffered, "R 2");
+    TEST_ASSERT_EQUAL_STRING("R 2", label_get_text(buffered));
+
+    widget_destroy(buffered);
+    free(buffered);
+}
+
+void test_label_static_text_is_borrowed(void)
+{
+    static const char prompt[] = "Circle";
+
+    label_set_static_text(label, prompt);
+    TEST_ASSERT_EQUAL_PTR(prompt, label_get_text(label));
+
+    label->dirty = false;
+    label_set_static_text(label, prompt);
+    TEST_ASSERT_FALSE(label->dirty);
+
+    label_set_text(label, "Square");
+    TEST_ASSERT_EQUAL_STRING("Square", label_get_text(label));
+    TEST_ASSERT_TRUE(label_get_text(label) != prompt);
+}
+
+void test_label_buffered_updates_do_not_allocate(void)
+{
+    static uint8_t buffer[4096];
+    GuiArena arena;
+    gui_arena_init(&arena, buffer, sizeof(buffer));
+    gui_set_arena(&arena);
+
+    Widget *buffered = label_create_buffered(0, 0, "Round 0", 16);
+    unsigned int allocations = arena.allocations;
+
+    label_set_text(buffered, "Round 1");
+    label_set_text(buffered, "Round 2");
+    label_set_static_text(buffered, "Cat");
+    label_set_text(buffered, "Round 3");
+
+    TEST_ASSERT_EQUAL_UINT(allocations, arena.allocations);
+
+    widget_destroy(buffered);
+    gui_free(buffered);
+    gui_set_arena(NULL);
+}
+
 int main(void)
 {
     UNITY_BEGIN();
@@ -219,6 +284,10 @@ int main(void)
     RUN_TEST(test_label_has_render_callback);
     RUN_TEST(test_label_has_destroy_callback);
     RUN_TEST(test_label_dirty_flag_on_creation);
+    RUN_TEST(test_label_set_same_text_is_noop);
+    RUN_TEST(test_label_buffered_text_is_copied_inline);
+    RUN_TEST(test_label_static_text_is_borrowed);
+    RUN_TEST(test_label_buffered_updates_do_not_allocate);
 
     return UNITY_END();
 }
@@ -0,0 +1,301 @@
+#include "primitives/rectangle.h"
+#include "unity.h"
+#include "widgets/container.h"
+#include "widgets/list.h"
+#include <stdlib.h>
+
+#define FB_WIDTH 40
+#define FB_HEIGHT 60
+#define ROW_HEIGHT 10
+
+typedef struct
+{
+    int index;
+} RowData;
+
+static Color pixels[FB_WIDTH * FB_HEIGHT];
+static Framebuffer fb;
+static Widget *list;
+static int rows_created;
+static int binds;
+static int renders;
+
+static Color item_color(int index)
+{
+    return COLOR_RGB(index, 0x80, 0x80);
+}
+
+static void row_render(Widget *row, Framebuffer *framebuffer)
+{
+    RowData *data = (RowData *)widget_data(row);
+    renders++;
+    renderFilledRectangle(framebuffer->origin_x + row->x, framebuffer->origin_y + row->y, row->width, row->height,
+                          item_color(data->index), framebuffer);
+}
+
+static const WidgetVTable row_vtable = {.render = row_render};
+
+static Widget *create_row(void *user_data)
+{
+    (void)user_data;
+    rows_created++;
+    return widget_create(WIDGET_TYPE_LABEL, &row_vtable, sizeof(RowData), 0, 0, 0, 0);
+}
+
+static void bind_row(Widget *row, int index, void *user_data)
+{
+    (void)user_data;
+    binds++;
+    ((RowData *)widget_data(row))->index = index;
+    widget_mark_dirty(row);
+}
+
+static Color pixel_at(int x, int y)
+{
+    return pixels[y * FB_WIDTH + x];
+}
+
+void setUp(void)
+{
+    fb = (Framebuffer){.pixels = pixels, .width = FB_WIDTH, .height = FB_HEIGHT};
+    framebuffer_clear(&fb, COLOR_BLACK);
+    rows_created = 0;
+    binds = 0;
+    renders = 0;
+    list = list_create(5, 10, 20, 40, ROW_HEIGHT, create_row, bind_row, NULL);
+}
+
+void tearDown(void)
+{
+    widget_destroy(list);
+    free(list);
+}
+
+static void render_frame(void)
+{
+    widget_handle_dirty(list, &fb);
+    framebuffer_clear_dirty_rects(&fb, COLOR_BLACK);
+    widget_render(list, &fb);
+    renders = 0;
+}
+
+void test_list_creates_rows_only_for_visible_window(void)
+{
+    list_set_item_count(list, 1000);
+    render_frame();
+
+    TEST_ASSERT_EQUAL_INT(6, rows_created);
+    TEST_ASSERT_EQUAL_INT(4, binds);
+    TEST_ASSERT_TRUE(COLOR_COMPARE(item_color(0), pixel_at(5, 10)));
+    TEST_ASSERT_TRUE(COLOR_COMPARE(item_color(3), pixel_at(24, 49)));
+    TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_BLACK, pixel_at(5, 50)));
+}
+
+void test_list_scroll_recycles_rows(void)
+{
+    list_set_item_count(list, 1000);
+    render_frame();
+    binds = 0;
+
+    for (int i = 0; i < 500; i++)
+        list_scroll_by(list, 7);
+    render_frame();
+
+    TEST_ASSERT_EQUAL_INT(6, rows_created);
+    TEST_ASSERT_EQUAL_INT(3500, list_get_scroll_offset(list));
+    TEST_ASSERT_TRUE(binds >= 350 && binds <= 360);
+    TEST_ASSERT_TRUE(COLOR_COMPARE(item_color(350), pixel_at(5, 10)));
+}
+
+void test_list_blit_scroll_draws_only_exposed_band(void)
+{
+    list_set_item_count(list, 100);
+    render_frame();
+
+    list_scroll_by(list, 5);
+    widget_handle_dirty(list, &fb);
+    TEST_ASSERT_EQUAL_INT(0, fb.dirty_rect_count);
+    widget_render(list, &fb);
+
+    // Items 0-3 were copied up; only item 4, now half visible at the bottom, was drawn
+    TEST_ASSERT_EQUAL_INT(1, renders);
+    TEST_ASSERT_TRUE(COLOR_COMPARE(item_color(0), pixel_at(5, 10)));
+    TEST_ASSERT_TRUE(COLOR_COMPARE(item_color(1), pixel_at(5, 15)));
+    TEST_ASSERT_TRUE(COLOR_COMPARE(item_color(4), pixel_at(5, 45)));
+    TEST_ASSERT_TRUE(COLOR_COMPARE(item_color(4), pixel_at(24, 49)));
+    TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_BLACK, pixel_at(5, 50)));
+    TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_BLACK, pixel_at(4, 45)));
+}
+
+void test_list_scroll_up_draws_band_at_top(void)
+{
+    list_set_item_count(list, 100);
+    list_scroll_to(list, 20);
+    render_frame();
+
+    list_scroll_by(list, -3);
+    widget_handle_dirty(list, &fb);
+    widget_render(list, &fb);
+
+    TEST_ASSERT_EQUAL_INT(1, renders);
+    TEST_ASSERT_TRUE(COLOR_COMPARE(item_color(1), pixel_at(5, 10)));
+    TEST_ASSERT_TRUE(COLOR_COMPARE(item_color(2), pixel_at(5, 13)));
+    TEST_ASSERT_TRUE(COLOR_COMPARE(item_color(5), pixel_at(5, 49)));
+}
+
+void test_list_scroll_is_clamped(void)
+{
+    list_set_item_count(list, 6);
+
+    list_scroll_by(list, -10);
+    TEST_ASSERT_EQUAL_INT(0, list_get_scroll_offset(list));
+
+    list_scroll_to(list, 1000);
+    TEST_ASSERT_EQUAL_INT(20, list_get_max_scroll(list));
+    TEST_ASSERT_EQUAL_INT(20, list_get_scroll_offset(list));
+
+    list_set_item_count(list, 2);
+    TEST_ASSERT_EQUAL_INT(0, list_get_scroll_offset(list));
+}
+
+void test_list_item_at(void)
+{
+    list_set_item_count(list, 100);
+    list_scroll_to(list, 15);
+
+    TEST_ASSERT_EQUAL_INT(1, list_item_at(list, 6, 10));
+    TEST_ASSERT_EQUAL_INT(2, list_item_at(list, 6, 15));
+    TEST_ASSERT_EQUAL_INT(-1, list_item_at(list, 4, 15));
+
+    list_set_item_count(list, 3);
+    TEST_ASSERT_EQUAL_INT(-1, list_item_at(list, 6, 45));
+}
+
+void test_list_refresh_redraws_rebound_rows(void)
+{
+    list_set_item_count(list, 100);
+    render_frame();
+    binds = 0;
+
+    list_refresh(list);
+    widget_render(list, &fb);
+
+    TEST_ASSERT_EQUAL_INT(4, binds);
+    TEST_ASSERT_EQUAL_INT(4, renders);
+}
+
+void test_list_in_container_follows_parent(void)
+{
+    Widget *panel = container_create(10, 0, 40, 60, LAYOUT_TYPE_NONE);
+    Widget *inner = list_create(0, 0, 20, 20, ROW_HEIGHT, create_row, bind_row, NULL);
+    container_add_child(panel, inner);
+    list_set_item_count(inner, 10);
+
+    widget_handle_dirty(panel, &fb);
+    widget_render(panel, &fb);
+
+    TEST_ASSERT_TRUE(COLOR_COMPARE(item_color(1), pixel_at(10, 15)));
+    TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_BLACK, pixel_at(9, 15)));
+    TEST_ASSERT_EQUAL_INT(0, list_item_at(inner, 12, 5));
+
+    widget_destroy(panel);
+    free(panel);
+}
+
+void test_framebuffer_view_clips_drawing(void)
+{
+    Framebuffer view = framebuffer_view(&fb, 30, 50, 20, 20);
+
+    TEST_ASSERT_EQUAL_INT(10, view.width);
+    TEST_ASSERT_EQUAL_INT(10, view.height);
+    TEST_ASSERT_EQUAL_INT(FB_WIDTH, FRAMEBUFFER_STRIDE(&view));
+
+    renderFilledRectangle(0, 0, 20, 20, COLOR_RED, &view);
+    TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_RED, pixel_at(30, 50)));
+    TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_RED, pixel_at(39, 59)));
+    TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_BLACK, pixel_at(29, 50)));
+
+    Framebuffer outside = framebuffer_view(&fb, 50, 0, 10, 10);
+    TEST_ASSERT_NULL(outside.pixels);
+}
+
+static void cover_render(Widget *widget, Framebuffer *framebuffer)
+{
+    renderFilledRectangle(framebuffer->origin_x + widget->x, framebuffer->origin_y + widget->y, widget->width,
+                          widget->height, COLOR_RED, framebuffer);
+}
+
+static const WidgetVTable cover_vtable = {.render = cover_render};
+
+void test_list_redraws_area_exposed_by_sibling(void)
+{
+    Widget *panel = container_create(0, 0, FB_WIDTH, FB_HEIGHT, LAYOUT_TYPE_NONE);
+    Widget *inner = list_create(5, 10, 20, 40, ROW_HEIGHT, create_row, bind_row, NULL);
+    Widget *cover = widget_create(WIDGET_TYPE_LABEL, &cover_vtable, 0, 10, 12, 10, 10);
+    cover->opaque = true;
+    container_add_child(panel, inner);
+    container_add_child(panel, cover);
+    list_set_item_count(inner, 10);
+
+    widget_handle_dirty(panel, &fb);
+    framebuffer_clear_dirty_rects(&fb, COLOR_BLACK);
+    widget_render(panel, &fb);
+    TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_RED, pixel_at(15, 15)));
+
+    widget_set_position(cover, 30, 0);
+    widget_handle_dirty(panel, &fb);
+    framebuffer_clear_dirty_rects(&fb, COLOR_BLACK);
+    widget_render(panel, &fb);
+
+    TEST_ASSERT_TRUE(COLOR_COMPARE(item_color(0), pixel_at(15, 15)));
+    TEST_ASSERT_TRUE(COLOR_COMPARE(item_color(1), pixel_at(15, 21)));
+
+    widget_destroy(panel);
+    free(panel);
+}
+
+void test_list_scrolled_while_exposed_is_redrawn_in_full(void)
+{
+    Widget *panel = container_create(0, 0, FB_WIDTH, FB_HEIGHT, LAYOUT_TYPE_NONE);
+    Widget *inner = list_create(5, 10, 20, 40, ROW_HEIGHT, create_row, bind_row, NULL);
+    Widget *cover = widget_create(WIDGET_TYPE_LABEL, &cover_vtable, 0, 10, 12, 10, 10);
+    cover->opaque = true;
+    container_add_child(panel, inner);
+    container_add_child(panel, cover);
+    list_set_item_count(inner, 10);
+
+    widget_handle_dirty(panel, &fb);
+    framebuffer_clear_dirty_rects(&fb, COLOR_BLACK);
+    widget_render(panel, &fb);
+
+    list_scroll_by(inner, 5);
+    widget_set_position(cover, 30, 0);
+    widget_handle_dirty(panel, &fb);
+    framebuffer_clear_dirty_rects(&fb, COLOR_BLACK);
+    widget_render(panel, &fb);
+
+    TEST_ASSERT_TRUE(COLOR_COMPARE(item_color(0), pixel_at(15, 12)));
+    TEST_ASSERT_TRUE(COLOR_COMPARE(item_color(1), pixel_at(15, 21)));
+
+    widget_destroy(panel);
+    free(panel);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_list_creates_rows_only_for_visible_window);
+    RUN_TEST(test_list_scroll_recycles_rows);
+    RUN_TEST(test_list_blit_scroll_draws_only_exposed_band);
+    RUN_TEST(test_list_scroll_up_draws_band_at_top);
+    RUN_TEST(test_list_scroll_is_clamped);
+    RUN_TEST(test_list_item_at);
+    RUN_TEST(test_list_refresh_redraws_rebound_rows);
+    RUN_TEST(test_list_in_container_follows_parent);
+    RUN_TEST(test_framebuffer_view_clips_drawing);
+    RUN_TEST(test_list_redraws_area_exposed_by_sibling);
+    RUN_TEST(test_list_scrolled_while_exposed_is_redrawn_in_full);
+
+    return UNITY_END();
+}
@@ -0,0 +1,219 @@
+#include "overlay.h"
+#include "primitives/rectangle.h"
+#include "unity.h"
+
+#define FB_WIDTH 20
+#define FB_HEIGHT 20
+#define SPRITE_SIZE 4
+
+static Color pixels[FB_WIDTH * FB_HEIGHT];
+static Framebuffer fb;
+static Color under_a[SPRITE_SIZE * SPRITE_SIZE];
+static Color under_b[SPRITE_SIZE * SPRITE_SIZE];
+static Overlay a;
+static Overlay b;
+static OverlayLayer layer;
+static int draws;
+
+static Color pixel_at(int x, int y)
+{
+    return pixels[y * FB_WIDTH + x];
+}
+
+static void draw_solid(const Overlay *overlay, Framebuffer *framebuffer)
+{
+    draws++;
+    renderFilledRectangle(framebuffer->origin_x, framebuffer->origin_y, overlay->width, overlay->height,
+                          *(const Color *)overlay->user_data, framebuffer);
+}
+
+static const Color red = COLOR_RED;
+static const Color blue = COLOR_BLUE;
+
+// Every pixel gets its own color, so a restore that puts anything back in the wrong place shows up
+static void fill_pattern(void)
+{
+    for (int y = 0; y < FB_HEIGHT; y++)
+    {
+        for (int x = 0; x < FB_WIDTH; x++)
+            pixels[y * FB_WIDTH + x] = COLOR_RGB(x * 10, y * 10, 0);
+    }
+}
+
+static void frame(void)
+{
+    overlay_layer_restore(&layer, &fb);
+    overlay_layer_draw(&layer, &fb);
+}
+
+void setUp(void)
+{
+    fb = (Framebuffer){.pixels = pixels, .width = FB_WIDTH, .height = FB_HEIGHT};
+    fill_pattern();
+    draws = 0;
+    overlay_layer_init(&layer);
+    overlay_init(&a, under_a, SPRITE_SIZE, SPRITE_SIZE, draw_solid, (void *)&red);
+    overlay_init(&b, under_b, SPRITE_SIZE, SPRITE_SIZE, draw_solid, (void *)&blue);
+    overlay_layer_add(&layer, &a);
+    overlay_layer_add(&layer, &b);
+}
+
+void tearDown(void)
+{
+}
+
+void test_overlay_hidden_by_default(void)
+{
+    TEST_ASSERT_FALSE(overlay_layer_needs_update(&layer));
+
+    frame();
+
+    TEST_ASSERT_EQUAL_INT(0, draws);
+    TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_RGB(50, 50, 0), pixel_at(5, 5)));
+}
+
+void test_overlay_draws_clipped_to_its_rect(void)
+{
+    overlay_move(&a, 5, 5);
+    overlay_set_visible(&a, true);
+    TEST_ASSERT_TRUE(overlay_layer_needs_update(&layer));
+
+    frame();
+
+    TEST_ASSERT_FALSE(overlay_layer_needs_update(&layer));
+    TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_RED, pixel_at(5, 5)));
+    TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_RED, pixel_at(8, 8)));
+    TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_RGB(90, 90, 0), pixel_at(9, 9)));
+    TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_RGB(40, 50, 0), pixel_at(4, 5)));
+}
+
+void test_overlay_move_restores_the_pixels_it_covered(void)
+{
+    overlay_move(&a, 5, 5);
+    overlay_set_visible(&a, true);
+    frame();
+
+    overlay_move(&a, 7, 6);
+    frame();
+
+    TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_RGB(50, 50, 0), pixel_at(5, 5)));
+    TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_RGB(60, 50, 0), pixel_at(6, 5)));
+    TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_RED, pixel_at(7, 6)));
+    TEST_ASSERT_EQUAL_INT(2, draws);
+}
+
+void test_overlay_hide_restores_everything(void)
+{
+    overlay_move(&a, 2, 2);
+    overlay_set_visible(&a, true);
+    frame();
+
+    overlay_set_visible(&a, false);
+    TEST_ASSERT_TRUE(overlay_layer_needs_update(&layer));
+    frame();
+
+    for (int y = 0; y < FB_HEIGHT; y++)
+    {
+        for (int x = 0; x < FB_WIDTH; x++)
+            TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_RGB(x * 10, y * 10, 0), pixel_at(x, y)));
+    }
+}
+
+void test_overlapping_overlays_unwind_in_order(void)
+{
+    overlay_move(&a, 4, 4);
+    overlay_move(&b, 6, 6);
+    overlay_set_visible(&a, true);
+    overlay_set_visible(&b, true);
+    frame();
+
+    TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_BLUE, pixel_at(6, 6)));
+    TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_RED, pixel_at(5, 5)));
+
+    // The lower overlay moves away; the top one saved its pixels and must not bring the old ones back
+    overlay_move(&a, 12, 12);
+    frame();
+
+    TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_RGB(50, 50, 0), pixel_at(5, 5)));
+    TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_RGB(50, 70, 0), pixel_at(5, 7)));
+    TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_BLUE, pixel_at(6, 6)));
+    TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_RED, pixel_at(12, 12)));
+
+    overlay_set_visible(&a, false);
+    overlay_set_visible(&b, false);
+    frame();
+
+    TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_RGB(60, 60, 0), pixel_at(6, 6)));
+    TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_RGB(120, 120, 0), pixel_at(12, 12)));
+}
+
+void test_overlay_partly_off_screen_saves_only_visible_pixels(void)
+{
+    overlay_move(&a, -2, 18);
+    overlay_set_visible(&a, true);
+    frame();
+
+    TEST_ASSERT_EQUAL_INT(2, a.saved_width);
+    TEST_ASSERT_EQUAL_INT(2, a.saved_height);
+    TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_RED, pixel_at(0, 19)));
+
+    overlay_set_visible(&a, false);
+    frame();
+
+    TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_RGB(0, 190, 0), pixel_at(0, 19)));
+    TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_RGB(10, 180, 0), pixel_at(1, 18)));
+}
+
+void test_overlay_resaves_after_pixels_beneath_change(void)
+{
+    overlay_move(&a, 5, 5);
+    overlay_set_visible(&a, true);
+    frame();
+
+    // A widget repaints under the overlay between restore and draw
+    overlay_layer_restore(&layer, &fb);
+    renderFilledRectangle(0, 0, FB_WIDTH, FB_HEIGHT, COLOR_GREEN, &fb);
+    overlay_layer_draw(&layer, &fb);
+    overlay_set_visible(&a, false);
+    frame();
+
+    TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_GREEN, pixel_at(5, 5)));
+}
+
+void test_overlay_layer_remove_restores_first(void)
+{
+    overlay_move(&a, 5, 5);
+    overlay_set_visible(&a, true);
+    frame();
+
+    overlay_layer_remove(&layer, &a, &fb);
+
+    TEST_ASSERT_EQUAL_INT(1, layer.count);
+    TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_RGB(50, 50, 0), pixel_at(5, 5)));
+}
+
+void test_overlay_layer_is_bounded(void)
+{
+    static Overlay extra[MAX_OVERLAYS];
+    int added = 0;
+    for (int i = 0; i < MAX_OVERLAYS; i++)
+        added += overlay_layer_add(&layer, &extra[i]);
+
+    TEST_ASSERT_EQUAL_INT(MAX_OVERLAYS - 2, added);
+    TEST_ASSERT_FALSE(overlay_layer_add(NULL, &a));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_overlay_hidden_by_default);
+    RUN_TEST(test_overlay_draws_clipped_to_its_rect);
+    RUN_TEST(test_overlay_move_restores_the_pixels_it_covered);
+    RUN_TEST(test_overlay_hide_restores_everything);
+    RUN_TEST(test_overlapping_overlays_unwind_in_order);
+    RUN_TEST(test_overlay_partly_off_screen_saves_only_visible_pixels);
+    RUN_TEST(test_overlay_resaves_after_pixels_beneath_change);
+    RUN_TEST(test_overlay_layer_remove_restores_first);
+    RUN_TEST(test_overlay_layer_is_bounded);
+    return UNITY_END();
+}
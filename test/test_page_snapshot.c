@@ -0,0 +1,211 @@
+#include "page_snapshot.h"
+#include "primitives/rectangle.h"
+#include "unity.h"
+#include "widgets/container.h"
+#include <stdlib.h>
+
+#define FB_WIDTH 40
+#define FB_HEIGHT 30
+
+typedef struct
+{
+    Color color;
+    int renders;
+} Block;
+
+static Color pixels[FB_WIDTH * FB_HEIGHT];
+static Framebuffer fb;
+static SnapshotRun runs_a[256];
+static SnapshotRun runs_b[256];
+static PageSnapshot snapshot_a;
+static PageSnapshot snapshot_b;
+
+static Widget *root;
+static Widget *page_a;
+static Widget *page_b;
+static Widget block_widgets[3];
+static Block blocks[3];
+
+static Color pixel_at(int x, int y)
+{
+    return pixels[y * FB_WIDTH + x];
+}
+
+static void render_block(Widget *widget, Framebuffer *framebuffer)
+{
+    Block *block = (Block *)widget->user_data;
+    block->renders++;
+    renderFilledRectangle(framebuffer->origin_x + widget->x, framebuffer->origin_y + widget->y, widget->width,
+                          widget->height, block->color, framebuffer);
+}
+
+static const WidgetVTable block_vtable = {.render = render_block};
+
+static Widget *make_block(int index, int x, int y, int size, Color color)
+{
+    Widget *widget = &block_widgets[index];
+    widget_init(widget, WIDGET_TYPE_LABEL, x, y, size, size);
+    widget->vtable = &block_vtable;
+    widget->user_data = &blocks[index];
+    widget->preallocated = true;
+    blocks[index] = (Block){color, 0};
+    return widget;
+}
+
+static int total_renders(void)
+{
+    return blocks[0].renders + blocks[1].renders + blocks[2].renders;
+}
+
+static void frame(void)
+{
+    widget_handle_dirty(root, &fb);
+    framebuffer_clear_dirty_rects(&fb, COLOR_BLACK);
+    widget_render(root, &fb);
+}
+
+static bool swap(Widget *leaving, PageSnapshot *leaving_snapshot, Widget *entering, PageSnapshot *entering_snapshot)
+{
+    page_suspend(leaving, leaving_snapshot, &fb);
+    return page_resume(root, entering, entering_snapshot, &fb);
+}
+
+void setUp(void)
+{
+    fb = (Framebuffer){.pixels = pixels, .width = FB_WIDTH, .height = FB_HEIGHT};
+    framebuffer_clear(&fb, COLOR_BLACK);
+    page_snapshot_init(&snapshot_a, runs_a, sizeof(runs_a));
+    page_snapshot_init(&snapshot_b, runs_b, sizeof(runs_b));
+
+    root = container_create(0, 0, FB_WIDTH, FB_HEIGHT, LAYOUT_TYPE_NONE);
+    page_a = container_create(0, 0, FB_WIDTH, FB_HEIGHT, LAYOUT_TYPE_NONE);
+    page_b = container_create(0, 0, FB_WIDTH, FB_HEIGHT, LAYOUT_TYPE_NONE);
+    container_add_child(page_a, make_block(0, 2, 2, 6, COLOR_RED));
+    container_add_child(page_a, make_block(1, 20, 10, 6, COLOR_GREEN));
+    container_add_child(page_b, make_block(2, 10, 10, 8, COLOR_BLUE));
+    container_add_child(root, page_a);
+}
+
+void tearDown(void)
+{
+    Widget *suspended = page_a->parent ? page_b : page_a;
+    widget_destroy(suspended);
+    free(suspended);
+    widget_destroy(root);
+    free(root);
+}
+
+void test_snapshot_restores_the_rect_it_captured(void)
+{
+    for (int i = 0; i < FB_WIDTH * FB_HEIGHT; i++)
+        pixels[i] = COLOR_RGB(i % FB_WIDTH * 5, i / FB_WIDTH * 5, 0);
+
+    TEST_ASSERT_TRUE(page_snapshot_capture(&snapshot_a, &fb, 3, 4, 10, 5));
+    framebuffer_clear(&fb, COLOR_BLACK);
+    TEST_ASSERT_TRUE(page_snapshot_restore(&snapshot_a, &fb));
+
+    for (int y = 4; y < 9; y++)
+    {
+        for (int x = 3; x < 13; x++)
+            TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_RGB(x * 5, y * 5, 0), pixel_at(x, y)));
+    }
+    TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_BLACK, pixel_at(13, 4)));
+    TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_BLACK, pixel_at(3, 9)));
+}
+
+void test_snapshot_runs_carry_on_across_rows(void)
+{
+    renderFilledRectangle(0, 10, FB_WIDTH, 2, COLOR_RED, &fb);
+
+    TEST_ASSERT_TRUE(page_snapshot_capture(&snapshot_a, &fb, 0, 0, FB_WIDTH, FB_HEIGHT));
+
+    TEST_ASSERT_EQUAL_INT(3, (int)snapshot_a.run_count);
+    TEST_ASSERT_EQUAL_INT(FB_WIDTH * 10, snapshot_a.runs[0].length);
+    TEST_ASSERT_EQUAL_INT(FB_WIDTH * 2, snapshot_a.runs[1].length);
+}
+
+void test_snapshot_that_does_not_fit_is_invalid(void)
+{
+    PageSnapshot small;
+    page_snapshot_init(&small, runs_a, sizeof(SnapshotRun) * 2);
+    renderFilledRectangle(5, 5, 2, 2, COLOR_RED, &fb);
+
+    TEST_ASSERT_FALSE(page_snapshot_capture(&small, &fb, 0, 0, FB_WIDTH, FB_HEIGHT));
+    TEST_ASSERT_FALSE(page_snapshot_restore(&small, &fb));
+    TEST_ASSERT_FALSE(page_snapshot_capture(&snapshot_a, &fb, -1, 0, 4, 4));
+}
+
+void test_resume_without_snapshot_clears_and_draws_everything(void)
+{
+    frame();
+
+    TEST_ASSERT_FALSE(swap(page_a, &snapshot_a, page_b, &snapshot_b));
+    frame();
+
+    TEST_ASSERT_TRUE(snapshot_a.valid);
+    TEST_ASSERT_EQUAL_INT(1, blocks[2].renders);
+    TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_BLACK, pixel_at(3, 3)));
+    TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_BLUE, pixel_at(12, 12)));
+}
+
+void test_resume_from_snapshot_draws_nothing_that_did_not_change(void)
+{
+    frame();
+    swap(page_a, &snapshot_a, page_b, &snapshot_b);
+    frame();
+    int renders = total_renders();
+
+    TEST_ASSERT_TRUE(swap(page_b, &snapshot_b, page_a, &snapshot_a));
+    frame();
+
+    TEST_ASSERT_EQUAL_INT(renders, total_renders());
+    TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_RED, pixel_at(3, 3)));
+    TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_GREEN, pixel_at(21, 11)));
+    TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_BLACK, pixel_at(12, 12)));
+}
+
+void test_changes_to_a_suspended_page_are_drawn_when_it_resumes(void)
+{
+    frame();
+    swap(page_a, &snapshot_a, page_b, &snapshot_b);
+    frame();
+
+    blocks[0].color = COLOR_WHITE;
+    widget_mark_dirty(&block_widgets[0]);
+    widget_set_position(&block_widgets[1], 30, 20);
+    TEST_ASSERT_FALSE(root->dirty);
+
+    swap(page_b, &snapshot_b, page_a, &snapshot_a);
+    frame();
+
+    TEST_ASSERT_EQUAL_INT(2, blocks[0].renders);
+    TEST_ASSERT_EQUAL_INT(2, blocks[1].renders);
+    TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_WHITE, pixel_at(3, 3)));
+    TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_BLACK, pixel_at(21, 11)));
+    TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_GREEN, pixel_at(31, 21)));
+}
+
+void test_suspending_a_page_never_drawn_invalidates_its_snapshot(void)
+{
+    snapshot_a.valid = true;
+
+    page_suspend(page_a, &snapshot_a, &fb);
+
+    TEST_ASSERT_FALSE(snapshot_a.valid);
+    TEST_ASSERT_NULL(page_a->parent);
+    TEST_ASSERT_EQUAL_INT(0, container_get_child_count(root));
+    TEST_ASSERT_TRUE(page_resume(root, page_a, NULL, &fb) == false && page_a->parent == root);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_snapshot_restores_the_rect_it_captured);
+    RUN_TEST(test_snapshot_runs_carry_on_across_rows);
+    RUN_TEST(test_snapshot_that_does_not_fit_is_invalid);
+    RUN_TEST(test_resume_without_snapshot_clears_and_draws_everything);
+    RUN_TEST(test_resume_from_snapshot_draws_nothing_that_did_not_change);
+    RUN_TEST(test_changes_to_a_suspended_page_are_drawn_when_it_resumes);
+    RUN_TEST(test_suspending_a_page_never_drawn_invalidates_its_snapshot);
+    return UNITY_END();
+}
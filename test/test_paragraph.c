@@ -0,0 +1,255 @@
+#include "framebuffer.h"
+#include "unity.h"
+#include "primitives/rectangle.h"
+#include "widgets/container.h"
+#include "widgets/paragraph.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define FB_WIDTH 60
+#define FB_HEIGHT 40
+#define GLYPH_ADVANCE 4
+#define LINE_HEIGHT 5
+
+// Every letter is a solid 3x5 block followed by one blank column
+static const unsigned int block_rows[LINE_HEIGHT] = {0xE0, 0xE0, 0xE0, 0xE0, 0xE0};
+static bdf_char_t glyphs[27];
+static bdf_font_t test_font = {glyphs, 27};
+static bdf_char_t wide_glyphs[27];
+static bdf_font_t wide_font = {wide_glyphs, 27};
+
+static Color pixels[FB_WIDTH * FB_HEIGHT];
+static Framebuffer fb;
+static Widget *paragraph;
+
+static Color pixel_at(int x, int y)
+{
+    return pixels[y * FB_WIDTH + x];
+}
+
+static void render_frame(void)
+{
+    widget_handle_dirty(paragraph, &fb);
+    framebuffer_clear_dirty_rects(&fb, COLOR_BLACK);
+    widget_render(paragraph, &fb);
+}
+
+void setUp(void)
+{
+    for (int i = 0; i < 26; i++)
+    {
+        glyphs[i] = (bdf_char_t){'a' + i, GLYPH_ADVANCE, 3, LINE_HEIGHT, 0, 0, block_rows};
+        wide_glyphs[i] = glyphs[i];
+        wide_glyphs[i].width = GLYPH_ADVANCE * 2;
+    }
+    glyphs[26] = (bdf_char_t){' ', GLYPH_ADVANCE, 0, 0, 0, 0, block_rows};
+    wide_glyphs[26] = glyphs[26];
+
+    fb = (Framebuffer){.pixels = pixels, .width = FB_WIDTH, .height = FB_HEIGHT};
+    framebuffer_clear(&fb, COLOR_BLACK);
+    paragraph = paragraph_create(0, 0, 40, 30, "hello world foo", &test_font);
+}
+
+void tearDown(void)
+{
+    widget_destroy(paragraph);
+    free(paragraph);
+}
+
+void test_paragraph_wraps_at_word_boundaries(void)
+{
+    ParagraphData *data = (ParagraphData *)widget_data(paragraph);
+
+    TEST_ASSERT_EQUAL_INT(2, paragraph_get_line_count(paragraph));
+    TEST_ASSERT_EQUAL_INT(5, data->lines[0].length);
+    TEST_ASSERT_EQUAL_INT(20, data->lines[0].width);
+    TEST_ASSERT_EQUAL_INT(6, data->lines[1].start);
+    TEST_ASSERT_EQUAL_INT(9, data->lines[1].length);
+}
+
+void test_paragraph_breaks_at_newlines_and_inside_long_words(void)
+{
+    paragraph_set_text(paragraph, "abcdefghijklmn\nab");
+    ParagraphData *data = (ParagraphData *)widget_data(paragraph);
+
+    TEST_ASSERT_EQUAL_INT(3, paragraph_get_line_count(paragraph));
+    TEST_ASSERT_EQUAL_INT(10, data->lines[0].length);
+    TEST_ASSERT_EQUAL_INT(4, data->lines[1].length);
+    TEST_ASSERT_EQUAL_INT(15, data->lines[2].start);
+}
+
+void test_paragraph_breaks_again_only_when_width_or_font_changes(void)
+{
+    ParagraphData *data = (ParagraphData *)widget_data(paragraph);
+    render_frame();
+    TEST_ASSERT_EQUAL_INT(40, data->wrap_width);
+
+    paragraph_set_color(paragraph, COLOR_RED);
+    TEST_ASSERT_EQUAL_INT(40, data->wrap_width);
+
+    widget_set_size(paragraph, 60, 30);
+    TEST_ASSERT_EQUAL_INT(1, paragraph_get_line_count(paragraph));
+
+    paragraph_set_font(paragraph, &wide_font);
+    TEST_ASSERT_EQUAL_INT(-1, data->wrap_width);
+    TEST_ASSERT_EQUAL_INT(3, paragraph_get_line_count(paragraph));
+}
+
+void test_paragraph_renders_each_line_below_the_last(void)
+{
+    render_frame();
+
+    TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_WHITE, pixel_at(0, 0)));
+    TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_WHITE, pixel_at(18, 4)));
+    TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_BLACK, pixel_at(20, 0)));
+    TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_WHITE, pixel_at(34, 5)));
+    TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_BLACK, pixel_at(0, 10)));
+}
+
+void test_paragraph_repaints_only_changed_lines(void)
+{
+    render_frame();
+
+    // A marker in the first line survives only if that line is neither cleared nor drawn again
+    pixels[3] = COLOR_RED;
+    paragraph_set_text(paragraph, "hello there foo");
+    widget_handle_dirty(paragraph, &fb);
+
+    TEST_ASSERT_EQUAL_INT(1, fb.dirty_rect_count);
+    TEST_ASSERT_EQUAL_INT(LINE_HEIGHT, fb.dirty_rects[0].y);
+    TEST_ASSERT_EQUAL_INT(LINE_HEIGHT, fb.dirty_rects[0].height);
+
+    framebuffer_clear_dirty_rects(&fb, COLOR_BLACK);
+    widget_render(paragraph, &fb);
+
+    TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_RED, pixel_at(3, 0)));
+    TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_WHITE, pixel_at(34, 5)));
+}
+
+void test_paragraph_clears_lines_removed_from_the_end(void)
+{
+    paragraph_set_text(paragraph, "ab\ncd\nef");
+    render_frame();
+
+    paragraph_set_text(paragraph, "ab");
+    widget_handle_dirty(paragraph, &fb);
+
+    TEST_ASSERT_EQUAL_INT(1, fb.dirty_rect_count);
+    TEST_ASSERT_EQUAL_INT(LINE_HEIGHT, fb.dirty_rects[0].y);
+    TEST_ASSERT_EQUAL_INT(LINE_HEIGHT * 2, fb.dirty_rects[0].height);
+
+    framebuffer_clear_dirty_rects(&fb, COLOR_BLACK);
+    widget_render(paragraph, &fb);
+
+    TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_WHITE, pixel_at(0, 0)));
+    TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_BLACK, pixel_at(0, 5)));
+    TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_BLACK, pixel_at(0, 10)));
+}
+
+void test_paragraph_text_that_wraps_the_same_is_not_repainted(void)
+{
+    render_frame();
+
+    paragraph_set_text(paragraph, "hello\nworld foo");
+
+    TEST_ASSERT_FALSE(paragraph->dirty);
+}
+
+void test_paragraph_clips_lines_to_its_height(void)
+{
+    widget_set_size(paragraph, 40, 8);
+    render_frame();
+
+    TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_WHITE, pixel_at(0, 7)));
+    TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_BLACK, pixel_at(0, 8)));
+}
+
+void test_paragraph_fit_height(void)
+{
+    paragraph_fit_height(paragraph);
+
+    TEST_ASSERT_EQUAL_INT(LINE_HEIGHT * 2, paragraph->height);
+}
+
+void test_paragraph_setters_ignore_other_widgets(void)
+{
+    Widget other;
+    widget_init(&other, WIDGET_TYPE_LABEL, 0, 0, 10, 10);
+
+    paragraph_set_text(&other, "text");
+    paragraph_set_font(NULL, &test_font);
+
+    TEST_ASSERT_NULL(paragraph_get_text(&other));
+    TEST_ASSERT_EQUAL_INT(0, paragraph_get_line_count(NULL));
+}
+
+static void cover_render(Widget *widget, Framebuffer *framebuffer)
+{
+    renderFilledRectangle(framebuffer->origin_x + widget->x, framebuffer->origin_y + widget->y, widget->width,
+                          widget->height, COLOR_RED, framebuffer);
+}
+
+static const WidgetVTable cover_vtable = {.render = cover_render};
+
+void test_paragraph_exposed_with_a_text_change_is_repainted_in_full(void)
+{
+    Widget *panel = container_create(0, 0, FB_WIDTH, FB_HEIGHT, LAYOUT_TYPE_NONE);
+    Widget *inner = paragraph_create(0, 0, 40, 30, "hello world foo", &test_font);
+    Widget *cover = widget_create(WIDGET_TYPE_LABEL, &cover_vtable, 0, 0, 0, 10, 4);
+    cover->opaque = true;
+    container_add_child(panel, inner);
+    container_add_child(panel, cover);
+
+    widget_handle_dirty(panel, &fb);
+    framebuffer_clear_dirty_rects(&fb, COLOR_BLACK);
+    widget_render(panel, &fb);
+    TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_RED, pixel_at(0, 0)));
+
+    paragraph_set_text(inner, "hello there foo");
+    widget_set_position(cover, 50, 30);
+    widget_handle_dirty(panel, &fb);
+    framebuffer_clear_dirty_rects(&fb, COLOR_BLACK);
+    widget_render(panel, &fb);
+
+    TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_WHITE, pixel_at(0, 0)));
+    TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_WHITE, pixel_at(34, 5)));
+
+    widget_destroy(panel);
+    free(panel);
+}
+
+void test_paragraph_refuses_text_longer_than_line_offsets(void)
+{
+    char *text = (char *)malloc(PARAGRAPH_MAX_TEXT_LENGTH + 2);
+    memset(text, 'a', PARAGRAPH_MAX_TEXT_LENGTH + 1);
+    text[PARAGRAPH_MAX_TEXT_LENGTH + 1] = '\0';
+
+    paragraph_set_text(paragraph, text);
+    TEST_ASSERT_EQUAL_STRING("hello world foo", paragraph_get_text(paragraph));
+    paragraph_set_static_text(paragraph, text);
+    TEST_ASSERT_EQUAL_STRING("hello world foo", paragraph_get_text(paragraph));
+
+    text[PARAGRAPH_MAX_TEXT_LENGTH] = '\0';
+    paragraph_set_text(paragraph, text);
+    TEST_ASSERT_EQUAL_INT(PARAGRAPH_MAX_TEXT_LENGTH, (int)strlen(paragraph_get_text(paragraph)));
+
+    free(text);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_paragraph_wraps_at_word_boundaries);
+    RUN_TEST(test_paragraph_breaks_at_newlines_and_inside_long_words);
+    RUN_TEST(test_paragraph_breaks_again_only_when_width_or_font_changes);
+    RUN_TEST(test_paragraph_renders_each_line_below_the_last);
+    RUN_TEST(test_paragraph_repaints_only_changed_lines);
+    RUN_TEST(test_paragraph_clears_lines_removed_from_the_end);
+    RUN_TEST(test_paragraph_text_that_wraps_the_same_is_not_repainted);
+    RUN_TEST(test_paragraph_clips_lines_to_its_height);
+    RUN_TEST(test_paragraph_fit_height);
+    RUN_TEST(test_paragraph_setters_ignore_other_widgets);
+    RUN_TEST(test_paragraph_exposed_with_a_text_change_is_repainted_in_full);
+    RUN_TEST(test_paragraph_refuses_text_longer_than_line_offsets);
+    return UNITY_END();
+}
@@ -0,0 +1,225 @@
+#include "render_cache.h"
+#include "unity.h"
+#include "widgets/button.h"
+#include "widgets/container.h"
+#include "widgets/image_widget.h"
+#include <stdlib.h>
+
+#define FB_SIZE 64
+
+static Color buffer[1024];
+static RenderCache cache;
+static Color pixels[FB_SIZE * FB_SIZE];
+static Framebuffer fb;
+static int render_count;
+
+static void count_render(Widget *widget, Framebuffer *framebuffer)
+{
+    render_count++;
+    int x = framebuffer->origin_x + widget->x;
+    int y = framebuffer->origin_y + widget->y;
+    FRAMEBUFFER_SET_PIXEL(framebuffer, x, y, COLOR_RED);
+}
+
+static const WidgetVTable counting_vtable = {.render = count_render};
+
+static Widget *cached_widget_create(int x, int y, int width, int height)
+{
+    Widget *widget = widget_create(WIDGET_TYPE_IMAGE, &counting_vtable, 0, x, y, width, height);
+    widget_set_cached(widget, true);
+    return widget;
+}
+
+static void destroy(Widget *widget)
+{
+    widget_destroy(widget);
+    free(widget);
+}
+
+void setUp(void)
+{
+    render_cache_init(&cache, buffer, sizeof(buffer));
+    render_cache_set_active(&cache);
+    fb = (Framebuffer){.pixels = pixels, .width = FB_SIZE, .height = FB_SIZE};
+    framebuffer_clear(&fb, COLOR_BLACK);
+    render_count = 0;
+}
+
+void tearDown(void)
+{
+    render_cache_set_active(NULL);
+}
+
+void test_render_cache_moved_widget_is_copied(void)
+{
+    Widget *widget = cached_widget_create(4, 4, 8, 8);
+
+    widget_render(widget, &fb);
+    widget_set_position(widget, 20, 10);
+    widget_render(widget, &fb);
+
+    TEST_ASSERT_EQUAL_INT(1, render_count);
+    TEST_ASSERT_EQUAL_INT(1, cache.misses);
+    TEST_ASSERT_EQUAL_INT(1, cache.hits);
+    TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_RED, pixels[10 * FB_SIZE + 20]));
+
+    destroy(widget);
+}
+
+void test_render_cache_skips_pixels_widget_left_untouched(void)
+{
+    Widget *widget = cached_widget_create(0, 0, 8, 8);
+
+    widget_render(widget, &fb);
+    pixels[2 * FB_SIZE + 2] = COLOR_BLUE;
+    widget_set_position(widget, 1, 1);
+    widget_render(widget, &fb);
+
+    TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_RED, pixels[FB_SIZE + 1]));
+    TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_BLUE, pixels[2 * FB_SIZE + 2]));
+
+    destroy(widget);
+}
+
+void test_render_cache_content_change_recaptures(void)
+{
+    Widget *widget = cached_widget_create(0, 0, 8, 8);
+
+    widget_render(widget, &fb);
+    widget_mark_dirty(widget);
+    widget_render(widget, &fb);
+
+    TEST_ASSERT_EQUAL_INT(2, render_count);
+    TEST_ASSERT_EQUAL_INT(1, cache.entry_count);
+
+    widget_set_size(widget, 4, 4);
+    widget_render(widget, &fb);
+
+    TEST_ASSERT_EQUAL_INT(3, render_count);
+    TEST_ASSERT_EQUAL_INT(16, cache.used);
+
+    destroy(widget);
+}
+
+void test_render_cache_background_change_recaptures(void)
+{
+    Widget *widget = cached_widget_create(0, 0, 8, 8);
+
+    widget_render(widget, &fb);
+    framebuffer_clear(&fb, COLOR_WHITE);
+    widget->dirty = true;
+    widget_render(widget, &fb);
+
+    TEST_ASSERT_EQUAL_INT(2, render_count);
+
+    destroy(widget);
+}
+
+void test_render_cache_evicts_least_recently_drawn(void)
+{
+    Widget *first = cached_widget_create(0, 0, 16, 24);
+    Widget *second = cached_widget_create(0, 0, 16, 24);
+    Widget *third = cached_widget_create(0, 0, 16, 24);
+
+    widget_render(first, &fb);
+    widget_render(second, &fb);
+    first->dirty = true;
+    widget_render(first, &fb);
+    widget_render(third, &fb);
+
+    TEST_ASSERT_EQUAL_INT(1, cache.evictions);
+    TEST_ASSERT_EQUAL_INT(2, cache.entry_count);
+    TEST_ASSERT_EQUAL_INT(768, cache.used);
+
+    render_count = 0;
+    first->dirty = true;
+    widget_render(first, &fb);
+    TEST_ASSERT_EQUAL_INT(0, render_count);
+
+    destroy(first);
+    destroy(second);
+    destroy(third);
+}
+
+void test_render_cache_widget_larger_than_budget_draws_directly(void)
+{
+    Widget *widget = cached_widget_create(0, 0, 40, 40);
+
+    widget_render(widget, &fb);
+    widget->dirty = true;
+    widget_render(widget, &fb);
+
+    TEST_ASSERT_EQUAL_INT(2, render_count);
+    TEST_ASSERT_EQUAL_INT(0, cache.entry_count);
+
+    destroy(widget);
+}
+
+void test_render_cache_destroy_releases_surface(void)
+{
+    Widget *first = cached_widget_create(0, 0, 8, 8);
+    Widget *second = cached_widget_create(0, 0, 4, 4);
+
+    widget_render(first, &fb);
+    widget_render(second, &fb);
+    destroy(first);
+
+    TEST_ASSERT_EQUAL_INT(1, cache.entry_count);
+    TEST_ASSERT_EQUAL_INT(16, cache.used);
+    TEST_ASSERT_EQUAL_INT(0, cache.entries[0].offset);
+
+    destroy(second);
+    TEST_ASSERT_EQUAL_INT(0, cache.used);
+}
+
+void test_render_cache_blends_image_over_background_once(void)
+{
+    static const Color image_data[] = {{0x80, 0xFF, 0xFF, 0xFF}, {0x00, 0x00, 0x00, 0x00}};
+    static const Image image = {.data = image_data, .width = 2, .height = 1};
+    Widget *widget = image_widget_create(0, 0, &image);
+    widget_set_cached(widget, true);
+
+    widget_render(widget, &fb);
+    widget_set_position(widget, 10, 10);
+    widget_render(widget, &fb);
+
+    Color blended = pixels[10 * FB_SIZE + 10];
+    TEST_ASSERT_EQUAL_INT(0xFF, blended.a);
+    TEST_ASSERT_EQUAL_INT(0x80, blended.r);
+    TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_BLACK, pixels[10 * FB_SIZE + 11]));
+    TEST_ASSERT_EQUAL_INT(1, cache.hits);
+
+    destroy(widget);
+}
+
+void test_render_cache_unused_without_active_cache(void)
+{
+    render_cache_set_active(NULL);
+    Widget *widget = cached_widget_create(0, 0, 8, 8);
+
+    widget_render(widget, &fb);
+    widget_set_position(widget, 2, 2);
+    widget_render(widget, &fb);
+
+    TEST_ASSERT_EQUAL_INT(2, render_count);
+    TEST_ASSERT_EQUAL_INT(0, cache.entry_count);
+
+    destroy(widget);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_render_cache_moved_widget_is_copied);
+    RUN_TEST(test_render_cache_skips_pixels_widget_left_untouched);
+    RUN_TEST(test_render_cache_content_change_recaptures);
+    RUN_TEST(test_render_cache_background_change_recaptures);
+    RUN_TEST(test_render_cache_evicts_least_recently_drawn);
+    RUN_TEST(test_render_cache_widget_larger_than_budget_draws_directly);
+    RUN_TEST(test_render_cache_destroy_releases_surface);
+    RUN_TEST(test_render_cache_blends_image_over_background_once);
+    RUN_TEST(test_render_cache_unused_without_active_cache);
+
+    return UNITY_END();
+}
@@ -0,0 +1,159 @@
+#include "stroke_log.h"
+#include "unity.h"
+#include <string.h>
+
+static uint8_t buffer[64];
+static StrokeLog log;
+
+void setUp(void)
+{
+    memset(buffer, 0, sizeof(buffer));
+    stroke_log_init(&log, buffer, sizeof(buffer), 224, 224);
+}
+
+void tearDown(void)
+{
+}
+
+void test_stroke_log_init(void)
+{
+    TEST_ASSERT_EQUAL_PTR(buffer, log.buffer);
+    TEST_ASSERT_EQUAL_INT(64, log.capacity);
+    TEST_ASSERT_EQUAL_INT(0, log.length);
+    TEST_ASSERT_EQUAL_INT(224, log.width);
+    TEST_ASSERT_EQUAL_INT(224, log.height);
+    TEST_ASSERT_FALSE(log.pen_down);
+    TEST_ASSERT_FALSE(log.overflow);
+}
+
+void test_stroke_log_round_trip(void)
+{
+    TEST_ASSERT_TRUE(stroke_log_pen_down(&log, 10, 20));
+    TEST_ASSERT_TRUE(stroke_log_move(&log, 12, 19));
+    TEST_ASSERT_TRUE(stroke_log_move(&log, 200, 3));
+    TEST_ASSERT_TRUE(stroke_log_pen_up(&log));
+    TEST_ASSERT_TRUE(stroke_log_pen_down(&log, 5, 5));
+    TEST_ASSERT_TRUE(stroke_log_pen_up(&log));
+
+    StrokeLogReader reader;
+    stroke_log_reader_init(&reader, log.buffer, log.length);
+
+    StrokeOp expected_ops[] = {STROKE_OP_PEN_DOWN, STROKE_OP_MOVE,     STROKE_OP_MOVE,
+                               STROKE_OP_PEN_UP,   STROKE_OP_PEN_DOWN, STROKE_OP_PEN_UP};
+    int expected_x[] = {10, 12, 200, 200, 5, 5};
+    int expected_y[] = {20, 19, 3, 3, 5, 5};
+
+    StrokeOp op;
+    int x, y;
+    for (int i = 0; i < 6; i++)
+    {
+        TEST_ASSERT_TRUE(stroke_log_read(&reader, &op, &x, &y));
+        TEST_ASSERT_EQUAL_INT(expected_ops[i], op);
+        TEST_ASSERT_EQUAL_INT(expected_x[i], x);
+        TEST_ASSERT_EQUAL_INT(expected_y[i], y);
+    }
+
+    TEST_ASSERT_FALSE(stroke_log_read(&reader, &op, &x, &y));
+}
+
+void test_stroke_log_small_moves_take_two_bytes(void)
+{
+    stroke_log_pen_down(&log, 100, 100);
+    int before = log.length;
+
+    stroke_log_move(&log, 103, 98);
+
+    TEST_ASSERT_EQUAL_INT(2, log.length - before);
+}
+
+void test_stroke_log_skips_repeated_points(void)
+{
+    stroke_log_pen_down(&log, 100, 100);
+    int before = log.length;
+
+    TEST_ASSERT_TRUE(stroke_log_move(&log, 100, 100));
+
+    TEST_ASSERT_EQUAL_INT(before, log.length);
+}
+
+void test_stroke_log_move_without_pen_down_is_ignored(void)
+{
+    TEST_ASSERT_FALSE(stroke_log_move(&log, 10, 10));
+    TEST_ASSERT_FALSE(stroke_log_pen_up(&log));
+    TEST_ASSERT_EQUAL_INT(0, log.length);
+}
+
+void test_stroke_log_overflow_keeps_stream_closed(void)
+{
+    stroke_log_init(&log, buffer, 8, 224, 224);
+
+    stroke_log_pen_down(&log, 0, 0);
+    for (int i = 1; i < 20; i++)
+    {
+        stroke_log_move(&log, i * 5, i * 5);
+    }
+
+    TEST_ASSERT_TRUE(log.overflow);
+    TEST_ASSERT_TRUE(stroke_log_pen_up(&log));
+    TEST_ASSERT_TRUE(log.length <= 8);
+    TEST_ASSERT_FALSE(stroke_log_pen_down(&log, 1, 1));
+
+    StrokeLogReader reader;
+    stroke_log_reader_init(&reader, log.buffer, log.length);
+
+    StrokeOp op = STROKE_OP_MOVE;
+    int x, y;
+    while (stroke_log_read(&reader, &op, &x, &y))
+    {
+    }
+    TEST_ASSERT_EQUAL_INT(STROKE_OP_PEN_UP, op);
+}
+
+void test_stroke_log_reset(void)
+{
+    stroke_log_pen_down(&log, 10, 10);
+    stroke_log_reset(&log);
+
+    TEST_ASSERT_EQUAL_INT(0, log.length);
+    TEST_ASSERT_FALSE(log.pen_down);
+    TEST_ASSERT_FALSE(log.overflow);
+}
+
+void test_stroke_log_reader_rejects_truncated_data(void)
+{
+    uint8_t truncated[] = {0x81};
+
+    StrokeLogReader reader;
+    stroke_log_reader_init(&reader, truncated, sizeof(truncated));
+
+    StrokeOp op;
+    int x, y;
+    TEST_ASSERT_FALSE(stroke_log_read(&reader, &op, &x, &y));
+}
+
+void test_stroke_log_with_null(void)
+{
+    stroke_log_init(NULL, buffer, 8, 1, 1);
+    stroke_log_reset(NULL);
+    TEST_ASSERT_FALSE(stroke_log_pen_down(NULL, 0, 0));
+    TEST_ASSERT_FALSE(stroke_log_move(NULL, 0, 0));
+    TEST_ASSERT_FALSE(stroke_log_pen_up(NULL));
+    TEST_ASSERT_FALSE(stroke_log_read(NULL, NULL, NULL, NULL));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_stroke_log_init);
+    RUN_TEST(test_stroke_log_round_trip);
+    RUN_TEST(test_stroke_log_small_moves_take_two_bytes);
+    RUN_TEST(test_stroke_log_skips_repeated_points);
+    RUN_TEST(test_stroke_log_move_without_pen_down_is_ignored);
+    RUN_TEST(test_stroke_log_overflow_keeps_stream_closed);
+    RUN_TEST(test_stroke_log_reset);
+    RUN_TEST(test_stroke_log_reader_rejects_truncated_data);
+    RUN_TEST(test_stroke_log_with_null);
+
+    return UNITY_END();
+}
@@ -0,0 +1,176 @@
+#include "timeline.h"
+#include "unity.h"
+#include "widgets/button.h"
+#include "widgets/container.h"
+#include "widgets/label.h"
+#include <stdlib.h>
+
+static Timeline timeline;
+static Widget *widget;
+
+void setUp(void)
+{
+    timeline_init(&timeline);
+    widget = button_create(0, 0, 20, 20, "Tween");
+}
+
+void tearDown(void)
+{
+    widget_destroy(widget);
+    free(widget);
+}
+
+void test_timeline_add_applies_start_value(void)
+{
+    TEST_ASSERT_NOT_NULL(timeline_add(&timeline, widget, TWEEN_PROPERTY_X, 100, 0, 200, EASING_LINEAR));
+
+    TEST_ASSERT_EQUAL_INT(100, widget->x);
+    TEST_ASSERT_TRUE(timeline_is_running(&timeline));
+}
+
+void test_timeline_linear_position(void)
+{
+    timeline_add(&timeline, widget, TWEEN_PROPERTY_Y, 0, 100, 200, EASING_LINEAR);
+
+    timeline_update(&timeline, 50);
+    TEST_ASSERT_EQUAL_INT(25, widget->y);
+
+    timeline_update(&timeline, 100);
+    TEST_ASSERT_EQUAL_INT(75, widget->y);
+
+    timeline_update(&timeline, 100);
+    TEST_ASSERT_EQUAL_INT(100, widget->y);
+    TEST_ASSERT_FALSE(timeline_is_running(&timeline));
+}
+
+void test_timeline_easing_stays_within_range(void)
+{
+    timeline_add(&timeline, widget, TWEEN_PROPERTY_X, 0, 160, 160, EASING_IN);
+
+    timeline_update(&timeline, 40);
+    TEST_ASSERT_EQUAL_INT(10, widget->x);
+
+    timeline_add(&timeline, widget, TWEEN_PROPERTY_X, 0, 160, 160, EASING_OUT);
+    timeline_update(&timeline, 40);
+    TEST_ASSERT_EQUAL_INT(70, widget->x);
+
+    timeline_add(&timeline, widget, TWEEN_PROPERTY_X, 0, 160, 160, EASING_IN_OUT);
+    timeline_update(&timeline, 80);
+    TEST_ASSERT_EQUAL_INT(80, widget->x);
+}
+
+void test_timeline_only_touches_widget_when_value_changes(void)
+{
+    Widget *container = container_create(0, 0, 100, 100, LAYOUT_TYPE_NONE);
+    Widget *child = label_create(0, 0, "Slow");
+    container_add_child(container, child);
+    timeline_add(&timeline, child, TWEEN_PROPERTY_X, 0, 2, 1000, EASING_LINEAR);
+    child->dirty = false;
+    container->dirty = false;
+
+    timeline_update(&timeline, 100);
+    TEST_ASSERT_FALSE(child->dirty);
+    TEST_ASSERT_FALSE(container->dirty);
+
+    timeline_update(&timeline, 200);
+    TEST_ASSERT_EQUAL_INT(1, child->x);
+    TEST_ASSERT_TRUE(child->dirty);
+
+    widget_destroy(container);
+    free(container);
+}
+
+void test_timeline_color_interpolates_channels(void)
+{
+    timeline_add_color(&timeline, widget, COLOR_BLACK, COLOR_RGB(200, 100, 0), 100, EASING_LINEAR);
+    ButtonData *data = (ButtonData *)widget_data(widget);
+    TEST_ASSERT_TRUE(COLOR_COMPARE(COLOR_BLACK, data->background_color));
+
+    timeline_update(&timeline, 50);
+    TEST_ASSERT_EQUAL_INT(100, data->background_color.r);
+    TEST_ASSERT_EQUAL_INT(50, data->background_color.g);
+    TEST_ASSERT_EQUAL_INT(0, data->background_color.b);
+    TEST_ASSERT_EQUAL_INT(0xFF, data->background_color.a);
+}
+
+void test_timeline_delay_holds_start_value(void)
+{
+    Tween *tween = timeline_add(&timeline, widget, TWEEN_PROPERTY_X, 10, 20, 100, EASING_LINEAR);
+    tween_set_delay(tween, 50);
+
+    timeline_update(&timeline, 40);
+    TEST_ASSERT_EQUAL_INT(10, widget->x);
+
+    timeline_update(&timeline, 60);
+    TEST_ASSERT_EQUAL_INT(15, widget->x);
+}
+
+void test_timeline_yoyo_loop_returns_to_start(void)
+{
+    Tween *tween = timeline_add(&timeline, widget, TWEEN_PROPERTY_Y, 0, 10, 100, EASING_LINEAR);
+    tween_set_loop(tween, true);
+
+    timeline_update(&timeline, 150);
+    TEST_ASSERT_EQUAL_INT(5, widget->y);
+
+    timeline_update(&timeline, 50);
+    TEST_ASSERT_EQUAL_INT(0, widget->y);
+
+    timeline_update(&timeline, 1030);
+    TEST_ASSERT_EQUAL_INT(3, widget->y);
+    TEST_ASSERT_TRUE(timeline_is_running(&timeline));
+    TEST_ASSERT_TRUE(tween->elapsed_ms < 200);
+}
+
+void test_timeline_replaces_tween_on_same_property(void)
+{
+    timeline_add(&timeline, widget, TWEEN_PROPERTY_X, 0, 100, 100, EASING_LINEAR);
+    timeline_add(&timeline, widget, TWEEN_PROPERTY_X, 50, 60, 100, EASING_LINEAR);
+    timeline_add(&timeline, widget, TWEEN_PROPERTY_Y, 0, 10, 100, EASING_LINEAR);
+
+    int active = 0;
+    for (int i = 0; i < TIMELINE_MAX_TWEENS; i++)
+        active += timeline.tweens[i].active;
+    TEST_ASSERT_EQUAL_INT(2, active);
+
+    timeline_update(&timeline, 100);
+    TEST_ASSERT_EQUAL_INT(60, widget->x);
+}
+
+void test_timeline_full_pool_and_cancel(void)
+{
+    Widget *widgets[TIMELINE_MAX_TWEENS];
+    for (int i = 0; i < TIMELINE_MAX_TWEENS; i++)
+    {
+        widgets[i] = label_create(0, 0, "Tween");
+        TEST_ASSERT_NOT_NULL(timeline_add(&timeline, widgets[i], TWEEN_PROPERTY_X, 0, 10, 100, EASING_LINEAR));
+    }
+
+    TEST_ASSERT_NULL(timeline_add(&timeline, widget, TWEEN_PROPERTY_X, 0, 10, 100, EASING_LINEAR));
+
+    timeline_cancel(&timeline, widgets[3]);
+    TEST_ASSERT_NOT_NULL(timeline_add(&timeline, widget, TWEEN_PROPERTY_X, 0, 10, 100, EASING_LINEAR));
+
+    for (int i = 0; i < TIMELINE_MAX_TWEENS; i++)
+    {
+        widget_destroy(widgets[i]);
+        free(widgets[i]);
+    }
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_timeline_add_applies_start_value);
+    RUN_TEST(test_timeline_linear_position);
+    RUN_TEST(test_timeline_easing_stays_within_range);
+    RUN_TEST(test_timeline_only_touches_widget_when_value_changes);
+    RUN_TEST(test_timeline_color_interpolates_channels);
+    RUN_TEST(test_timeline_delay_holds_start_value);
+    RUN_TEST(test_timeline_yoyo_loop_returns_to_start);
+    RUN_TEST(test_timeline_replaces_tween_on_same_property);
+    RUN_TEST(test_timeline_full_pool_and_cancel);
+
+    return UNITY_END();
+}
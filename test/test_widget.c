@@ -33,10 +33,9 @@ void test_widget_initialization(void)
     TEST_ASSERT_TRUE(widget->enabled);
     TEST_ASSERT_NULL(widget->parent);
     TEST_ASSERT_NULL(widget->on_click);
-    TEST_ASSERT_NULL(widget->render);
-    TEST_ASSERT_NULL(widget->destroy);
+    TEST_ASSERT_NULL(widget->vtable);
     TEST_ASSERT_NULL(widget->user_data);
-    TEST_ASSERT_NULL(widget->data);
+    TEST_ASSERT_NULL(widget_data(widget));
 }
 
 void test_widget_initialization_with_null(void)
@@ -298,10 +297,12 @@ static void test_render_callback(Widget *w, Framebuffer *fb)
     render_callback_called = true;
 }
 
+static const WidgetVTable render_vtable = {.render = test_render_callback};
+
 void test_widget_render_calls_callback(void)
 {
     widget_init(widget, WIDGET_TYPE_LABEL, 10, 20, 100, 50);
-    widget->render = test_render_callback;
+    widget->vtable = &render_vtable;
     widget->dirty = true;
 
     Framebuffer fb = {0};
@@ -316,7 +317,7 @@ void test_widget_render_calls_callback(void)
 void test_widget_render_stores_prev_geometry(void)
 {
     widget_init(widget, WIDGET_TYPE_LABEL, 10, 20, 100, 50);
-    widget->render = test_render_callback;
+    widget->vtable = &render_vtable;
     widget->dirty = true;
 
     Framebuffer fb = {0};
@@ -332,7 +333,7 @@ void test_widget_render_stores_prev_geometry(void)
 void test_widget_render_skips_if_not_dirty(void)
 {
     widget_init(widget, WIDGET_TYPE_LABEL, 10, 20, 100, 50);
-    widget->render = test_render_callback;
+    widget->vtable = &render_vtable;
     widget->dirty = false;
 
     Framebuffer fb = {0};
@@ -346,7 +347,7 @@ void test_widget_render_skips_if_not_dirty(void)
 void test_widget_render_skips_if_not_visible(void)
 {
     widget_init(widget, WIDGET_TYPE_LABEL, 10, 20, 100, 50);
-    widget->render = test_render_callback;
+    widget->vtable = &render_vtable;
     widget->dirty = true;
     widget->visible = false;
 
@@ -377,10 +378,12 @@ static void test_dirty_callback(Widget *w, Framebuffer *fb)
     dirty_callback_called = true;
 }
 
+static const WidgetVTable dirty_vtable = {.on_dirty = test_dirty_callback};
+
 void test_widget_handle_dirty_calls_callback(void)
 {
     widget_init(widget, WIDGET_TYPE_LABEL, 10, 20, 100, 50);
-    widget->on_dirty = test_dirty_callback;
+    widget->vtable = &dirty_vtable;
     widget->dirty = true;
 
     Framebuffer fb = {0};
@@ -395,7 +398,7 @@ void test_widget_handle_dirty_calls_callback(void)
 void test_widget_handle_dirty_without_callback(void)
 {
     widget_init(widget, WIDGET_TYPE_LABEL, 10, 20, 100, 50);
-    widget->on_dirty = NULL;
+    widget->vtable = NULL;
     widget->dirty = true;
     widget->prev_x = 5;
     widget->prev_y = 10;
@@ -417,7 +420,7 @@ void test_widget_handle_dirty_without_callback(void)
 void test_widget_handle_dirty_skips_if_not_dirty(void)
 {
     widget_init(widget, WIDGET_TYPE_LABEL, 10, 20, 100, 50);
-    widget->on_dirty = test_dirty_callback;
+    widget->vtable = &dirty_vtable;
     widget->dirty = false;
 
     Framebuffer fb = {0};
@@ -441,10 +444,12 @@ static void test_destroy_callback(Widget *w)
     destroy_callback_called = true;
 }
 
+static const WidgetVTable destroy_vtable = {.destroy = test_destroy_callback};
+
 void test_widget_destroy_calls_callback(void)
 {
     widget_init(widget, WIDGET_TYPE_LABEL, 10, 20, 100, 50);
-    widget->destroy = test_destroy_callback;
+    widget->vtable = &destroy_vtable;
 
     destroy_callback_called = false;
 
@@ -453,14 +458,26 @@ void test_widget_destroy_calls_callback(void)
     TEST_ASSERT_TRUE(destroy_callback_called);
 }
 
-void test_widget_destroy_frees_data(void)
+void test_widget_create_places_data_inline(void)
 {
-    widget_init(widget, WIDGET_TYPE_LABEL, 10, 20, 100, 50);
-    widget->data = malloc(100);
+    Widget *created = widget_create(WIDGET_TYPE_LABEL, &destroy_vtable, 100, 10, 20, 100, 50);
 
-    widget_destroy(widget);
+    uint8_t *data = (uint8_t *)widget_data(created);
+    TEST_ASSERT_EQUAL_PTR((uint8_t *)created + sizeof(Widget), data);
+    TEST_ASSERT_EQUAL_UINT8(0, data[0]);
+    TEST_ASSERT_EQUAL_UINT8(0, data[99]);
+    TEST_ASSERT_EQUAL_PTR(&destroy_vtable, created->vtable);
+    TEST_ASSERT_EQUAL_INT(10, created->x);
 
-    TEST_ASSERT_NULL(widget->data);
+    destroy_callback_called = false;
+    widget_destroy(created);
+    TEST_ASSERT_TRUE(destroy_callback_called);
+    free(created);
+}
+
+void test_widget_fits_in_cache_line(void)
+{
+    TEST_ASSERT_TRUE(sizeof(Widget) <= 64);
 }
 
 void test_widget_destroy_with_null(void)
@@ -509,7 +526,8 @@ int main(void)
     RUN_TEST(test_widget_handle_dirty_skips_if_not_dirty);
     RUN_TEST(test_widget_handle_dirty_with_null_widget);
     RUN_TEST(test_widget_destroy_calls_callback);
-    RUN_TEST(test_widget_destroy_frees_data);
+    RUN_TEST(test_widget_create_places_data_inline);
+    RUN_TEST(test_widget_fits_in_cache_line);
     RUN_TEST(test_widget_destroy_with_null);
 
     return UNITY_END();
@@ -0,0 +1,75 @@
+#!/usr/bin/env python3
+
+import re
+import subprocess
+import sys
+
+# Soft-float helpers from libgcc and the ARM EABI, and the libm functions the code could reach for
+FLOAT_SYMBOLS = re.compile(
+    r"^(__(add|sub|mul|div|neg)(sf|df|tf)3"
+    r"|__(fix|fixuns|float|floatun)[a-z]*(sf|df|tf|si|di)[a-z]*"
+    r"|__(extend|trunc)[a-z]+2"
+    r"|__(eq|ne|lt|le|gt|ge|un|cmp)(sf|df|tf)2"
+    r"|__aeabi_[fd][a-z0-9]+|__aeabi_[a-z0-9]+2[fd]"
+    r"|(a?sin|a?cos|a?tan|atan2|sqrt|pow|exp|log|log10|floor|ceil|fabs|fmod|round|lround)[fl]?)$"
+)
+
+# Hardware float compiles inline, with no helper to reference: SSE/AVX scalar and packed float arithmetic,
+# conversions and compares, x87, and VFP/NEON. Plain SSE moves are left out; they also copy integer data.
+FLOAT_INSTRUCTIONS = re.compile(
+    r"^(v?(add|sub|mul|div|min|max|sqrt|rcp|rsqrt|round|hadd|hsub|dp|fn?m(add|sub)[0-9]*)(ss|sd|ps|pd)"
+    r"|v?cvt[a-z0-9]*(ss|sd|ps|pd)[a-z0-9]*|v?u?comis[sd]|v?cmp[a-z]*(ss|sd|ps|pd)"
+    r"|f(add|sub|subr|mul|div|divr|ld|st|stp|ild|ist|istp|isttp|sqrt|sin|cos|com|comp|ucomi|comi|chs|abs)p?"
+    r"|v[a-z]+\.f(16|32|64)(\.[a-z0-9]+)?|vcvt[a-z]*\.[a-z0-9.]+)$"
+)
+
+
+def undefined_symbols(nm, library):
+    output = subprocess.run([nm, "-u", library], check=True, capture_output=True, text=True).stdout
+    for line in output.splitlines():
+        fields = line.split()
+        if len(fields) >= 2 and fields[-2] == "U":
+            yield fields[-1]
+
+
+def instructions(objdump, library):
+    output = subprocess.run([objdump, "-d", library], check=True, capture_output=True, text=True).stdout
+    function = None
+    for line in output.splitlines():
+        header = re.match(r"^[0-9a-f]+ <(.+)>:$", line)
+        if header:
+            function = header.group(1)
+            continue
+
+        fields = line.split("\t")
+        if len(fields) >= 3 and fields[2].strip():
+            yield function, fields[2].split()[0]
+
+
+def main():
+    if len(sys.argv) < 4:
+        print(f"usage: {sys.argv[0]} <nm> <objdump> <library>...", file=sys.stderr)
+        return 2
+
+    nm = sys.argv[1]
+    objdump = sys.argv[2]
+    found = False
+
+    for library in sys.argv[3:]:
+        for symbol in sorted(set(undefined_symbols(nm, library))):
+            if FLOAT_SYMBOLS.match(symbol):
+                print(f"{library}: references {symbol}")
+                found = True
+
+        reported = set()
+        for function, mnemonic in instructions(objdump, library):
+            if FLOAT_INSTRUCTIONS.match(mnemonic) and (function, mnemonic) not in reported:
+                print(f"{library}: {function} uses {mnemonic}")
+                reported.add((function, mnemonic))
+                found = True
+
+    return 1 if found else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
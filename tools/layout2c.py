@@ -0,0 +1,431 @@
+#!/usr/bin/env python3
+"""Turn a JSON layout description into a C header holding a prelaid-out widget tree.
+
+The header defines a const image of the tree, which can stay in flash, and a RAM copy that the generated
+<name>_load() fills with one memcpy. The widgets, their data and the container child arrays are all static,
+so loading allocates nothing, and the geometry is computed here by the same box layout rules as container.c.
+Containers with an animation are left flagged for layout, since their offsets depend on the animation phase.
+"""
+import argparse
+import json
+import os
+import struct
+import sys
+
+from bdf2c import load_bdf
+
+ALIGNMENTS = {"start": "ALIGN_START", "center": "ALIGN_CENTER", "end": "ALIGN_END", "stretch": "ALIGN_STRETCH"}
+LAYOUTS = {"container": "LAYOUT_TYPE_NONE", "hbox": "LAYOUT_TYPE_HBOX", "vbox": "LAYOUT_TYPE_VBOX"}
+ANIMATIONS = {"none": "ANIMATION_NONE", "floating": "ANIMATION_FLOATING"}
+KINDS = {
+    "container": ("Container", "ContainerData", "WIDGET_TYPE_CONTAINER", "container_vtable"),
+    "button": ("Button", "ButtonData", "WIDGET_TYPE_BUTTON", "button_vtable"),
+    "label": ("Label", "LabelData", "WIDGET_TYPE_LABEL", "label_vtable"),
+    "image": ("Image", "ImageWidgetData", "WIDGET_TYPE_IMAGE", "image_widget_vtable"),
+}
+
+# Defaults of the matching *_create functions
+BUTTON_PADDING = 8
+BUTTON_BORDER_THICKNESS = 1
+
+
+def fail(message):
+    sys.exit(f"layout2c: {message}")
+
+
+def c_div(a, b):
+    """Integer division truncating toward zero, as in C."""
+    q = abs(a) // abs(b)
+    return q if (a >= 0) == (b >= 0) else -q
+
+
+def clamp_size(size, low, high):
+    if high > 0 and size > high:
+        size = high
+    if size < low:
+        size = low
+    return size
+
+
+class Font:
+    def __init__(self, path):
+        chars = load_bdf(path)
+        self.widths = {encoding: char.get("dwidth", 0) for encoding, char in chars.items()}
+        self.height = max((char.get("bbx", [0, 0])[1] for char in chars.values()), default=0)
+
+    def measure(self, text):
+        return sum(self.widths.get(ord(c), 0) for c in text)
+
+
+def bmp_size(path):
+    with open(path, "rb") as f:
+        header = f.read(26)
+    if header[:2] != b"BM":
+        fail(f"{path} is not a BMP file")
+    width, height = struct.unpack("<ii", header[18:26])
+    return width, abs(height)
+
+
+def c_color(value):
+    if value.startswith("#") and len(value) == 7:
+        r, g, b = (int(value[i:i + 2], 16) for i in (1, 3, 5))
+        return f"COLOR_RGB({r}, {g}, {b})"
+    return value
+
+
+def c_string(value):
+    return json.dumps(value)
+
+
+class Node:
+    def __init__(self, spec, ident, parent, assets):
+        self.spec = spec
+        self.id = spec.get("id", ident)
+        self.parent = parent
+        self.type = spec.get("type")
+        if self.type in LAYOUTS:
+            self.kind = "container"
+        elif self.type in KINDS:
+            self.kind = self.type
+        else:
+            fail(f"{self.id}: unsupported widget type {self.type!r}")
+
+        self.visible = spec.get("visible", True)
+        self.x = spec.get("x", 0)
+        self.y = spec.get("y", 0)
+        self.width = spec.get("width", 0)
+        self.height = spec.get("height", 0)
+        self.min_width = spec.get("min_width", 0)
+        self.min_height = spec.get("min_height", 0)
+        self.max_width = spec.get("max_width", 0)
+        self.max_height = spec.get("max_height", 0)
+        self.flex = spec.get("flex", 0)
+        self.padding = spec.get("padding", BUTTON_PADDING if self.kind == "button" else 0)
+        self.spacing = spec.get("spacing", 0)
+        self.alignment = spec.get("alignment", "start")
+        self.justify = spec.get("justify", "start")
+        self.animation = spec.get("animation", "none")
+        for key, table in (("alignment", ALIGNMENTS), ("justify", ALIGNMENTS), ("animation", ANIMATIONS)):
+            if getattr(self, key) not in table:
+                fail(f"{self.id}: unknown {key} {getattr(self, key)!r}")
+
+        self.auto_size(assets)
+        self.preferred_width = self.width
+        self.preferred_height = self.height
+
+        self.children = []
+        for index, child in enumerate(spec.get("children", [])):
+            if self.kind != "container":
+                fail(f"{self.id}: only containers have children")
+            self.children.append(Node(child, f"{self.id}_{index}", self, assets))
+
+    # Matches button_auto_size, label_auto_size and image_widget_create
+    def auto_size(self, assets):
+        if self.kind == "image":
+            if self.spec.get("image") not in assets.images:
+                fail(f"{self.id}: unknown image {self.spec.get('image')!r}")
+            self.width, self.height = assets.images[self.spec["image"]]
+        elif self.kind in ("button", "label") and "width" not in self.spec:
+            font = assets.fonts.get(self.spec.get("font"))
+            if not font:
+                fail(f"{self.id}: an auto-sized {self.kind} needs one of the declared fonts")
+            text = self.spec.get("text", "")
+            self.width = font.measure(text)
+            self.height = font.height
+            if self.kind == "button":
+                border = self.spec.get("border_thickness", BUTTON_BORDER_THICKNESS)
+                self.width += 2 * self.padding + 2 * border
+                self.height += 2 * self.padding + 2 * border
+
+    def measure(self):
+        if self.kind != "container":
+            return self.preferred_width, self.preferred_height
+
+        content_width = content_height = counted = 0
+        for child in self.children:
+            if not child.visible:
+                continue
+            width, height = child.measure()
+            width = clamp_size(width, child.min_width, child.max_width)
+            height = clamp_size(height, child.min_height, child.max_height)
+            if self.type == "hbox":
+                content_width += width
+                content_height = max(content_height, height)
+            elif self.type == "vbox":
+                content_height += height
+                content_width = max(content_width, width)
+            else:
+                content_width = max(content_width, width)
+                content_height = max(content_height, height)
+            counted += 1
+
+        if counted > 1 and self.type == "hbox":
+            content_width += (counted - 1) * self.spacing
+        elif counted > 1 and self.type == "vbox":
+            content_height += (counted - 1) * self.spacing
+        if counted > 0:
+            content_width += 2 * self.padding
+            content_height += 2 * self.padding
+
+        return (self.preferred_width if self.preferred_width > 0 else content_width,
+                self.preferred_height if self.preferred_height > 0 else content_height)
+
+    def flex_weight(self, horizontal):
+        if self.flex > 0:
+            return self.flex
+        preferred = self.preferred_width if horizontal else self.preferred_height
+        return 1 if preferred == 0 else 0
+
+    def limits(self, horizontal):
+        return (self.min_width, self.max_width) if horizontal else (self.min_height, self.max_height)
+
+    # Port of update_box_layout
+    def layout(self):
+        if self.type in ("hbox", "vbox"):
+            self.layout_box(self.type == "hbox")
+        for child in self.children:
+            child.layout()
+
+    def layout_box(self, horizontal):
+        visible = [child for child in self.children if child.visible]
+        if not visible:
+            return
+
+        container_main = self.width if horizontal else self.height
+        container_cross = self.height if horizontal else self.width
+        available_main = container_main - 2 * self.padding - (len(visible) - 1) * self.spacing
+        available_cross = container_cross - 2 * self.padding
+
+        sizes = {}
+        for child in visible:
+            if child.flex_weight(horizontal) > 0:
+                sizes[child] = -1
+                continue
+            width, height = child.measure()
+            sizes[child] = clamp_size(width if horizontal else height, *child.limits(horizontal))
+
+        for _ in range(len(visible)):
+            free_space = available_main
+            total_weight = 0
+            for child in visible:
+                if sizes[child] >= 0:
+                    free_space -= sizes[child]
+                else:
+                    total_weight += child.flex_weight(horizontal)
+            if total_weight == 0:
+                break
+            free_space = max(free_space, 0)
+
+            clamped = False
+            for pass_index in range(2):
+                if clamped:
+                    break
+                weight_before = 0
+                for child in visible:
+                    if sizes[child] >= 0:
+                        continue
+                    weight = child.flex_weight(horizontal)
+                    share = (c_div(free_space * (weight_before + weight), total_weight) -
+                             c_div(free_space * weight_before, total_weight))
+                    weight_before += weight
+                    limited = clamp_size(share, *child.limits(horizontal))
+                    if pass_index == 0 and limited != share:
+                        sizes[child] = limited
+                        clamped = True
+                    elif pass_index == 1:
+                        sizes[child] = share
+            if not clamped:
+                break
+
+        total_content = (len(visible) - 1) * self.spacing + sum(max(sizes[child], 0) for child in visible)
+        current = self.padding
+        if self.justify == "center" and total_content < available_main:
+            current = c_div(container_main - total_content, 2)
+        elif self.justify == "end" and total_content < available_main:
+            current = container_main - self.padding - total_content
+
+        for child in visible:
+            main_size = max(sizes[child], 0)
+            width, height = child.measure()
+            cross_min, cross_max = child.limits(not horizontal)
+            cross_measured = height if horizontal else width
+            cross_preferred = child.preferred_height if horizontal else child.preferred_width
+
+            cross_size = available_cross
+            if self.alignment != "stretch" and cross_preferred > 0:
+                cross_size = cross_measured
+            cross_size = clamp_size(cross_size, cross_min, cross_max)
+
+            cross = self.padding
+            if self.alignment == "center":
+                cross += c_div(available_cross - cross_size, 2)
+            elif self.alignment == "end":
+                cross += available_cross - cross_size
+
+            if horizontal:
+                child.x, child.y, child.width, child.height = current, cross, main_size, cross_size
+            else:
+                child.x, child.y, child.width, child.height = cross, current, cross_size, main_size
+            current += main_size + self.spacing
+
+    def walk(self):
+        yield self
+        for child in self.children:
+            yield from child.walk()
+
+
+class Assets:
+    def __init__(self, layout, base):
+        self.fonts = {name: Font(os.path.join(base, path)) for name, path in layout.get("fonts", {}).items()}
+        self.images = {name: bmp_size(os.path.join(base, path)) for name, path in layout.get("images", {}).items()}
+
+
+def emit_widget(node, name, out):
+    kind, _, widget_type, vtable = KINDS[node.kind]
+    animated = node.kind == "container" and node.animation != "none"
+    opaque = node.spec.get("opaque", node.kind == "button")
+    parent = f"&{name}.{node.parent.id}.widget" if node.parent else "NULL"
+
+    out.append(f"    .{node.id} =")
+    out.append("        {")
+    out.append("            .widget =")
+    out.append("                {")
+    out.append(f"                    .type = {widget_type},")
+    out.append(f"                    .visible = {str(node.visible).lower()},")
+    out.append("                    .enabled = true,")
+    out.append("                    .dirty = true,")
+    out.append(f"                    .needs_layout = {str(animated).lower()},")
+    out.append("                    .has_data = true,")
+    out.append(f"                    .opaque = {str(opaque).lower()},")
+    out.append(f"                    .cached = {str(node.spec.get('cached', False)).lower()},")
+    out.append("                    .preallocated = true,")
+    out.append(f"                    .x = {node.x},")
+    out.append(f"                    .y = {node.y},")
+    out.append(f"                    .width = {node.width},")
+    out.append(f"                    .height = {node.height},")
+    out.append(f"                    .layout = {{{node.preferred_width}, {node.preferred_height}, {node.min_width}, "
+               f"{node.min_height}, {node.max_width}, {node.max_height}, {node.flex}}},")
+    out.append(f"                    .vtable = &{vtable},")
+    out.append(f"                    .parent = {parent},")
+    if "on_click" in node.spec:
+        out.append(f"                    .on_click = {node.spec['on_click']},")
+    out.append("                },")
+    out.append("            .data =")
+    out.append("                {")
+
+    spec = node.spec
+    if node.kind == "container":
+        if node.children:
+            out.append(f"                    .children = {name}.{node.id}_children,")
+            out.append(f"                    .sizes = {name}.{node.id}_sizes,")
+        out.append(f"                    .child_count = {len(node.children)},")
+        out.append(f"                    .child_capacity = {len(node.children)},")
+        out.append(f"                    .layout_type = {LAYOUTS[node.type]},")
+        out.append(f"                    .spacing = {node.spacing},")
+        out.append(f"                    .padding = {node.padding},")
+        out.append(f"                    .alignment = {ALIGNMENTS[node.alignment]},")
+        out.append(f"                    .justify = {ALIGNMENTS[node.justify]},")
+        out.append("                    .grid_columns = 2,")
+        out.append(f"                    .animation = {ANIMATIONS[node.animation]},")
+        out.append(f"                    .animation_speed = {spec.get('animation_speed', 1)},")
+    elif node.kind == "button":
+        out.append(f"                    .text = {{.value = {c_string(spec.get('text', ''))}}},")
+        out.append(f"                    .padding = {node.padding},")
+        out.append(f"                    .background_color = {c_color(spec.get('background', 'COLOR_GRAY_75'))},")
+        out.append(f"                    .text_color = {c_color(spec.get('text_color', 'COLOR_BLACK'))},")
+        out.append(f"                    .border_color = {c_color(spec.get('border', 'COLOR_BLACK'))},")
+        out.append(f"                    .border_thickness = {spec.get('border_thickness', BUTTON_BORDER_THICKNESS)},")
+        out.append(f"                    .font = {'&' + spec['font'] if 'font' in spec else 'NULL'},")
+    elif node.kind == "label":
+        out.append(f"                    .text = {{.value = {c_string(spec.get('text', ''))}}},")
+        out.append(f"                    .text_color = {c_color(spec.get('text_color', 'COLOR_WHITE'))},")
+        out.append(f"                    .font = {'&' + spec['font'] if 'font' in spec else 'NULL'},")
+    elif node.kind == "image":
+        out.append(f"                    .image = &{spec['image']},")
+        out.append(f"                    .border_color = {c_color(spec.get('border', 'COLOR_BLACK'))},")
+        out.append(f"                    .border_thickness = {spec.get('border_thickness', 0)},")
+
+    out.append("                },")
+    out.append("        },")
+
+
+def generate(layout, base):
+    name = layout.get("name")
+    if not name:
+        fail("the layout needs a name")
+
+    assets = Assets(layout, base)
+    root_spec = dict(layout["root"])
+    root_spec.setdefault("id", "root")
+    root_spec.setdefault("width", layout.get("width", 0))
+    root_spec.setdefault("height", layout.get("height", 0))
+    root = Node(root_spec, "root", None, assets)
+    root.layout()
+
+    nodes = list(root.walk())
+    ids = [node.id for node in nodes]
+    if len(set(ids)) != len(ids):
+        fail("widget ids must be unique")
+
+    guard = f"{name.upper()}_H"
+    type_name = "".join(part.capitalize() for part in name.split("_"))
+    kinds = sorted({node.kind for node in nodes})
+
+    out = [f"#ifndef {guard}", f"#define {guard}", ""]
+    out.append("// Generated by tools/layout2c.py; edit the layout description instead")
+    out.append("")
+    out += ['#include "widgets/button.h"', '#include "widgets/container.h"', '#include "widgets/image_widget.h"',
+            '#include "widgets/label.h"', "#include <stddef.h>", "#include <string.h>", ""]
+    out.append(f"#define {name.upper()}_WIDTH {root.width}")
+    out.append(f"#define {name.upper()}_HEIGHT {root.height}")
+    out.append("")
+
+    for kind in kinds:
+        suffix, data_type, _, _ = KINDS[kind]
+        node_type = f"{type_name}{suffix}"
+        out += ["typedef struct", "{", "    Widget widget;", f"    {data_type} data;", f"}} {node_type};", ""]
+        out.append(f"_Static_assert(offsetof({node_type}, data) == sizeof(Widget), "
+                   '"widget data must follow the widget");')
+        out.append("")
+
+    out += ["typedef struct", "{"]
+    for node in nodes:
+        out.append(f"    {type_name}{KINDS[node.kind][0]} {node.id};")
+    for node in nodes:
+        if node.kind == "container" and node.children:
+            out.append(f"    Widget *{node.id}_children[{len(node.children)}];")
+            out.append(f"    int {node.id}_sizes[{len(node.children)}];")
+    out += [f"}} {type_name};", ""]
+
+    out.append(f"static {type_name} {name};")
+    out.append("")
+    out.append(f"static const {type_name} {name}_initial = {{")
+    for node in nodes:
+        emit_widget(node, name, out)
+    for node in nodes:
+        if node.kind == "container" and node.children:
+            out.append(f"    .{node.id}_children = {{")
+            out += [f"        &{name}.{child.id}.widget," for child in node.children]
+            out.append("    },")
+    out += ["};", ""]
+
+    out.append("// Copies the tree into RAM in its initial state and returns the root; loading again resets the tree")
+    out.append(f"static Widget *{name}_load(void)")
+    out.append("{")
+    out.append(f"    memcpy(&{name}, &{name}_initial, sizeof({type_name}));")
+    out.append(f"    return &{name}.{root.id}.widget;")
+    out.append("}")
+    out.append("")
+    out.append(f"#endif // {guard}")
+    return "\n".join(out) + "\n"
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Convert a JSON layout description to a static widget tree")
+    parser.add_argument("input", help="Input layout file")
+    args = parser.parse_args()
+
+    with open(args.input, "r") as f:
+        layout = json.load(f)
+
+    sys.stdout.write(generate(layout, os.path.dirname(os.path.abspath(args.input))))